@@ -0,0 +1,406 @@
+/*
+ *   Benchmark of rebalancing work done by each kind of tree.
+ *
+ *   Trees are filled with random keys, then keys are replaced one by one,
+ *   and finally all deleted. For each phase, number of rotations per
+ *   operation and time are printed. Relaxed tree is balanced after it is
+ *   filled, and stays relaxed then.
+ *
+ *   Then, random keys are deleted from a tree whose every node has a left
+ *   son higher than its right son, for AVL and weak AVL balance. There,
+ *   one AVL deletion can rotate each node of its path, and the most
+ *   rotations done by one deletion are printed too.
+ *
+ *   Then, a sliding window of increasing keys is kept in a tree, each key
+ *   being appended and the minimum deleted, for a small and a large
+ *   window.
+ *
+ *   Then, lookups of a tree ordered by data_cmp are compared with lookups of
+ *   a tree ordered by a typed key, for int keys and for URLs sharing long
+ *   prefixes.
+ *
+ *   Then, calls to the comparison function per operation are counted, for
+ *   a tree ordered by data_cmp and for a tree ordered by a less-than
+ *   predicate.
+ *
+ *   Finally, generic trees are compared with trees generated for int keys
+ *   by avl_generate.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl.h"
+#include "avl_generate.h"
+
+#define COUNT 1000000
+
+static int data_cmp(void *a, void *b)
+{
+    int aa = *((int *) a);
+    int bb = *((int *) b);
+
+    return (aa > bb) - (aa < bb);
+}
+
+static void data_print(void *d)
+{
+    printf("%d", *((int *) d));
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(int));
+}
+
+static double elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double) (now.tv_sec - start->tv_sec)
+         + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+#define MODE_WAVL       1
+#define MODE_RELAXED    2
+
+static void run(const char *name, int mode, int *keys)
+{
+    tree *t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    struct timespec start;
+    int i;
+
+    if (mode == MODE_WAVL)
+        set_wavl(t);
+    if (mode == MODE_RELAXED)
+        set_relaxed(t);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < COUNT; i++)
+        insert_elmt(t, &keys[i], sizeof(int));
+    printf("%-5s insert  %8.3f rotations/op %8.3f s\n", name,
+           (double) t->rotations / COUNT, elapsed(&start));
+
+    if (mode == MODE_RELAXED) {
+        t->rotations = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        rebalance_step(t, 0);
+        printf("%-5s balance %8.3f rotations/op %8.3f s\n", name,
+               (double) t->rotations / COUNT, elapsed(&start));
+    }
+
+    t->rotations = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < COUNT; i++) {
+        delete_node(t, &keys[i]);
+        insert_elmt(t, &keys[COUNT + i], sizeof(int));
+    }
+    printf("%-5s replace %8.3f rotations/op %8.3f s\n", name,
+           (double) t->rotations / (2 * COUNT), elapsed(&start));
+
+    t->rotations = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < COUNT; i++)
+        delete_node(t, &keys[COUNT + (i * 7) % COUNT]);
+    printf("%-5s delete  %8.3f rotations/op %8.3f s\n", name,
+           (double) t->rotations / COUNT, elapsed(&start));
+
+    delete_tree(t);
+}
+
+#define LEAN_HEIGHT     28
+
+static int lean_size[LEAN_HEIGHT + 1];
+
+// insert keys of nodes at depth of a tree whose left sons are higher.
+static void lean_level(tree *t, int lo, int height, int depth)
+{
+    int key;
+
+    if (height <= 0)
+        return;
+    key = lo + (height >= 2 ? lean_size[height - 1] : 0);
+    if (depth == 0) {
+        insert_elmt(t, &key, sizeof(int));
+    } else {
+        lean_level(t, lo, height - 1, depth - 1);
+        lean_level(t, key + 1, height - 2, depth - 1);
+    }
+}
+
+static void lean(const char *name, int mode)
+{
+    tree *t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    struct timespec start;
+    unsigned long before;
+    unsigned long most = 0;
+    int size;
+    int key;
+    int i;
+
+    if (mode == MODE_WAVL)
+        set_wavl(t);
+    lean_size[0] = 0;
+    lean_size[1] = 1;
+    for (i = 2; i <= LEAN_HEIGHT; i++)
+        lean_size[i] = lean_size[i - 1] + lean_size[i - 2] + 1;
+    size = lean_size[LEAN_HEIGHT];
+    // level by level, so that no insertion rotates.
+    for (i = 0; i < LEAN_HEIGHT; i++)
+        lean_level(t, 0, LEAN_HEIGHT, i);
+
+    srand(42);
+    t->rotations = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < size / 2; i++) {
+        key = rand() % size;
+        before = t->rotations;
+        delete_node(t, &key);
+        if (t->rotations - before > most)
+            most = t->rotations - before;
+    }
+    printf("%-5s lean    %8.3f rotations/op %8.3f s  at most %lu\n", name,
+           (double) t->rotations / (size / 2), elapsed(&start), most);
+
+    delete_tree(t);
+}
+
+static void window(int size)
+{
+    tree *t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    struct timespec start;
+    int i;
+
+    for (i = 0; i < size; i++)
+        insert_elmt(t, &i, sizeof(int));
+
+    t->rotations = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = size; i < size + 10 * COUNT; i++) {
+        insert_elmt(t, &i, sizeof(int));
+        delete_node_min(t);
+    }
+    printf("window %-7d %8.3f rotations/op %8.3f s\n", size,
+           (double) t->rotations / (10 * COUNT), elapsed(&start));
+
+    delete_tree(t);
+}
+
+static void lookup(const char *name, tree *t, int *keys, int size)
+{
+    struct timespec start;
+    int found = 0;
+    int i;
+
+    for (i = 0; i < size; i++)
+        insert_elmt(t, &keys[i], sizeof(int));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < 2 * COUNT; i++)
+        found += is_present(t, &keys[i % (2 * size)]);
+    printf("%-5s lookup  %8d of %-7d  %8.3f s\n", name, found, size,
+           elapsed(&start));
+
+    delete_tree(t);
+}
+
+#define URL_COUNT 200000
+
+static int url_cmp(void *a, void *b)
+{
+    return strcmp(*((char **) a), *((char **) b));
+}
+
+static void url_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(char *));
+}
+
+static void lookup_url(const char *name, tree *t, char **urls)
+{
+    struct timespec start;
+    int found = 0;
+    int i;
+
+    for (i = 0; i < URL_COUNT; i++)
+        insert_elmt(t, &urls[i], sizeof(char *));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < 2 * COUNT; i++)
+        found += is_present(t, &urls[i % (2 * URL_COUNT)]);
+    printf("%-7s lookup %8d of %-7d  %8.3f s\n", name, found, URL_COUNT,
+           elapsed(&start));
+
+    delete_tree(t);
+}
+
+static unsigned long calls;
+
+static int counted_cmp(void *a, void *b)
+{
+    calls++;
+
+    return data_cmp(a, b);
+}
+
+static int counted_less(void *a, void *b)
+{
+    calls++;
+
+    return *((int *) a) < *((int *) b);
+}
+
+static void comparisons(const char *name, tree *t, int *keys)
+{
+    int i;
+
+    calls = 0;
+    for (i = 0; i < COUNT; i++)
+        insert_elmt(t, &keys[i], sizeof(int));
+    printf("%-5s calls   insert %6.2f", name, (double) calls / COUNT);
+
+    calls = 0;
+    for (i = 0; i < 2 * COUNT; i++)
+        is_present(t, &keys[i]);
+    printf("  lookup %6.2f", (double) calls / (2 * COUNT));
+
+    calls = 0;
+    for (i = 0; i < COUNT; i++)
+        delete_node(t, &keys[i]);
+    printf("  delete %6.2f\n", (double) calls / COUNT);
+
+    delete_tree(t);
+}
+
+struct item {
+    int key;
+    AVL_ENTRY(item) link;
+};
+
+static int item_cmp(struct item *a, struct item *b)
+{
+    return (a->key > b->key) - (a->key < b->key);
+}
+
+AVL_HEAD(item_tree, item);
+AVL_GENERATE(item_tree, item, link, item_cmp)
+
+static void generic(int *keys)
+{
+    tree *t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    struct timespec start;
+    int found = 0;
+    int i;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < COUNT; i++)
+        insert_elmt(t, &keys[i], sizeof(int));
+    printf("avl.c insert  %8.3f s\n", elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < 2 * COUNT; i++)
+        found += is_present(t, &keys[i]);
+    printf("avl.c lookup  %8.3f s (%d)\n", elapsed(&start), found);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < COUNT; i++)
+        delete_node(t, &keys[i]);
+    printf("avl.c delete  %8.3f s\n", elapsed(&start));
+
+    delete_tree(t);
+}
+
+static void generated(int *keys)
+{
+    struct item_tree head = AVL_INITIALIZER;
+    struct item *items = malloc(2 * COUNT * sizeof(struct item));
+    struct timespec start;
+    int found = 0;
+    int i;
+
+    for (i = 0; i < 2 * COUNT; i++)
+        items[i].key = keys[i];
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < COUNT; i++)
+        AVL_INSERT(item_tree, &head, &items[i]);
+    printf("gen   insert  %8.3f s\n", elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < 2 * COUNT; i++)
+        found += AVL_FIND(item_tree, &head, &items[i]) != NULL;
+    printf("gen   lookup  %8.3f s (%d)\n", elapsed(&start), found);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < COUNT; i++)
+        AVL_REMOVE(item_tree, &head, &items[i]);
+    printf("gen   delete  %8.3f s\n", elapsed(&start));
+
+    free(items);
+}
+
+int main(void)
+{
+    key_desc int_key = { KEY_INT32, 0, 0, 0 };
+    key_desc url_key = { KEY_CSTRING, 0, 0, 0 };
+    int *keys = malloc(2 * COUNT * sizeof(int));
+    char **urls = malloc(2 * URL_COUNT * sizeof(char *));
+    tree *t;
+    int i;
+
+    srand(42);
+    for (i = 0; i < 2 * COUNT; i++)
+        keys[i] = rand();
+
+    run("avl", 0, keys);
+    run("wavl", MODE_WAVL, keys);
+    run("relax", MODE_RELAXED, keys);
+
+    lean("avl", 0);
+    lean("wavl", MODE_WAVL);
+
+    window(1000);
+    window(COUNT);
+
+    for (i = COUNT / 100; i <= COUNT; i *= 100) {
+        lookup("cmp", init_dictionnary(data_cmp, data_print, data_delete,
+                                       data_copy), keys, i);
+        lookup("int32", init_key_dictionnary(&int_key, data_print,
+                                             data_delete, data_copy), keys, i);
+    }
+
+    for (i = 0; i < 2 * URL_COUNT; i++) {
+        urls[i] = malloc(80);
+        sprintf(urls[i],
+                "https://www.example.com/static/assets/images/%d/%d.png",
+                keys[i] % 16, keys[i]);
+    }
+    lookup_url("cmp", init_dictionnary(url_cmp, NULL, data_delete, url_copy),
+               urls);
+    lookup_url("cstring", init_key_dictionnary(&url_key, NULL, data_delete,
+                                               url_copy), urls);
+    for (i = 0; i < 2 * URL_COUNT; i++)
+        free(urls[i]);
+    free(urls);
+
+    comparisons("cmp", init_dictionnary(counted_cmp, data_print, data_delete,
+                                        data_copy), keys);
+    t = init_dictionnary(counted_cmp, data_print, data_delete, data_copy);
+    set_less_than(t, counted_less);
+    comparisons("less", t, keys);
+
+    generic(keys);
+    generated(keys);
+
+    free(keys);
+
+    return 0;
+}
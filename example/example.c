@@ -35,7 +35,8 @@ int data_cmp(void *a, void *b)
     if (!aa || !bb)
         return 0;
 
-    return aa->key - bb->key;
+    // Difference of keys could overflow
+    return (aa->key > bb->key) - (aa->key < bb->key);
 }
 
 // Function that dumps data structure
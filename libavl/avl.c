@@ -72,7 +72,7 @@
  *       if (!aa || !bb)
  *           return 0;
  *
- *       return aa->key - bb->key;
+ *       return (aa->key > bb->key) - (aa->key < bb->key);
  *   }
  *
  *   // Function that dumps data structure
@@ -173,6 +173,8 @@
 #   define LOGLEVEL 0
 #endif
 
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -189,18 +191,529 @@
 #define LIBAVL_VERSION_CHECK(maj, min) (   ((maj) == LIBAVL_MAJOR_VERSION)\
                                         && ((min) == LIBAVL_MINOR_VERSION))
 
+/** \def NODE_ALIGN(size)
+ * \brief Round \c size up to the alignment of data stored after a node.
+ */
+#define NODE_ALIGN(size) (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/** \def NODE_SUMMARY(n)
+ * \brief Pointer to the summary stored just after node \c n.
+ */
+#define NODE_SUMMARY(n) ((void *) ((n) + 1))
+
+/** \def NODE_TAG(t, n)
+ * \brief Pointer to the pending tag stored just after summary of node \c n.
+ */
+#define NODE_TAG(t, n) ((void *) ((char *) NODE_SUMMARY(n)\
+                                  + NODE_ALIGN((t)->summary_size)))
+
+/** \struct _share
+ * \brief Reference counters of a node of a persistent tree.
+ */
+struct _share {
+    /** Number of parents and trees which point to node */
+    unsigned refs;
+    /** Number of nodes which share data, NULL if data is not shared */
+    unsigned *payload;
+};
+
+/** \def NODE_SHARE(t, n)
+ * \brief Pointer to the counters of node \c n of a persistent tree.
+ *
+ * Lazy update is not available on persistent tree, so counters take the
+ * place of pending tag.
+ */
+#define NODE_SHARE(t, n) ((struct _share *) NODE_TAG(t, n))
+
+/** \def BATCH_MERGE_RATIO
+ * \brief A batch bigger than \c 1/BATCH_MERGE_RATIO of tree is merged with
+ * tree in a single rebuild, see \c insert_batch.
+ */
+#define BATCH_MERGE_RATIO   4
+
+/** \def LOOKUP_GROUP
+ * \brief Number of lookups run together by \c lookup_batch.
+ */
+#define LOOKUP_GROUP        8
+
+/** \def PREFETCH(addr)
+ * \brief Ask processor to load memory pointed by \c addr in cache.
+ */
+#ifdef __GNUC__
+#   define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#   define PREFETCH(addr)
+#endif
+
+/** \struct _finger
+ * \brief Node of the path kept in tree for hinted insertion.
+ *
+ * \c lower and \c upper are the indexes in path of the nearest ancestors
+ * with data smaller and greater than the whole subtree of \c n, or -1 if
+ * there is none.
+ */
+struct _finger {
+    /** Node of path */
+    node n;
+    /** Index of lower bound of subtree */
+    int lower;
+    /** Index of upper bound of subtree */
+    int upper;
+};
+
+/** \def ARENA_CHUNK
+ * \brief Size of each block of an arena of strings.
+ */
+#define ARENA_CHUNK         65536
+
+/** \def ARENA_GRAIN
+ * \brief Strings of an arena take a multiple of this size.
+ */
+#define ARENA_GRAIN         16
+
+/** \def ARENA_SMALL
+ * \brief Number of size classes of small strings, one for each multiple
+ * of \c ARENA_GRAIN. Bigger strings take a power of two.
+ */
+#define ARENA_SMALL         64
+
+/** \def ARENA_CLASSES
+ * \brief Number of size classes of strings of an arena.
+ */
+#define ARENA_CLASSES       (ARENA_SMALL + 48)
+
+/** \struct _chunk
+ * \brief Block of an arena, whose bytes follow the structure.
+ */
+struct _chunk {
+    /** Next block of arena */
+    struct _chunk *next;
+    /** Number of bytes of block */
+    size_t size;
+    /** Number of bytes already used */
+    size_t used;
+};
+
+/** \struct _free_strings
+ * \brief Strings of one size class which left their tree.
+ */
+struct _free_strings {
+    /** Released strings, the last one is reused first */
+    char **strings;
+    /** Number of released strings */
+    size_t count;
+    /** Number of strings \c strings can hold */
+    size_t size;
+};
+
+/** \struct _arena
+ * \brief Strings of a \c KEY_CSTRING key, all freed with the last tree
+ * which uses them.
+ */
+struct _arena {
+    /** Number of trees which use arena */
+    unsigned refs;
+    /** Blocks of arena, the one being filled first */
+    struct _chunk *chunks;
+    /** Strings which left their tree, by size class */
+    struct _free_strings free[ARENA_CLASSES];
+};
+
+/** \def NODE_LAZY
+ * \brief Flag set when tag of node is pending for its sons.
+ */
+#define NODE_LAZY       0x01u
+
+/** \def NODE_DEAD
+ * \brief Flag set when element of node is deleted, see \c set_tombstones.
+ */
+#define NODE_DEAD       0x02u
+
+/** \def NODE_PENDING
+ * \brief Flag set when node or one of its descendants is not balanced, see
+ * \c set_relaxed.
+ */
+#define NODE_PENDING    0x04u
+
+/** \def KEY_SIGN
+ * \brief Sign bit of a 64 bits key.
+ */
+#define KEY_SIGN        ((uint64_t) 1 << 63)
+
+/** \def IS_NUMERIC_KEY
+ * \brief True if key of tree is normalized as an unsigned integer.
+ */
+#define IS_NUMERIC_KEY(t) ((t)->key.type >= KEY_INT32\
+                           && (t)->key.type <= KEY_DOUBLE\
+                           && !(t)->key.descending)
+
+/** \def IS_SEARCH_KEY
+ * \brief True if data of tree is found by \c search_key.
+ */
+#define IS_SEARCH_KEY(t) (IS_NUMERIC_KEY(t)\
+                          || ((t)->key.type == KEY_CSTRING\
+                              && !(t)->key.descending))
+
+/** \fn uint64_t ordered_int32(const char *key);
+ * \brief Give an unsigned integer in the same order as a signed one.
+ *
+ * \return Normalized key.
+ * \param key Pointer to a 32 bits integer, which may not be aligned.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+uint64_t ordered_int32(const char *key)
+{
+    int32_t value;
+
+    memcpy(&value, key, sizeof(value));
+
+    return (uint64_t) ((int64_t) value) ^ KEY_SIGN;
+}
+
+/** \fn uint64_t ordered_int64(const char *key);
+ * \brief Give an unsigned integer in the same order as a signed one.
+ *
+ * \return Normalized key.
+ * \param key Pointer to a 64 bits integer, which may not be aligned.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+uint64_t ordered_int64(const char *key)
+{
+    uint64_t value;
+
+    memcpy(&value, key, sizeof(value));
+
+    return value ^ KEY_SIGN;
+}
+
+/** \fn uint64_t ordered_uint32(const char *key);
+ * \brief Give an unsigned 64 bits integer from a 32 bits one.
+ *
+ * \return Normalized key.
+ * \param key Pointer to a 32 bits integer, which may not be aligned.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+uint64_t ordered_uint32(const char *key)
+{
+    uint32_t value;
+
+    memcpy(&value, key, sizeof(value));
+
+    return value;
+}
+
+/** \fn uint64_t ordered_uint64(const char *key);
+ * \brief Give an unsigned 64 bits integer.
+ *
+ * \return Normalized key.
+ * \param key Pointer to a 64 bits integer, which may not be aligned.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+uint64_t ordered_uint64(const char *key)
+{
+    uint64_t value;
+
+    memcpy(&value, key, sizeof(value));
+
+    return value;
+}
+
+/** \fn uint64_t ordered_double(const char *key);
+ * \brief Give an unsigned integer in the same order as a double.
+ *
+ * \return Normalized key.
+ * \param key Pointer to a double, which may not be aligned.
+ *
+ * Sign bit is flipped for positive numbers, and all bits are flipped for
+ * negative ones, so integers compare as the doubles they come from.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+uint64_t ordered_double(const char *key)
+{
+    uint64_t bits;
+
+    memcpy(&bits, key, sizeof(bits));
+    if (bits & KEY_SIGN)
+        return ~bits;
+
+    return bits | KEY_SIGN;
+}
+
+/** \fn uint64_t ordered_key(const key_desc *key, void *data);
+ * \brief Give key of data as an unsigned integer in the same order.
+ *
+ * \return Normalized key.
+ * \param key Description of a numeric key.
+ * \param data Pointer to data.
+ *
+ * All bits of a descending key are flipped, to reverse its order.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+uint64_t ordered_key(const key_desc *key, void *data)
+{
+    const char *k = (const char *) data + key->offset;
+    uint64_t value;
+
+    switch (key->type) {
+    case KEY_INT32:
+        value = ordered_int32(k);
+        break;
+    case KEY_INT64:
+        value = ordered_int64(k);
+        break;
+    case KEY_UINT32:
+        value = ordered_uint32(k);
+        break;
+    case KEY_UINT64:
+        value = ordered_uint64(k);
+        break;
+    default:
+        value = ordered_double(k);
+        break;
+    }
+
+    return key->descending ? ~value : value;
+}
+
+/** \fn const char *string_key(const char *key);
+ * \brief Give string of a \c KEY_CSTRING key.
+ *
+ * \return Pointer to string.
+ * \param key Pointer to key, which may not be aligned.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+const char *string_key(const char *key)
+{
+    const char *s;
+
+    memcpy(&s, key, sizeof(s));
+
+    return s;
+}
+
+/** \fn int compare_key(const key_desc *key, void *a, void *b);
+ * \brief Compare keys of two data.
+ *
+ * \return 0 if keys are equal, positive if key of a is after key of b and
+ * negative if it is before.
+ * \param key Description of key.
+ * \param a Pointer to first data.
+ * \param b Pointer to second data.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int compare_key(const key_desc *key, void *a, void *b)
+{
+    const char *ka = (const char *) a + key->offset;
+    const char *kb = (const char *) b + key->offset;
+    uint64_t x;
+    uint64_t y;
+    int cmp;
+
+    switch (key->type) {
+    case KEY_BYTES:
+        cmp = memcmp(ka, kb, key->length);
+        break;
+    case KEY_STRING:
+        cmp = strncmp(ka, kb, key->length);
+        break;
+    case KEY_CSTRING:
+        // a length only compares a prefix, see scan_prefix.
+        if (key->length > 0)
+            cmp = strncmp(string_key(ka), string_key(kb), key->length);
+        else
+            cmp = strcmp(string_key(ka), string_key(kb));
+        break;
+    default:
+        x = ordered_key(key, a);
+        y = ordered_key(key, b);
+        return (x > y) - (x < y);
+    }
+
+    if (key->descending)
+        return (cmp < 0) - (cmp > 0);
+
+    return cmp;
+}
+
+/** \fn int valid_key(const key_desc *key);
+ * \brief Check description of a key.
+ *
+ * \return 1 if key is valid, 0 if not.
+ * \param key Description of key.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int valid_key(const key_desc *key)
+{
+    if (   key->type == KEY_CUSTOM || key->type == KEY_COMPOSITE
+        || key->type > KEY_CSTRING)
+        return 0;
+    if ((key->type == KEY_BYTES || key->type == KEY_STRING) && key->length == 0)
+        return 0;
+    if (key->type == KEY_CSTRING && key->length != 0)
+        return 0;
+
+    return 1;
+}
+
+/** \fn int compare_data(tree *t, void *a, void *b);
+ * \brief Compare two data of tree.
+ *
+ * \return 0 if a = b, positive if a > b and negative if a < b.
+ * \param t Tree which stores data.
+ * \param a Pointer to first data.
+ * \param b Pointer to second data.
+ *
+ * Keys described by \c init_key_dictionnary are compared here, without
+ * calling any function, and other data with \c data_cmp. Composite keys
+ * are compared field by field, up to the first different one.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int compare_data(tree *t, void *a, void *b)
+{
+    unsigned int i;
+    int cmp;
+
+    switch (t->key.type) {
+    case KEY_CUSTOM:
+        if (t->data_less != NULL) {
+            if (t->data_less(a, b))
+                return -1;
+            return t->data_less(b, a) != 0;
+        }
+        return t->data_cmp(a, b);
+    case KEY_COMPOSITE:
+        for (i = 0; i < t->field_count; i++) {
+            cmp = compare_key(&t->fields[i], a, b);
+            if (cmp != 0)
+                return cmp;
+        }
+        return 0;
+    default:
+        return compare_key(&t->key, a, b);
+    }
+}
+
+/** \def SEARCH_KEY(n, key, ordered, offset)
+ * \brief Go down from \c n to the node whose normalized key is \c key.
+ */
+#define SEARCH_KEY(n, key, ordered, offset)                                 \
+    while ((n) != NULL) {                                                   \
+        uint64_t k = ordered((const char *) (n)->data + (offset));          \
+        if (k == (key))                                                     \
+            break;                                                          \
+        (n) = k > (key) ? (n)->left : (n)->right;                           \
+    }
+
+/** \fn node search_string(tree *t, void *data);
+ * \brief Look for the node whose string key is the key of \c data.
+ *
+ * \return Node equal to \c data, NULL if there is none.
+ * \param t Tree whose key is a \c KEY_CSTRING in increasing order.
+ * \param data Data to look for.
+ *
+ * All keys of a subtree are between its nearest smaller and greater
+ * ancestors, so they share with the searched key at least the shortest of
+ * the prefixes shared with both ancestors: comparison with each node
+ * starts after this prefix.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node search_string(tree *t, void *data)
+{
+    node n = t->root;
+    size_t offset = t->key.offset;
+    const unsigned char *key;
+    size_t lower = 0;
+    size_t upper = 0;
+
+    key = (const unsigned char *) string_key((const char *) data + offset);
+    while (n != NULL) {
+        const unsigned char *k;
+        size_t i = lower < upper ? lower : upper;
 
-/** \fn int is_present_recur(node n, void *d, int (*data_cmp) (void *, void *));
+        k = (const unsigned char *) string_key((const char *) n->data + offset);
+        while (k[i] == key[i] && key[i] != '\0')
+            i++;
+        if (k[i] == key[i])
+            break;
+        if (k[i] > key[i]) {
+            upper = i;
+            n = n->left;
+        } else {
+            lower = i;
+            n = n->right;
+        }
+    }
+
+    return n;
+}
+
+/** \fn node search_key(tree *t, void *data);
+ * \brief Look for the node whose numeric or string key is the key of
+ * \c data.
+ *
+ * \return Node equal to \c data, NULL if there is none.
+ * \param t Tree whose key is numeric or a string, see \c IS_SEARCH_KEY.
+ * \param data Data to look for.
+ *
+ * Key of \c data is normalized once, and each type has its own loop, so
+ * each node only costs a load and an integer comparison. Pending tags are
+ * not applied.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node search_key(tree *t, void *data)
+{
+    node n = t->root;
+    uint64_t key;
+    size_t offset = t->key.offset;
+
+    if (t->key.type == KEY_CSTRING)
+        return search_string(t, data);
+
+    key = ordered_key(&t->key, data);
+    switch (t->key.type) {
+    case KEY_INT32:
+        SEARCH_KEY(n, key, ordered_int32, offset);
+        break;
+    case KEY_INT64:
+        SEARCH_KEY(n, key, ordered_int64, offset);
+        break;
+    case KEY_UINT32:
+        SEARCH_KEY(n, key, ordered_uint32, offset);
+        break;
+    case KEY_UINT64:
+        SEARCH_KEY(n, key, ordered_uint64, offset);
+        break;
+    default:
+        SEARCH_KEY(n, key, ordered_double, offset);
+        break;
+    }
+
+    return n;
+}
+
+/** \fn int is_present_recur(tree *t, node n, void *d);
  * \brief Recursive function to check if a given data is present in tree.
  *
  * \return 1 if data is present, 0 if not.
+ * \param t Tree which contains \c n.
  * \param n Node of subtree to analyze.
  * \param d Pointer to data.
- * \param data_cmp Function to compare two nodes.
  *
  * \warning If you use this function you probably make a mistake.
  */
-int is_present_recur(node n, void *d, int (*data_cmp) (void *, void *))
+int is_present_recur(tree *t, node n, void *d)
 {
     int cmp = 0;
 
@@ -209,19 +722,19 @@ int is_present_recur(node n, void *d, int (*data_cmp) (void *, void *))
         return 0;
 
     // Compare data
-    cmp = data_cmp(n->data, d);
+    cmp = compare_data(t, n->data, d);
 
     if (cmp == 0)
-        // Node found, return true
-        return 1;
+        // Node found, return true if its element is not deleted
+        return !(n->flags & NODE_DEAD);
     else if (cmp > 0)
         // Current node is higher than data to look for,
         // need to go to left subtree.
-        return is_present_recur(n->left, d, data_cmp);
+        return is_present_recur(t, n->left, d);
     else
         // Current node is smaller than data to look for,
         // need to go to right subtree.
-        return is_present_recur(n->right, d, data_cmp);
+        return is_present_recur(t, n->right, d);
 }
 
 /** Use for debug only. Print recursive level of inserted element */
@@ -248,893 +761,4976 @@ unsigned int height_tree(node n)
     return n->height;
 }
 
-/** \fn void adjust_tree_height(node n);
- * \brief Update height field of tree.
+/** \fn node alloc_node(tree *t);
+ * \brief Allocate a new node for tree \c t.
  *
- * \param n Calculate new height of tree pointed by \c tree.
+ * \return Pointer to the new node.
+ * \param t Tree where node will be inserted.
  *
- * For the height calculation rules, see \c height_tree function.
+ * Memory used to store summary of the node (see \c set_augmentation) and
+ * its pending tag (see \c set_lazy_update) or its reference counters (see
+ * \c set_persistent) is allocated just after the node structure.
  *
  * \warning If you use this function you probably make a mistake.
  */
-void adjust_tree_height(node n)
+node alloc_node(tree *t)
 {
-    unsigned int h1;
-    unsigned int h2;
+    node n = malloc(sizeof(struct _node)
+                    + NODE_ALIGN(t->summary_size)
+                    + (t->persistent ? sizeof(struct _share) : t->tag_size));
 
-    h1 = height_tree(n->left);
-    h2 = height_tree(n->right);
+    n->height = 0;
+    n->flags = 0;
+    n->left = n->right = NULL;
+    n->data = NULL;
+    if (t->persistent) {
+        NODE_SHARE(t, n)->refs = 1;
+        NODE_SHARE(t, n)->payload = NULL;
+    }
 
-    if (h1 > h2)
-        n->height = h1 + 1;
-    else
-        n->height = h2 + 1;
+    return n;
 }
 
-/** \fn node rotate_tree_right(node n);
- * \brief Proceed right rotation to tree pointed by \c n.
+/** \fn node own_node(tree *t, node n);
+ * \brief Give a node of tree \c t which can be modified.
  *
- * \return New root of right rotated tree.
- * \param n Pointer to root of tree.
+ * \return \c n if it is only used by \c t, or a copy of \c n.
+ * \param t Persistent tree which contains \c n.
+ * \param n Node to modify, may be NULL.
+ *
+ * A shared node is copied, with its data and its sons shared by both
+ * nodes. Copy must replace \c n in its parent, which must already be
+ * owned by \c t.
  *
  * \warning If you use this function you probably make a mistake.
  */
-node rotate_tree_right(node n)
+node own_node(tree *t, node n)
 {
-    node temp = n->left;
-    n->left = temp->right;
-    adjust_tree_height(n);
-    temp->right = n;
-    adjust_tree_height(temp);
-    return temp;
+    struct _share *share;
+    node copy;
+
+    if (!t->persistent || n == NULL)
+        return n;
+    share = NODE_SHARE(t, n);
+    if (share->refs == 1)
+        return n;
+
+    copy = alloc_node(t);
+    memcpy(copy, n, sizeof(struct _node) + NODE_ALIGN(t->summary_size));
+    if (share->payload == NULL) {
+        share->payload = malloc(sizeof(unsigned));
+        *share->payload = 1;
+    }
+    (*share->payload)++;
+    NODE_SHARE(t, copy)->payload = share->payload;
+    if (n->left != NULL)
+        NODE_SHARE(t, n->left)->refs++;
+    if (n->right != NULL)
+        NODE_SHARE(t, n->right)->refs++;
+    share->refs--;
+
+    // kept pointers must follow the copy.
+    if (t->leftmost == n)
+        t->leftmost = copy;
+    if (t->rightmost == n)
+        t->rightmost = copy;
+    t->finger_depth = 0;
+    t->spine_depth = 0;
+
+    return copy;
 }
 
-/** \fn node rotate_tree_left(node n);
- * \brief Proceed left rotation to tree pointed by \c n.
+/** \fn unsigned int arena_class(size_t length, size_t *size);
+ * \brief Find size class of a string.
  *
- * \return New root of left rotated tree.
- * \param n Pointer to root of tree.
+ * \return Size class, below \c ARENA_CLASSES.
+ * \param length Number of bytes of string, with its null byte.
+ * \param size Filled with number of bytes taken by string in arena.
  *
  * \warning If you use this function you probably make a mistake.
  */
-node rotate_tree_left(node n)
+unsigned int arena_class(size_t length, size_t *size)
 {
-    node temp = n->right;
-    n->right = temp->left;
-    adjust_tree_height(n);
-    temp->left = n;
-    adjust_tree_height(temp);
-    return temp;
-}
+    unsigned int c = ARENA_SMALL;
+
+    if (length <= ARENA_GRAIN * ARENA_SMALL) {
+        c = (unsigned int) ((length + ARENA_GRAIN - 1) / ARENA_GRAIN);
+        *size = c * ARENA_GRAIN;
+        return c - 1;
+    }
 
+    for (*size = 2 * ARENA_GRAIN * ARENA_SMALL; *size < length; c++)
+        *size *= 2;
 
-/** \fn node equi_left(node n);
- * \brief Balance left tree.
+    return c;
+}
+
+/** \fn void release_key(tree *t, void *data);
+ * \brief Give back to arena the string key of data deleted by tree.
  *
- * \return New root of left-balanced tree.
- * \param n Pointer to root of tree.
+ * \param t Tree which contained \c data.
+ * \param data Data whose key is released.
  *
- * This function make rotation and update height if necessary.
+ * Only data deleted with \c data_delete releases its key: keys of data
+ * given back to caller are never reused, and stay valid until arena is
+ * freed.
  *
  * \warning If you use this function you probably make a mistake.
  */
-node equi_left(node n)
+void release_key(tree *t, void *data)
 {
+    struct _free_strings *f;
+    const char *key;
+    size_t size;
 
-    node son = n->left;
+    if (t->key.type != KEY_CSTRING || t->arena == NULL)
+        return;
 
-    DLOG("height tree: tree(%d) | left (%d) | right (%d) | son (%d)",
-            height_tree(n),
-            height_tree(n->left),
-            height_tree(n->right),
-            height_tree(son));
-    if (height_tree(son) > height_tree(n->right) + 1) {
-        if (height_tree(son->right) > height_tree(son->left)) {
-            DLOG("Need rotate left");
-            n->left = rotate_tree_left(n->left);
-        }
-        DLOG("Need rotate right");
-        n = rotate_tree_right(n);
-    } else {
-        DLOG("No rotate");
-        adjust_tree_height(n);
+    key = string_key((char *) data + t->key.offset);
+    f = &(t->arena->free[arena_class(strlen(key) + 1, &size)]);
+    if (f->count == f->size) {
+        f->size = f->size > 0 ? 2 * f->size : 16;
+        f->strings = realloc(f->strings, f->size * sizeof(char *));
     }
-    return n;
+    f->strings[f->count++] = (char *) key;
 }
 
-/** \fn node equi_right(node n);
- * \brief Balance right tree.
+/** \fn void drop_data(tree *t, node n);
+ * \brief Delete data of a node which leaves tree.
  *
- * \return New root of right-balanced tree.
- * \param n Pointer to root of tree.
+ * \param t Tree which contains \c n.
+ * \param n Node to release.
  *
- * This function make rotation and update height if necessary.
+ * Data still used by another node of a snapshot is kept.
  *
  * \warning If you use this function you probably make a mistake.
  */
-node equi_right(node n)
+void drop_data(tree *t, node n)
 {
-    node son = n->right;
+    unsigned *payload;
 
-    if (height_tree(son) > height_tree(n->left) + 1) {
-        if (height_tree(son->left) > height_tree(son->right))
-            n->right = rotate_tree_right(n->right);
-        n = rotate_tree_left(n);
-    } else {
-        adjust_tree_height(n);
+    if (t->persistent && (payload = NODE_SHARE(t, n)->payload) != NULL) {
+        if (--(*payload) > 0)
+            return;
+        free(payload);
     }
-    return n;
+    release_key(t, n->data);
+    t->data_delete(n->data);
 }
 
-
-/** \fn int delete_node_min_recur(node *n, void (*data_delete) (void *));
- * \brief Recursive deletion of minimum element.
+/** \fn void *take_data(tree *t, node n);
+ * \brief Give back data of a node which leaves tree.
  *
- * \return True if element is deleted, false if not.
- * \param n Root of tree where minimum element must be deleted.
- * \param data_delete Fonction to delete a node in tree.
+ * \return Data that caller must delete.
+ * \param t Tree which contains \c n.
+ * \param n Node to release.
+ *
+ * Data still used by another node of a snapshot is copied.
  *
  * \warning If you use this function you probably make a mistake.
  */
-int delete_node_min_recur(node *n, void (*data_delete) (void *))
+void *take_data(tree *t, node n)
 {
-    node aux = NULL;
-    int result;
+    unsigned *payload;
+    void *data;
 
-    if (*n == NULL)
-        return 0;
+    if (t->persistent && (payload = NODE_SHARE(t, n)->payload) != NULL) {
+        if (--(*payload) > 0) {
+            data = malloc(t->datasize);
+            t->data_copy(n->data, data);
+            return data;
+        }
+        free(payload);
+    }
 
-    if ((*n)->left == NULL) {
-        // No node in left subtree, this means that the current node
-        // is the minimum node stored in tree.
-        aux = *n;
-        *n = aux->right;
-        data_delete(aux->data);
-        free(aux);
-        return 1;
-    } else {
-        // not the minimum, go deep
-        result = delete_node_min_recur(&((*n)->left), data_delete);
-        // balance resulting tree
-        *n = equi_right(*n);
-    }
-
-    return result;
+    return n->data;
 }
 
-/** \fn node delete_node_recur(node *root, void *data,
- *                             int (*data_cmp) (void *, void *),
- *                             void (*data_delete) (void *));
- * \brief Recursive deletion of the a node.
+/** \fn char *arena_copy(struct _arena *arena, const char *s);
+ * \brief Copy a string in an arena.
+ *
+ * \return Pointer to copy.
+ * \param arena Arena which keeps copy.
+ * \param s String to copy.
+ *
+ * A released string of the same size class is reused first. Blocks are
+ * only freed with arena.
  *
- * \param root Pointer of pointer to subtree.
- * \param data Data to delete. Only field used in \c avl_data_cmp
- * must be filled.
- * \param data_cmp Function use to compare node.
- * \param data_delete Function use to delete node.
- * \return True if node is deleted, false else.
- * 
  * \warning If you use this function you probably make a mistake.
  */
-int delete_node_recur(node *root, void *data,
-                      int (*data_cmp) (void *, void *),
-                      void (*data_delete) (void *))
+char *arena_copy(struct _arena *arena, const char *s)
 {
-    int cmp = 0;
-    int result = 0;
-    node aux = NULL;
+    size_t length = strlen(s) + 1;
+    size_t size;
+    struct _free_strings *f = &(arena->free[arena_class(length, &size)]);
+    struct _chunk *c = arena->chunks;
+    char *copy;
 
-    if (*root == NULL) {
-        WLOG("Node does not exist");
-        return 0;
+    if (f->count > 0) {
+        copy = f->strings[--f->count];
+        memcpy(copy, s, length);
+        return copy;
     }
 
-    cmp = data_cmp(data, (*root)->data);
-    if (cmp == 0) {
-        // Current node is the node to delete.
-        if ((*root)->right == NULL) {
-            // simple deletion because there is no right subtree.
-            // attach the left subtree instead of the deleted node
-            aux = *root;
-            *root = (*root)->left;
-
-            // release memory used in node.
-            data_delete(aux->data);
-            free(aux);
+    if (c == NULL || c->size - c->used < size) {
+        c = malloc(sizeof(struct _chunk)
+                   + (size > ARENA_CHUNK ? size : ARENA_CHUNK));
+        c->size = size > ARENA_CHUNK ? size : ARENA_CHUNK;
+        c->used = 0;
+        if (size > ARENA_CHUNK / 4 && arena->chunks != NULL) {
+            // big string has its own block, behind the one being filled.
+            c->next = arena->chunks->next;
+            arena->chunks->next = c;
         } else {
-            // There is a right subtree.
-            // swap minimun element of right subtree and
-            // the deleted data, efectively delete data
-            // and re balance right subtree.
-            void *d;
-            node temp = (*root)->right;
-
-            // look for the minimum element of right subtree.
-            while (temp->left != NULL)
-                temp = temp->left;
-
-            // swap data
-            d = (*root)->data;
-            (*root)->data = temp->data;
-            temp->data = d;
-
-            // delete minimum node.
-            delete_node_min_recur(&((*root)->right), data_delete);
-            // rebalance subtree.
-            *root = equi_left(*root);
+            c->next = arena->chunks;
+            arena->chunks = c;
         }
-        return 1;
-    } else if (cmp > 0) {
-        // current node is smaller than node to delete
-        // go down into right subtree.
-        result = delete_node_recur(&((*root)->right), data, data_cmp, data_delete);
-        // rebalance subtree.
-        *root = equi_left(*root);
-    } else {
-        // current node is higher than node to delete
-        // go down into left subtree.
-        result = delete_node_recur(&((*root)->left), data, data_cmp, data_delete);
-        // rebalance subtree.
-        *root = equi_right(*root);
     }
 
-    return result;
+    copy = (char *) (c + 1) + c->used;
+    memcpy(copy, s, length);
+    c->used += size;
+
+    return copy;
 }
 
-/** \fn int insert_elmt_recur(node *n, node add_node,
- *                            int (*data_cmp) (void *, void *));
- * \brief Recursive function too add element in tree.
+/** \fn void store_data(tree *t, void *src, void *dst);
+ * \brief Copy data which enters tree.
  *
- * \return Number of element inserted.
- * \param n Root of tree where element must be inserted.
- * \param add_node Element to be added in tree.
- * \param data_cmp Function to compare nodes.
+ * \param t Tree which receives data.
+ * \param src Pointer to data to copy.
+ * \param dst Pointer to memory allocated for the copy.
+ *
+ * String of a \c KEY_CSTRING key is copied in the arena of tree.
  *
  * \warning If you use this function you probably make a mistake.
  */
-int insert_elmt_recur(node *n, node add_node, int (*data_cmp) (void *, void *))
+void store_data(tree *t, void *src, void *dst)
 {
-    int present = 0; // 1 means that data already present
-    int cmp;
-
-    // Here is the end of a tree. It must create new node here
-    DLOG("Insert %p at level %d", add_node, level_insert);
-    if (*n == NULL) {
-        (*n) = add_node;
-        (*n)->height = 1;
-        (*n)->left = NULL;
-        (*n)->right = NULL;
-
-        return 0;
-    }
-
-    cmp = data_cmp((*n)->data, add_node->data);
-
-    // Check if current node is the node you want to add
-    if (cmp == 0)
-        // node already exist
-        return 1;
-
-    if (cmp > 0) {
-        // Current node is higher that node you want to add
-        // Insert it on left subtree.
-        DLOG("Down into left level %d", ++level_insert);
-        present = insert_elmt_recur(&(*n)->left, add_node, data_cmp);
-        DLOG("Out of level %d", level_insert--);
-
-        if (!present) {
-            // node was really inserted, need to re-balance tree
-            *n = equi_left(*n);
-            return 0;
-        } else
-            // node not inserted in subtree
-            return 1;
-    } else {
-        // Current node is smaller that node you want to add
-        // Insert it on right subtree.
-        DLOG("Down into right level %d", ++level_insert);
-        present = insert_elmt_recur(&(*n)->right, add_node, data_cmp);
-        DLOG("Out of level %d", level_insert--);
+    char *key;
 
-        if (!present) {
-            // node was really inserted, need to re-balance tree
-            *n = equi_right(*n);
-            return 0;
-        } else
-            // node not inserted in subtree
-            return 1;
+    t->data_copy(src, dst);
+    if (t->key.type == KEY_CSTRING) {
+        key = arena_copy(t->arena, string_key((char *) dst + t->key.offset));
+        memcpy((char *) dst + t->key.offset, &key, sizeof(key));
     }
-
 }
 
-/** \fn void verif_avl(node n, int tree_min, int tree_max,
- *                      void *data_min, void *data_max,
- *                      int (*data_cmp) (void *, void *));
- * \brief Recursive deffensive function to check if tree is an AVL tree.
+/** \fn void share_arena(tree *t1, tree *t2);
+ * \brief Give the same arena to two trees with a \c KEY_CSTRING key.
  *
- * \param n Pointer to root of tree.
- * \param tree_min Boolean must be true if \c tree is the minimum node.
- * \param tree_max Boolean must be true if \c tree is the maximum node.
- * \param data_min Pointer to the minimum element of sub-tree.
- * \param data_max Pointer to the maximum element of sub-tree.
- * \param data_cmp Fonction to compare nodes.
+ * \param t1 First tree.
+ * \param t2 Second tree, accepted by \c compatible_trees.
+ *
+ * Blocks and released strings of an arena used by only one tree move
+ * into the arena of the other tree, so nodes can then be exchanged
+ * between trees.
  *
  * \warning If you use this function you probably make a mistake.
  */
-void verif_avl(node n,
-        int tree_min,
-        int tree_max,
-        void *data_min,
-        void *data_max,
-        int (*data_cmp) (void *, void *))
+void share_arena(tree *t1, tree *t2)
 {
-    unsigned hg;
-    unsigned hd;
-
-    // Check order of data.
-    if (tree_min && data_cmp(n->data, data_min) < 0) {
-        DLOG("Tree->data < data_min");
-        exit(-1);
-    }
-    if (tree_max && data_cmp(n->data, data_max) > 0) {
-        DLOG("Tree->data > data_min");
-        exit(-2);
-    }
-
-    // Check avl left subtree.
-    if (n->left != NULL) {
-        verif_avl(n->left,
-                tree_min,
-                1,
-                data_min,
-                n->data,
-                data_cmp);
-        hg = n->left->height;
-    } else {
-        hg = 0;
-    }
+    struct _arena *from;
+    struct _arena *to;
+    struct _chunk **last;
+    struct _free_strings *f;
+    unsigned int i;
 
-    // Check avl right subtree.
-    if (n->right != NULL) {
-        verif_avl(n->right,
-                1,
-                tree_max,
-                n->data,
-                data_max,
-                data_cmp);
-        hd = n->right->height;
+    if (t1->key.type != KEY_CSTRING || t1->arena == t2->arena)
+        return;
+    if (t2->arena->refs == 1) {
+        from = t2->arena;
+        to = t2->arena = t1->arena;
     } else {
-        hd = 0;
+        from = t1->arena;
+        to = t1->arena = t2->arena;
     }
 
-
-    // Check height consistency of each subtree
-    if (hg <= hd) {
-        if (!(hd + 1 == n->height && hg + 2 >= n->height)) {
-            DLOG("(hg<hd) Error in tree height: hd %u | hg %u | tree->height %u",
-                    hd, hg, n->height);
-            exit(-3);
-        }
-    } else {
-        if (!(hg + 1 == n->height && hd + 2 >= n->height)) {
-            DLOG("(hg>hd) Error in tree height: hd %u | hg %u | tree->height %u",
-                    hd, hg, n->height);
-            exit(-4);
+    for (last = &(to->chunks); *last != NULL; last = &((*last)->next))
+        ;
+    *last = from->chunks;
+    for (i = 0; i < ARENA_CLASSES; i++) {
+        f = &(to->free[i]);
+        if (f->count + from->free[i].count > f->size) {
+            f->size = f->count + from->free[i].count;
+            f->strings = realloc(f->strings, f->size * sizeof(char *));
         }
+        if (from->free[i].count > 0)
+            memcpy(f->strings + f->count, from->free[i].strings,
+                   from->free[i].count * sizeof(char *));
+        f->count += from->free[i].count;
+        free(from->free[i].strings);
     }
+    to->refs++;
+    free(from);
 }
 
-/** \fn void delete_tree_recur(node n, void (*data_delete) (void *));
- * \brief Recursively delete all node in tree.
+/** \fn void release_arena(struct _arena *arena);
+ * \brief Free an arena when its last tree does not use it anymore.
  *
- * \param n Root node of tree to delete.
- * \param data_delete Function use to delete a node.
+ * \param arena Arena of a deleted tree, may be NULL.
  *
  * \warning If you use this function you probably make a mistake.
  */
-void delete_tree_recur(node n, void (*data_delete) (void *))
+void release_arena(struct _arena *arena)
 {
-    if (n == NULL)
-        return;
+    struct _chunk *c;
+    unsigned int i;
 
-    if (n->left != NULL)
-        delete_tree_recur(n->left, data_delete);
-    if (n->right != NULL)
-        delete_tree_recur(n->right, data_delete);
+    if (arena == NULL || --arena->refs > 0)
+        return;
 
-    data_delete(n->data);
-    free(n);
+    for (i = 0; i < ARENA_CLASSES; i++)
+        free(arena->free[i].strings);
+    while ((c = arena->chunks) != NULL) {
+        arena->chunks = c->next;
+        free(c);
+    }
+    free(arena);
 }
 
-/** \fn void print_tree_recur(node t, void (*data_print) (void *));
- * \brief Recursive function to print tree. Use for debug.
+/** \fn void update_summary(tree *t, node n);
+ * \brief Compute again summary of a node of an augmented tree.
  *
- * \param t Pointer to root of tree.
- * \param data_print Function to display a node.
+ * \param t Tree which contains \c n.
+ * \param n Node whose sons are up to date.
  *
  * \warning If you use this function you probably make a mistake.
  */
-void print_tree_recur(node t, void (*data_print) (void *))
+void update_summary(tree *t, node n)
 {
-    if (t == NULL)
-        return;
-
-    // recursively print left subtree.
-    print_tree_recur(t->left, data_print);
-    {
-        // print current node with debug information.
-        unsigned i = 0;
-        for (i = 0; i < t->height; i++)
-            printf("            ");
-        printf("[%d|%p]", t->height, t);
-        data_print(t->data);
-        printf("\n");
-    }
-    // recursively print right subtree.
-    print_tree_recur(t->right, data_print);
+    if (t->summary_combine != NULL)
+        t->summary_combine(NODE_SUMMARY(n),
+                           n->left ? NODE_SUMMARY(n->left) : NULL,
+                           n->data,
+                           n->right ? NODE_SUMMARY(n->right) : NULL);
 }
 
-/** \fn void explore_tree_recur(node t, void (*treatement)(void *, void *),
- *                              void *param);
- * \brief Recursive exploration of tree.
+/** \fn void adjust_tree_height(tree *t, node n);
+ * \brief Update height field of tree.
  *
- * \param t Pointer to subtree.
- * \param treatement Function apply to each node of tree.
- * \param param Pointer to data to pass to \c treatement function.
+ * \param t Tree which contains \c n.
+ * \param n Calculate new height of tree pointed by \c tree.
+ *
+ * For the height calculation rules, see \c height_tree function.
+ * If tree is augmented, summary of node is computed again too. In a
+ * relaxed tree, node is marked when it is not balanced, or when one of
+ * its sons is marked.
  *
  * \warning If you use this function you probably make a mistake.
  */
-void explore_tree_recur(node t, void (*treatement)(void *, void *), void *param)
+void adjust_tree_height(tree *t, node n)
 {
-    if (t == NULL)
-        return;
+    unsigned int h1;
+    unsigned int h2;
 
-    // recursively treat left subtree.
-    explore_tree_recur(t->left, treatement, param);
-    // treat current node.
-    treatement(t->data, param);
-    // recursively treat right subtree.
-    explore_tree_recur(t->right, treatement, param);
+    h1 = height_tree(n->left);
+    h2 = height_tree(n->right);
+
+    if (h1 > h2)
+        n->height = h1 + 1;
+    else
+        n->height = h2 + 1;
+
+    if (   t->relaxed
+        && (   h1 > h2 + 1 || h2 > h1 + 1
+            || (n->left != NULL && (n->left->flags & NODE_PENDING))
+            || (n->right != NULL && (n->right->flags & NODE_PENDING))))
+        n->flags |= NODE_PENDING;
+
+    update_summary(t, n);
 }
 
-/** \fn int explore_restrain_tree_recur(node t, int (*check)(void *, void *),
- *                                      void *param, void *data_min,
- *                                      void *data_max,
- *                                      int (*data_cmp) (void *, void *));
- * \brief Recursive and restrain exploration of tree.
+/** \fn void apply_tag(tree *t, node n, void *tag);
+ * \brief Apply a tag on the whole subtree \c n.
  *
- * \return Accumulation of return value of \c check function.
- * \param t Pointer to root of tree.
- * \param check Function apply to each node of tree between \c data_min and
- * \c data_max.
- * \param param Pointer to data to pass to \c check function
- * \param data_min All treated node are greater than \c data_min
- * \param data_max All treated node are smaller than \c data_max
- * \param data_cmp Function to compare nodes.
+ * \param t Tree which contains \c n.
+ * \param n Root of subtree to update.
+ * \param tag Tag to apply.
+ *
+ * Data and summary of \c n are updated at once, but sons of \c n only
+ * receive the tag when they are visited (see \c push_tag).
  *
  * \warning If you use this function you probably make a mistake.
  */
-int explore_restrain_tree_recur(node t, int (*check)(void *, void *),
-        void *param,
-        void *data_min, void *data_max,
-        int (*data_cmp) (void *, void *))
+void apply_tag(tree *t, node n, void *tag)
 {
-    if (t == NULL)
-        return 0;
+    t->tag_apply(n->data, t->summary_combine ? NODE_SUMMARY(n) : NULL, tag);
 
-    if (data_cmp(t->data, data_max) > 0)
-        // current data is not in the asked range.
-        return explore_restrain_tree_recur(t->left, check, param,
-                                            data_min, data_max,
-                                            data_cmp);
-    else if (data_cmp(t->data, data_min) < 0)
-        // current data is not in the asked range.
-        return explore_restrain_tree_recur(t->right, check, param,
-                                            data_min, data_max,
-                                            data_cmp);
-    else {
-        // current data is in the range.
-        int accu = 0;
-        // treat recursively left subtree.
-        accu += explore_restrain_tree_recur(t->left, check, param,
-                                            data_min, data_max,
-                                            data_cmp);
-        // treat current node.
-        accu += check(t->data, param);
-        // treat recursively right subtree.
-        accu += explore_restrain_tree_recur(t->right, check, param,
-                                            data_min, data_max,
-                                            data_cmp);
-        return accu;
+    // Nobody below to update later.
+    if (n->left == NULL && n->right == NULL)
+        return;
+
+    if (n->flags & NODE_LAZY) {
+        t->tag_compose(NODE_TAG(t, n), tag);
+    } else {
+        memcpy(NODE_TAG(t, n), tag, t->tag_size);
+        n->flags |= NODE_LAZY;
     }
 }
 
-
-/** \fn int get_data_recur(node n, void *data, size_t data_size,
- *                         int (*data_cmp) (void *, void *))
- * \brief Recursively get of a single data.
+/** \fn void push_tag(tree *t, node n);
+ * \brief Give pending tag of node \c n to its sons.
  *
- * \param n Root of tree to analyze.
- * \param data Pointer to the asked data. At the begining of the function,
- * only field used in \c avl_data_cmp must be filled, at the end (and if
- * data exist in tree), all filled will be filled.
- * \param data_size Size of the data structure (need to copy data).
- * \param data_cmp Function to compare nodes.
- * \return 1 if data was found, 0 if not.
+ * \param t Tree which contains \c n.
+ * \param n Node to clean.
  *
- * \warning If you use this function, you probably make a mistake.
+ * This function must be called on each node before going down into its
+ * subtrees to modify them, or before reading data of its sons.
+ *
+ * \warning If you use this function you probably make a mistake.
  */
-int get_data_recur(node n, void *data, size_t data_size, int (*data_cmp) (void *, void *))
+void push_tag(tree *t, node n)
 {
-    int cmp = 0;
-
-    if (n == NULL)
-        return 0;
-
-    cmp = data_cmp(n->data, data);
-    if (cmp == 0) {
-        // Current node is the good node, copy it.
-        memcpy(data, n->data, data_size);
-        return 1;
-    } else if (cmp > 0) {
-        // Need to go deep in the left subtree.
-        return get_data_recur(n->left, data, data_size, data_cmp);
-    } else {
-        // Need to go deep in the right subtree.
-        return get_data_recur(n->right, data, data_size, data_cmp);
-    }
+    if (!(n->flags & NODE_LAZY))
+        return;
 
+    if (n->left != NULL)
+        apply_tag(t, n->left, NODE_TAG(t, n));
+    if (n->right != NULL)
+        apply_tag(t, n->right, NODE_TAG(t, n));
+    n->flags &= ~NODE_LAZY;
 }
 
-/** \fn int stub__data_cmp(void *a, void *b)
- * \brief Stub function used if no data_cmp functio is provided.
+/** \fn node rotate_tree_right(tree *t, node n);
+ * \brief Proceed right rotation to tree pointed by \c n.
  *
- * \param a First node to compare.
- * \param b Second node to compare.
- * \return Difference of pointer nodes.
+ * \return New root of right rotated tree.
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree, owned by \c t.
  *
- * \warning This function is just a stub and shall never be used
- * in your production project.
+ * \warning If you use this function you probably make a mistake.
  */
-int stub__data_cmp(void *a, void *b)
+node rotate_tree_right(tree *t, node n)
 {
-    return (int) ((ptrdiff_t) a - (ptrdiff_t) b);
+    node temp = own_node(t, n->left);
+    t->rotations++;
+    push_tag(t, n);
+    push_tag(t, temp);
+    n->left = temp->right;
+    adjust_tree_height(t, n);
+    temp->right = n;
+    adjust_tree_height(t, temp);
+    return temp;
 }
 
-/** \fn void stub__data_print(void *d)
- * \brief Stub function used if no data_print function is provided.
+/** \fn node rotate_tree_left(tree *t, node n);
+ * \brief Proceed left rotation to tree pointed by \c n.
  *
- * \param d Data to print.
+ * \return New root of left rotated tree.
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree, owned by \c t.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node rotate_tree_left(tree *t, node n)
+{
+    node temp = own_node(t, n->right);
+    t->rotations++;
+    push_tag(t, n);
+    push_tag(t, temp);
+    n->right = temp->left;
+    adjust_tree_height(t, n);
+    temp->left = n;
+    adjust_tree_height(t, temp);
+    return temp;
+}
+
+
+/** \fn node equi_left(tree *t, node n);
+ * \brief Balance left tree.
+ *
+ * \return New root of left-balanced tree.
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree.
+ *
+ * This function make rotation and update height if necessary.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node equi_left(tree *t, node n)
+{
+
+    node son = n->left;
+
+    DLOG("height tree: tree(%d) | left (%d) | right (%d) | son (%d)",
+            height_tree(n),
+            height_tree(n->left),
+            height_tree(n->right),
+            height_tree(son));
+    if (height_tree(son) > height_tree(n->right) + 1) {
+        if (height_tree(son->right) > height_tree(son->left)) {
+            DLOG("Need rotate left");
+            n->left = rotate_tree_left(t, own_node(t, n->left));
+        }
+        DLOG("Need rotate right");
+        n = rotate_tree_right(t, n);
+    } else {
+        DLOG("No rotate");
+        adjust_tree_height(t, n);
+    }
+    return n;
+}
+
+/** \fn node equi_right(tree *t, node n);
+ * \brief Balance right tree.
+ *
+ * \return New root of right-balanced tree.
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree.
+ *
+ * This function make rotation and update height if necessary.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node equi_right(tree *t, node n)
+{
+    node son = n->right;
+
+    if (height_tree(son) > height_tree(n->left) + 1) {
+        if (height_tree(son->left) > height_tree(son->right))
+            n->right = rotate_tree_right(t, own_node(t, n->right));
+        n = rotate_tree_left(t, n);
+    } else {
+        adjust_tree_height(t, n);
+    }
+    return n;
+}
+
+
+/** \fn node grown(tree *t, node n, int left);
+ * \brief Balance tree after a son grew.
+ *
+ * \return New root of balanced tree.
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree, owned by \c t.
+ * \param left Must be true if left son grew, false if right son did.
+ *
+ * A rank balanced node keeps its rank as long as it stays higher than its
+ * sons. Otherwise, node is promoted or rotated exactly as in an AVL tree.
+ * A relaxed tree is never rotated.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node grown(tree *t, node n, int left)
+{
+    if (t->relaxed) {
+        adjust_tree_height(t, n);
+        return n;
+    }
+    if (t->wavl && height_tree(left ? n->left : n->right) < n->height) {
+        update_summary(t, n);
+        return n;
+    }
+
+    return left ? equi_left(t, n) : equi_right(t, n);
+}
+
+/** \fn node shrunk(tree *t, node n, int left);
+ * \brief Balance tree after a son shrank.
+ *
+ * \return New root of balanced tree.
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree, owned by \c t.
+ * \param left Must be true if left son shrank, false if right son did.
+ *
+ * In a rank balanced tree, a node whose rank is 3 more than the rank of a
+ * son is demoted, possibly with its other son, which can make its parent
+ * unbalanced too. Otherwise, at most two rotations restore ranks, and
+ * rebalancing stops there. A relaxed tree is never rotated.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node shrunk(tree *t, node n, int left)
+{
+    unsigned int rank = n->height;
+    node sibling;
+    node root;
+
+    if (t->relaxed) {
+        adjust_tree_height(t, n);
+        return n;
+    }
+    if (!t->wavl)
+        return left ? equi_right(t, n) : equi_left(t, n);
+
+    sibling = left ? n->right : n->left;
+    if (n->left == NULL && n->right == NULL) {
+        // a leaf has always the lowest rank.
+        n->height = 1;
+    } else if (height_tree(left ? n->left : n->right) + 2 < rank) {
+        if (sibling->height + 2 == rank) {
+            n->height--;
+        } else if (   height_tree(sibling->left) + 2 == sibling->height
+                   && height_tree(sibling->right) + 2 == sibling->height) {
+            // sibling is not changed, but its rank.
+            sibling = own_node(t, sibling);
+            if (left)
+                n->right = sibling;
+            else
+                n->left = sibling;
+            sibling->height--;
+            n->height--;
+        } else if (  height_tree(left ? sibling->right : sibling->left) + 1
+                   == sibling->height) {
+            // outer son of sibling is high enough for a single rotation.
+            root = left ? rotate_tree_left(t, n) : rotate_tree_right(t, n);
+            root->height = rank;
+            if (n->left == NULL && n->right == NULL)
+                n->height = 1;
+            else
+                n->height = rank - 1;
+            return root;
+        } else {
+            if (left)
+                n->right = rotate_tree_right(t, own_node(t, n->right));
+            else
+                n->left = rotate_tree_left(t, own_node(t, n->left));
+            root = left ? rotate_tree_left(t, n) : rotate_tree_right(t, n);
+            root->height = rank;
+            root->left->height = rank - 2;
+            root->right->height = rank - 2;
+            return root;
+        }
+    }
+    update_summary(t, n);
+
+    return n;
+}
+
+/** \fn node extract_node_min_recur(tree *t, node *n);
+ * \brief Recursive unlink of minimum node.
+ *
+ * \return Unlinked node.
+ * \param t Tree which contains \c n.
+ * \param n Root of a non empty tree where minimum node must be unlinked.
+ *
+ * The unlinked node is not released and keeps its data. When it is the
+ * minimum node of tree, the next one takes its place in \c leftmost: the
+ * minimum of its right son if any, its father otherwise.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node extract_node_min_recur(tree *t, node *n)
+{
+    node aux = NULL;
+
+    *n = own_node(t, *n);
+    push_tag(t, *n);
+    if ((*n)->left == NULL) {
+        // No node in left subtree, this means that the current node
+        // is the minimum node stored in tree.
+        aux = *n;
+        *n = aux->right;
+        aux->right = NULL;
+        if (t->leftmost == aux) {
+            t->leftmost = *n;
+            while (t->leftmost != NULL && t->leftmost->left != NULL)
+                t->leftmost = t->leftmost->left;
+        }
+    } else {
+        // not the minimum, go deep
+        aux = extract_node_min_recur(t, &((*n)->left));
+        if (t->leftmost == NULL)
+            t->leftmost = *n;
+        // balance resulting tree
+        *n = shrunk(t, *n, 1);
+    }
+
+    return aux;
+}
+
+/** \fn node extract_node_max_recur(tree *t, node *n);
+ * \brief Unlink maximum node of a tree.
+ *
+ * \return Unlinked maximum node.
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree, updated with the new root.
+ *
+ * When unlinked node is the maximum node of tree, the previous one takes
+ * its place in \c rightmost.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node extract_node_max_recur(tree *t, node *n)
+{
+    node aux = NULL;
+
+    *n = own_node(t, *n);
+    push_tag(t, *n);
+    if ((*n)->right == NULL) {
+        // No node in right subtree, this means that the current node
+        // is the maximum node stored in tree.
+        aux = *n;
+        *n = aux->left;
+        aux->left = NULL;
+        if (t->rightmost == aux) {
+            t->rightmost = *n;
+            while (t->rightmost != NULL && t->rightmost->right != NULL)
+                t->rightmost = t->rightmost->right;
+        }
+    } else {
+        // not the maximum, go deep
+        aux = extract_node_max_recur(t, &((*n)->right));
+        if (t->rightmost == NULL)
+            t->rightmost = *n;
+        // balance resulting tree
+        *n = shrunk(t, *n, 0);
+    }
+
+    return aux;
+}
+
+/** \fn void update_extremes(tree *t);
+ * \brief Find again minimum and maximum nodes of tree.
+ *
+ * \param t Pointer to tree.
+ *
+ * Both borders of tree are followed, in \f$\mathcal{O}(\log n)\f$. This
+ * function must be called after any change of tree which can move its
+ * extremes, except single insertion or deletion, which update them on
+ * their way. Path kept for hinted insertion is also forgotten.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void update_extremes(tree *t)
+{
+    t->finger_depth = 0;
+    t->spine_depth = 0;
+    t->leftmost = t->rightmost = t->root;
+    if (t->root == NULL)
+        return;
+
+    while (t->leftmost->left != NULL)
+        t->leftmost = t->leftmost->left;
+    while (t->rightmost->right != NULL)
+        t->rightmost = t->rightmost->right;
+}
+
+/** \fn void reserve_spine(tree *t);
+ * \brief Make room in spine and follow left border of tree if needed.
+ *
+ * \param t Pointer to tree.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void reserve_spine(tree *t)
+{
+    unsigned int size = height_tree(t->root) + 1;
+    node n;
+
+    if (t->spine_size < size) {
+        t->spine = realloc(t->spine, size * sizeof(node));
+        t->spine_size = size;
+    }
+
+    if (t->spine_depth == 0)
+        for (n = t->root; n != NULL; n = n->left)
+            t->spine[t->spine_depth++] = n;
+}
+
+/** \fn node extract_spine_min(tree *t);
+ * \brief Unlink minimum node at the end of spine.
+ *
+ * \return Unlinked node.
+ * \param t Pointer to a non empty tree, which is neither persistent,
+ * relaxed, augmented nor lazily updated.
+ *
+ * Spine is followed backward and each node is rebalanced, until the
+ * height of a subtree does not change. Only the part of spine below the
+ * last rotation is followed again. Finger is cut above the nodes which
+ * are rotated or unlinked, so that appends after deletions of minimum do
+ * not go down from root again.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node extract_spine_min(tree *t)
+{
+    node *s;
+    node min;
+    node n;
+    unsigned int depth;
+    unsigned int height;
+    int i;
+
+    reserve_spine(t);
+    s = t->spine;
+    depth = t->spine_depth - 1;
+    min = s[depth];
+
+    // right son of minimum takes its place.
+    if (depth == 0)
+        t->root = min->right;
+    else
+        s[depth - 1]->left = min->right;
+    min->right = NULL;
+    if (t->finger_depth > depth && t->finger[depth].n == min)
+        t->finger_depth = depth;
+
+    // rebalance spine backward.
+    for (i = (int) depth - 1; i >= 0; i--) {
+        n = s[i];
+        height = n->height;
+        s[i] = shrunk(t, n, 1);
+
+        if (s[i] != n) {
+            depth = (unsigned int) i + 1;
+            if (t->finger_depth > (unsigned int) i && t->finger[i].n == n)
+                t->finger_depth = (unsigned int) i;
+            if (i == 0)
+                t->root = s[0];
+            else
+                s[i - 1]->left = s[i];
+        }
+
+        if (s[i]->height == height)
+            break;
+    }
+
+    // follow left border again below last rotated node.
+    for (n = depth > 0 ? s[depth - 1]->left : t->root; n != NULL; n = n->left)
+        s[depth++] = n;
+    t->spine_depth = depth;
+    t->leftmost = depth > 0 ? s[depth - 1] : NULL;
+    if (t->root == NULL)
+        t->rightmost = NULL;
+
+    return min;
+}
+
+/** \fn node unlink_min(tree *t);
+ * \brief Unlink minimum node of a non empty tree.
+ *
+ * \return Unlinked node.
+ * \param t Pointer to tree.
+ *
+ * Spine is used when tree allows it. Otherwise, tree is followed down from
+ * root, and finger is forgotten.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node unlink_min(tree *t)
+{
+    node n;
+
+    if (   !t->persistent && !t->relaxed
+        && t->summary_combine == NULL && t->tag_apply == NULL)
+        return extract_spine_min(t);
+
+    t->finger_depth = 0;
+    t->spine_depth = 0;
+    n = extract_node_min_recur(t, &(t->root));
+    if (t->root == NULL)
+        t->rightmost = NULL;
+
+    return n;
+}
+
+/** \fn node delete_node_recur(tree *t, node *root, void *data);
+ * \brief Recursive deletion of the a node.
+ *
+ * \param t Tree which contains \c root.
+ * \param root Pointer of pointer to subtree.
+ * \param data Data to delete. Only field used in \c avl_data_cmp
+ * must be filled.
+ * \return True if node is deleted, false else.
+ * 
+ * A deleted extreme node is replaced in \c leftmost or \c rightmost by
+ * the next or previous node, which is found below it or is its father.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int delete_node_recur(tree *t, node *root, void *data)
+{
+    int cmp = 0;
+    int result = 0;
+    node aux = NULL;
+
+    if (*root == NULL) {
+        WLOG("Node does not exist");
+        return 0;
+    }
+
+    *root = own_node(t, *root);
+    push_tag(t, *root);
+    cmp = compare_data(t, data, (*root)->data);
+    if (cmp == 0) {
+        // Current node is the node to delete.
+        aux = *root;
+        if (aux->right == NULL) {
+            // simple deletion because there is no right subtree.
+            // attach the left subtree instead of the deleted node
+            *root = aux->left;
+            // a minimum node has no son here, its father is next.
+            if (t->leftmost == aux)
+                t->leftmost = NULL;
+            if (t->rightmost == aux) {
+                t->rightmost = *root;
+                while (t->rightmost != NULL && t->rightmost->right != NULL)
+                    t->rightmost = t->rightmost->right;
+            }
+        } else {
+            // There is a right subtree.
+            // unlink minimum node of right subtree, and put it
+            // in place of the deleted node.
+            node temp = extract_node_min_recur(t, &(aux->right));
+
+            temp->left = aux->left;
+            temp->right = aux->right;
+            temp->height = aux->height;
+            if (t->leftmost == aux)
+                t->leftmost = temp;
+            // rebalance subtree.
+            *root = shrunk(t, temp, 0);
+        }
+
+        // release memory used in node.
+        drop_data(t, aux);
+        free(aux);
+        return 1;
+    } else if (cmp > 0) {
+        // current node is smaller than node to delete
+        // go down into right subtree.
+        result = delete_node_recur(t, &((*root)->right), data);
+        if (t->rightmost == NULL)
+            t->rightmost = *root;
+        // rebalance subtree.
+        *root = shrunk(t, *root, 0);
+    } else {
+        // current node is higher than node to delete
+        // go down into left subtree.
+        result = delete_node_recur(t, &((*root)->left), data);
+        if (t->leftmost == NULL)
+            t->leftmost = *root;
+        // rebalance subtree.
+        *root = shrunk(t, *root, 1);
+    }
+
+    return result;
+}
+
+/** \fn int delete_less_recur(tree *t, node *root, void *data,
+ *                            node candidate, node *found, node *next);
+ * \brief Recursive deletion of a node, with one call to \c data_less per
+ * level.
+ *
+ * \return True if node is deleted, false else.
+ * \param t Tree ordered by a less-than predicate.
+ * \param root Pointer of pointer to subtree.
+ * \param data Data to delete.
+ * \param candidate Greatest node of path above \c root which is not after
+ * \c data, may be NULL.
+ * \param found Filled with the node equal to \c data.
+ * \param next Filled with the next node of \c found, unlinked to take its
+ * place.
+ *
+ * As in \c search_less, path goes down to a leaf, and its last node not
+ * after \c data is equal to \c data, if any. Below this node, path only
+ * goes left, to its next node, which is unlinked at the end of path and
+ * put in place of deleted node when recursion gets back to it.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int delete_less_recur(tree *t, node *root, void *data, node candidate,
+                      node *found, node *next)
+{
+    int result = 0;
+    node n;
+
+    if (*root == NULL) {
+        WLOG("Node does not exist");
+        return 0;
+    }
+
+    n = *root = own_node(t, *root);
+    push_tag(t, n);
+    if (t->data_less(data, n->data)) {
+        if (n->left == NULL) {
+            // end of path, n is next node of candidate.
+            if (candidate == NULL || t->data_less(candidate->data, data)) {
+                WLOG("Node does not exist");
+                return 0;
+            }
+            *found = candidate;
+            *next = n;
+            *root = n->right;
+            return 1;
+        }
+        // go down into left subtree.
+        result = delete_less_recur(t, &(n->left), data, candidate, found,
+                                   next);
+        if (t->leftmost == NULL)
+            t->leftmost = n;
+        // rebalance subtree.
+        *root = shrunk(t, n, 1);
+        return result;
+    }
+
+    if (n->right == NULL) {
+        // end of path, n is the last node not after data.
+        if (t->data_less(n->data, data)) {
+            WLOG("Node does not exist");
+            return 0;
+        }
+        // attach the left subtree instead of the deleted node.
+        *root = n->left;
+        if (t->leftmost == n)
+            t->leftmost = NULL;
+        if (t->rightmost == n) {
+            t->rightmost = *root;
+            while (t->rightmost != NULL && t->rightmost->right != NULL)
+                t->rightmost = t->rightmost->right;
+        }
+        drop_data(t, n);
+        free(n);
+        return 1;
+    }
+
+    // go down into right subtree, n is the new candidate.
+    result = delete_less_recur(t, &(n->right), data, n, found, next);
+    if (result && *found == n) {
+        // next node takes place of deleted node.
+        (*next)->left = n->left;
+        (*next)->right = n->right;
+        (*next)->height = n->height;
+        if (t->leftmost == n)
+            t->leftmost = *next;
+        *root = shrunk(t, *next, 0);
+        drop_data(t, n);
+        free(n);
+        return 1;
+    }
+    if (t->rightmost == NULL)
+        t->rightmost = n;
+    // rebalance subtree.
+    *root = shrunk(t, n, 0);
+
+    return result;
+}
+
+/** \fn int insert_elmt_recur(tree *t, node *n, node add_node);
+ * \brief Recursive function too add element in tree.
+ *
+ * \return Number of element inserted.
+ * \param t Tree which contains \c n.
+ * \param n Root of tree where element must be inserted.
+ * \param add_node Element to be added in tree.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int insert_elmt_recur(tree *t, node *n, node add_node)
+{
+    int present = 0; // 1 means that data already present
+    int cmp;
+
+    // Here is the end of a tree. It must create new node here
+    DLOG("Insert %p at level %d", add_node, level_insert);
+    if (*n == NULL) {
+        (*n) = add_node;
+        (*n)->left = NULL;
+        (*n)->right = NULL;
+        adjust_tree_height(t, *n);
+
+        return 0;
+    }
+
+    *n = own_node(t, *n);
+    push_tag(t, *n);
+    cmp = compare_data(t, (*n)->data, add_node->data);
+
+    // Check if current node is the node you want to add
+    if (cmp == 0 && !t->multimap)
+        // node already exist
+        return 1;
+
+    if (cmp > 0) {
+        // Current node is higher that node you want to add
+        // Insert it on left subtree.
+        DLOG("Down into left level %d", ++level_insert);
+        present = insert_elmt_recur(t, &(*n)->left, add_node);
+        DLOG("Out of level %d", level_insert--);
+
+        if (!present) {
+            // node was really inserted, need to re-balance tree
+            *n = grown(t, *n, 1);
+            return 0;
+        } else
+            // node not inserted in subtree
+            return 1;
+    } else {
+        // Current node is smaller that node you want to add
+        // Insert it on right subtree.
+        DLOG("Down into right level %d", ++level_insert);
+        present = insert_elmt_recur(t, &(*n)->right, add_node);
+        DLOG("Out of level %d", level_insert--);
+
+        if (!present) {
+            // node was really inserted, need to re-balance tree
+            *n = grown(t, *n, 0);
+            return 0;
+        } else
+            // node not inserted in subtree
+            return 1;
+    }
+
+}
+
+/** \fn void verif_avl(tree *t, node n, int tree_min, int tree_max,
+ *                      void *data_min, void *data_max);
+ * \brief Recursive deffensive function to check if tree is an AVL tree.
+ *
+ * \param t Tree which contains \c n. A rank balanced tree is checked as
+ * a weak AVL tree.
+ * \param n Pointer to root of tree.
+ * \param tree_min Boolean must be true if \c tree is the minimum node.
+ * \param tree_max Boolean must be true if \c tree is the maximum node.
+ * \param data_min Pointer to the minimum element of sub-tree.
+ * \param data_max Pointer to the maximum element of sub-tree.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void verif_avl(tree *t,
+        node n,
+        int tree_min,
+        int tree_max,
+        void *data_min,
+        void *data_max)
+{
+    unsigned hg;
+    unsigned hd;
+
+    // Check order of data.
+    if (tree_min && compare_data(t, n->data, data_min) < 0) {
+        DLOG("Tree->data < data_min");
+        exit(-1);
+    }
+    if (tree_max && compare_data(t, n->data, data_max) > 0) {
+        DLOG("Tree->data > data_min");
+        exit(-2);
+    }
+
+    // Check avl left subtree.
+    if (n->left != NULL) {
+        verif_avl(t,
+                n->left,
+                tree_min,
+                1,
+                data_min,
+                n->data);
+        hg = n->left->height;
+    } else {
+        hg = 0;
+    }
+
+    // Check avl right subtree.
+    if (n->right != NULL) {
+        verif_avl(t,
+                n->right,
+                1,
+                tree_max,
+                n->data,
+                data_max);
+        hd = n->right->height;
+    } else {
+        hd = 0;
+    }
+
+
+    // Check rank differences, 1 or 2, and rank of leaves.
+    if (t->wavl) {
+        if (   hg >= n->height || hd >= n->height
+            || hg + 2 < n->height || hd + 2 < n->height
+            || (hg == 0 && hd == 0 && n->height != 1)) {
+            DLOG("Error in tree rank: hd %u | hg %u | tree->height %u",
+                    hd, hg, n->height);
+            exit(-3);
+        }
+        return;
+    }
+
+    // Check height consistency of each subtree
+    if (hg <= hd) {
+        if (!(hd + 1 == n->height && hg + 2 >= n->height)) {
+            DLOG("(hg<hd) Error in tree height: hd %u | hg %u | tree->height %u",
+                    hd, hg, n->height);
+            exit(-3);
+        }
+    } else {
+        if (!(hg + 1 == n->height && hd + 2 >= n->height)) {
+            DLOG("(hg>hd) Error in tree height: hd %u | hg %u | tree->height %u",
+                    hd, hg, n->height);
+            exit(-4);
+        }
+    }
+}
+
+/** \fn unsigned int delete_tree_recur(tree *t, node n);
+ * \brief Recursively delete all node in tree.
+ *
+ * \return Number of deleted nodes.
+ * \param t Tree which contains \c n.
+ * \param n Root node of tree to delete.
+ *
+ * Nodes still used by a snapshot are only released.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+unsigned int delete_tree_recur(tree *t, node n)
+{
+    unsigned int count = 1;
+
+    if (n == NULL)
+        return 0;
+    if (t->persistent && --(NODE_SHARE(t, n)->refs) > 0)
+        return 0;
+
+    if (n->left != NULL)
+        count += delete_tree_recur(t, n->left);
+    if (n->right != NULL)
+        count += delete_tree_recur(t, n->right);
+
+    drop_data(t, n);
+    free(n);
+
+    return count;
+}
+
+/** \fn unsigned int copy_range_recur(tree *t, node n,
+ *                                   void (*removed)(void *, void *),
+ *                                   void *param);
+ * \brief Give a copy of all data of a shared subtree.
+ *
+ * \return Number of data in subtree.
+ * \param t Persistent tree which contained \c n.
+ * \param n Root of subtree, which is not modified.
+ * \param removed Function which receives each copy, may be NULL.
+ * \param param Pointer to extra data to pass to \c removed function.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+unsigned int copy_range_recur(tree *t, node n,
+        void (*removed)(void *, void *), void *param)
+{
+    unsigned int count = 1;
+
+    if (n == NULL)
+        return 0;
+
+    count += copy_range_recur(t, n->left, removed, param);
+    if (removed != NULL) {
+        void *data = malloc(t->datasize);
+
+        t->data_copy(n->data, data);
+        removed(data, param);
+    }
+    count += copy_range_recur(t, n->right, removed, param);
+
+    return count;
+}
+
+/** \fn void print_tree_recur(tree *t, node n);
+ * \brief Recursive function to print tree. Use for debug.
+ *
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void print_tree_recur(tree *t, node n)
+{
+    if (n == NULL)
+        return;
+
+    push_tag(t, n);
+    // recursively print left subtree.
+    print_tree_recur(t, n->left);
+    {
+        // print current node with debug information.
+        unsigned i = 0;
+        for (i = 0; i < n->height; i++)
+            printf("            ");
+        printf("[%d|%p]", n->height, n);
+        t->data_print(n->data);
+        printf("\n");
+    }
+    // recursively print right subtree.
+    print_tree_recur(t, n->right);
+}
+
+/** \fn void explore_tree_recur(tree *t, node n,
+ *                              void (*treatement)(void *, void *),
+ *                              void *param);
+ * \brief Recursive exploration of tree.
+ *
+ * \param t Tree which contains \c n.
+ * \param n Pointer to subtree.
+ * \param treatement Function apply to each node of tree.
+ * \param param Pointer to data to pass to \c treatement function.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void explore_tree_recur(tree *t, node n,
+        void (*treatement)(void *, void *), void *param)
+{
+    if (n == NULL)
+        return;
+
+    push_tag(t, n);
+    // recursively treat left subtree.
+    explore_tree_recur(t, n->left, treatement, param);
+    // treat current node.
+    if (!(n->flags & NODE_DEAD))
+        treatement(n->data, param);
+    // recursively treat right subtree.
+    explore_tree_recur(t, n->right, treatement, param);
+}
+
+/** \fn int explore_restrain_tree_recur(tree *t, node n,
+ *                                      int (*check)(void *, void *),
+ *                                      void *param, void *data_min,
+ *                                      void *data_max);
+ * \brief Recursive and restrain exploration of tree.
+ *
+ * \return Accumulation of return value of \c check function.
+ * \param t Tree which contains \c n.
+ * \param n Pointer to root of tree.
+ * \param check Function apply to each node of tree between \c data_min and
+ * \c data_max.
+ * \param param Pointer to data to pass to \c check function
+ * \param data_min All treated node are greater than \c data_min, NULL if
+ * the whole tree is.
+ * \param data_max All treated node are smaller than \c data_max, NULL if
+ * the whole tree is.
+ *
+ * Subtrees on the inner side of an element in range are known to be on
+ * the right side of its bound, which is not compared again there. So
+ * only nodes of the two boundary paths are compared, and enclosed
+ * subtrees are browsed without any comparison.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int explore_restrain_tree_recur(tree *t, node n,
+        int (*check)(void *, void *),
+        void *param,
+        void *data_min, void *data_max)
+{
+    if (n == NULL)
+        return 0;
+
+    push_tag(t, n);
+    if (data_max != NULL && compare_data(t, n->data, data_max) > 0)
+        // current data is not in the asked range.
+        return explore_restrain_tree_recur(t, n->left, check, param,
+                                            data_min, data_max);
+    else if (data_min != NULL && compare_data(t, n->data, data_min) < 0)
+        // current data is not in the asked range.
+        return explore_restrain_tree_recur(t, n->right, check, param,
+                                            data_min, data_max);
+    else {
+        // current data is in the range.
+        int accu = 0;
+        // treat recursively left subtree, all smaller than data_max.
+        accu += explore_restrain_tree_recur(t, n->left, check, param,
+                                            data_min, NULL);
+        // treat current node.
+        if (!(n->flags & NODE_DEAD))
+            accu += check(n->data, param);
+        // treat recursively right subtree, all greater than data_min.
+        accu += explore_restrain_tree_recur(t, n->right, check, param,
+                                            NULL, data_max);
+        return accu;
+    }
+}
+
+
+/** \fn int get_data_recur(tree *t, node n, void *data, size_t data_size)
+ * \brief Recursively get of a single data.
+ *
+ * \param t Tree which contains \c n.
+ * \param n Root of tree to analyze.
+ * \param data Pointer to the asked data. At the begining of the function,
+ * only field used in \c avl_data_cmp must be filled, at the end (and if
+ * data exist in tree), all filled will be filled.
+ * \param data_size Size of the data structure (need to copy data).
+ * \return 1 if data was found, 0 if not.
+ *
+ * \warning If you use this function, you probably make a mistake.
+ */
+int get_data_recur(tree *t, node n, void *data, size_t data_size)
+{
+    int cmp = 0;
+
+    if (n == NULL)
+        return 0;
+
+    push_tag(t, n);
+    cmp = compare_data(t, n->data, data);
+    if (cmp == 0) {
+        if (n->flags & NODE_DEAD)
+            return 0;
+        // An equal data inserted before is in left subtree.
+        if (t->multimap && get_data_recur(t, n->left, data, data_size))
+            return 1;
+        // Current node is the good node, copy it.
+        memcpy(data, n->data, data_size);
+        return 1;
+    } else if (cmp > 0) {
+        // Need to go deep in the left subtree.
+        return get_data_recur(t, n->left, data, data_size);
+    } else {
+        // Need to go deep in the right subtree.
+        return get_data_recur(t, n->right, data, data_size);
+    }
+
+}
+
+/** \fn void *aggregate_range_recur(tree *t, node n,
+ *                                   void *data_min, void *data_max,
+ *                                   char *buffer);
+ * \brief Recursive aggregation of summaries between \c data_min and
+ * \c data_max.
+ *
+ * \return Pointer to the summary of all elements of subtree in range, NULL
+ * if there is no such element.
+ * \param t Tree which contains \c n.
+ * \param n Root of subtree to analyze.
+ * \param data_min Lower bound of range, NULL if subtree is not bounded.
+ * \param data_max Upper bound of range, NULL if subtree is not bounded.
+ * \param buffer Scratch memory big enough to store twice as many summaries
+ * as height of \c n.
+ *
+ * Once the two bounds of the range split into two different subtrees, each
+ * subtree is bounded on one side only, and all its subtrees on the other
+ * side are entirely in range: their cached summary is used directly. So
+ * only the nodes of the two boundary paths are compared and combined.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void *aggregate_range_recur(tree *t, node n,
+        void *data_min, void *data_max,
+        char *buffer)
+{
+    void *left;
+    void *right;
+    char *right_buffer;
+
+    if (n == NULL)
+        return NULL;
+
+    // whole subtree is in range, its summary is already known.
+    if (data_min == NULL && data_max == NULL)
+        return NODE_SUMMARY(n);
+
+    push_tag(t, n);
+    if (data_min != NULL && compare_data(t, n->data, data_min) < 0)
+        // current data is not in the asked range.
+        return aggregate_range_recur(t, n->right, data_min, data_max, buffer);
+    if (data_max != NULL && compare_data(t, n->data, data_max) > 0)
+        // current data is not in the asked range.
+        return aggregate_range_recur(t, n->left, data_min, data_max, buffer);
+
+    // current data is in range: left subtree is only bounded by data_min and
+    // right subtree only by data_max. When both are bounded, right subtree
+    // uses scratch memory after the one of left subtree.
+    if (data_min != NULL)
+        right_buffer = buffer + (n->height + 1) * t->summary_size;
+    else
+        right_buffer = buffer + t->summary_size;
+    left = aggregate_range_recur(t, n->left, data_min, NULL,
+                                 buffer + t->summary_size);
+    right = aggregate_range_recur(t, n->right, NULL, data_max, right_buffer);
+    t->summary_combine(buffer, left, n->data, right);
+
+    return buffer;
+}
+
+/** \fn void update_range_recur(tree *t, node n,
+ *                              void *data_min, void *data_max,
+ *                              void *tag);
+ * \brief Recursive application of a tag between \c data_min and
+ * \c data_max.
+ *
+ * \param t Tree which contains \c n.
+ * \param n Root of subtree to update.
+ * \param data_min Lower bound of range, NULL if subtree is not bounded.
+ * \param data_max Upper bound of range, NULL if subtree is not bounded.
+ * \param tag Tag to apply.
+ *
+ * Like \c aggregate_range_recur, subtrees entirely in range are not
+ * explored: the tag is stored in their root and given to sons later.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void update_range_recur(tree *t, node n,
+        void *data_min, void *data_max,
+        void *tag)
+{
+    if (n == NULL)
+        return;
+
+    // whole subtree is in range.
+    if (data_min == NULL && data_max == NULL) {
+        apply_tag(t, n, tag);
+        return;
+    }
+
+    push_tag(t, n);
+    if (data_min != NULL && compare_data(t, n->data, data_min) < 0) {
+        // current data is not in the asked range.
+        update_range_recur(t, n->right, data_min, data_max, tag);
+    } else if (data_max != NULL && compare_data(t, n->data, data_max) > 0) {
+        // current data is not in the asked range.
+        update_range_recur(t, n->left, data_min, data_max, tag);
+    } else {
+        // current data is in range.
+        update_range_recur(t, n->left, data_min, NULL, tag);
+        update_range_recur(t, n->right, NULL, data_max, tag);
+        t->tag_apply(n->data, NULL, tag);
+    }
+
+    // summary of sons may have changed, but not their height.
+    update_summary(t, n);
+}
+
+/** \fn node build_recur(tree *t, void *(*next)(void *), void *param,
+ *                        unsigned int count, size_t datasize);
+ * \brief Recursively build a perfectly balanced tree from sorted data.
+ *
+ * \return Root of the new subtree.
+ * \param t Tree which will contain the new subtree.
+ * \param next Function which gives the next data, in increasing order.
+ * \param param Pointer to extra data to pass to \c next function.
+ * \param count Number of data to read.
+ * \param datasize Size of each data.
+ *
+ * Left subtree is built first, so data are read in order, and it gets one
+ * more data than right subtree when \c count is even. No comparison nor
+ * rotation is needed.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node build_recur(tree *t, void *(*next)(void *), void *param,
+        unsigned int count, size_t datasize)
+{
+    node n;
+    node left;
+
+    if (count == 0)
+        return NULL;
+
+    // build left subtree with the smallest half of data.
+    left = build_recur(t, next, param, count / 2, datasize);
+
+    // current node takes the median data.
+    n = alloc_node(t);
+    n->data = malloc(datasize);
+    store_data(t, next(param), n->data);
+    n->left = left;
+
+    // build right subtree with the remaining data.
+    n->right = build_recur(t, next, param, count - count / 2 - 1, datasize);
+    adjust_tree_height(t, n);
+
+    return n;
+}
+
+/** \struct _sorted_array
+ * \brief State of reading of a sorted array by \c next_array_data.
+ */
+struct _sorted_array {
+    /** Next data to read */
+    char *data;
+    /** Size of each data */
+    size_t datasize;
+};
+
+/** \fn void *next_array_data(void *param);
+ * \brief Iterator on a sorted array, used by \c build_from_sorted.
+ *
+ * \return Pointer to the next data of array.
+ * \param param Pointer to a \c _sorted_array structure.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void *next_array_data(void *param)
+{
+    struct _sorted_array *array = (struct _sorted_array *) param;
+    void *d = array->data;
+
+    array->data += array->datasize;
+
+    return d;
+}
+
+/** \fn node join_recur(tree *t, node left, node middle, node right);
+ * \brief Join two trees around a middle node.
+ *
+ * \return Root of the joined tree.
+ * \param t Tree which will contain the joined tree.
+ * \param left Root of tree with all data smaller than data of \c middle.
+ * \param middle Unlinked node.
+ * \param right Root of tree with all data greater than data of \c middle.
+ *
+ * The highest tree is followed along its inner border down to a subtree
+ * with about the same height as the other tree. This subtree and the other
+ * tree become sons of \c middle, and the tree is rebalanced on the way
+ * back. This costs \f$\mathcal{O}(|h_{left} - h_{right}| + 1)\f$. In a
+ * rank balanced tree, nodes of the border are rebalanced as after an
+ * insertion, so that they keep their rank.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node join_recur(tree *t, node left, node middle, node right)
+{
+    if (height_tree(left) > height_tree(right) + 1) {
+        // left tree is too high, go down its right border.
+        left = own_node(t, left);
+        push_tag(t, left);
+        left->right = join_recur(t, left->right, middle, right);
+        return t->wavl ? grown(t, left, 0) : equi_right(t, left);
+    }
+    if (height_tree(right) > height_tree(left) + 1) {
+        // right tree is too high, go down its left border.
+        right = own_node(t, right);
+        push_tag(t, right);
+        right->left = join_recur(t, left, middle, right->left);
+        return t->wavl ? grown(t, right, 1) : equi_left(t, right);
+    }
+
+    // both trees have nearly the same height.
+    middle->left = left;
+    middle->right = right;
+    adjust_tree_height(t, middle);
+
+    return middle;
+}
+
+/** \fn node join2_recur(tree *t, node left, node right);
+ * \brief Join two trees without middle node.
+ *
+ * \return Root of the joined tree.
+ * \param t Tree which will contain the joined tree.
+ * \param left Root of tree with all data smaller than data of \c right.
+ * \param right Root of tree with all data greater than data of \c left.
+ *
+ * Minimum node of \c right is unlinked to be used as middle node.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node join2_recur(tree *t, node left, node right)
+{
+    node middle;
+
+    if (left == NULL)
+        return right;
+    if (right == NULL)
+        return left;
+
+    middle = extract_node_min_recur(t, &right);
+
+    return join_recur(t, left, middle, right);
+}
+
+/** \fn void split_recur(tree *t, node n, void *data,
+ *                       node *lower, node *greater, node *found);
+ * \brief Split a tree around \c data.
+ *
+ * \param t Tree which contains \c n.
+ * \param n Root of tree to split.
+ * \param data Data used to split tree.
+ * \param lower Filled with root of tree of all data smaller than \c data.
+ * \param greater Filled with root of tree of all data greater than
+ * \c data.
+ * \param found Filled with unlinked node equal to \c data, NULL if there
+ * is none.
+ *
+ * Each node of the path to \c data joins the tree of its side, and all
+ * these joins cost \f$\mathcal{O}(\log n)\f$.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void split_recur(tree *t, node n, void *data,
+        node *lower, node *greater, node *found)
+{
+    node temp;
+    int cmp;
+
+    if (n == NULL) {
+        *lower = NULL;
+        *greater = NULL;
+        *found = NULL;
+        return;
+    }
+
+    n = own_node(t, n);
+    push_tag(t, n);
+    cmp = compare_data(t, n->data, data);
+    if (cmp == 0) {
+        *lower = n->left;
+        *greater = n->right;
+        n->left = n->right = NULL;
+        *found = n;
+    } else if (cmp > 0) {
+        // Current node and its right subtree are greater than data.
+        split_recur(t, n->left, data, lower, &temp, found);
+        *greater = join_recur(t, temp, n, n->right);
+    } else {
+        // Current node and its left subtree are smaller than data.
+        split_recur(t, n->right, data, &temp, greater, found);
+        *lower = join_recur(t, n->left, n, temp);
+    }
+}
+
+/** \fn node union_recur(tree *t, tree *other, node n1, node n2,
+ *                       unsigned int *common);
+ * \brief Recursive union of two trees.
+ *
+ * \return Root of tree of all data of \c n1 and \c n2.
+ * \param t Tree which contains \c n1.
+ * \param other Tree which contains \c n2.
+ * \param n1 Root of first tree.
+ * \param n2 Root of second tree.
+ * \param common Incremented for each data in both trees.
+ *
+ * When a data is in both trees, node of \c n1 is kept.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node union_recur(tree *t, tree *other, node n1, node n2, unsigned int *common)
+{
+    node lower;
+    node greater;
+    node found;
+    node left;
+    node right;
+
+    if (n1 == NULL)
+        return n2;
+    if (n2 == NULL)
+        return n1;
+
+    n1 = own_node(t, n1);
+    push_tag(t, n1);
+    split_recur(t, n2, n1->data, &lower, &greater, &found);
+    if (found != NULL) {
+        drop_data(other, found);
+        free(found);
+        (*common)++;
+    }
+    left = union_recur(t, other, n1->left, lower, common);
+    right = union_recur(t, other, n1->right, greater, common);
+
+    return join_recur(t, left, n1, right);
+}
+
+/** \fn node intersection_recur(tree *t, tree *other, node n1, node n2,
+ *                              unsigned int *removed);
+ * \brief Recursive intersection of two trees.
+ *
+ * \return Root of tree of all data both in \c n1 and \c n2.
+ * \param t Tree which contains \c n1.
+ * \param other Tree which contains \c n2.
+ * \param n1 Root of first tree.
+ * \param n2 Root of second tree.
+ * \param removed Incremented for each deleted node of \c n1.
+ *
+ * Nodes of \c n1 are kept, all nodes of \c n2 are deleted.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node intersection_recur(tree *t, tree *other, node n1, node n2,
+        unsigned int *removed)
+{
+    node lower;
+    node greater;
+    node found;
+    node left;
+    node right;
+
+    if (n1 == NULL) {
+        delete_tree_recur(other, n2);
+        return NULL;
+    }
+    if (n2 == NULL) {
+        if (t->persistent) {
+            // shared nodes are not deleted, count elements first.
+            *removed += copy_range_recur(t, n1, NULL, NULL);
+            delete_tree_recur(t, n1);
+        } else {
+            *removed += delete_tree_recur(t, n1);
+        }
+        return NULL;
+    }
+
+    n1 = own_node(t, n1);
+    push_tag(t, n1);
+    split_recur(t, n2, n1->data, &lower, &greater, &found);
+    left = intersection_recur(t, other, n1->left, lower, removed);
+    right = intersection_recur(t, other, n1->right, greater, removed);
+
+    if (found != NULL) {
+        drop_data(other, found);
+        free(found);
+        return join_recur(t, left, n1, right);
+    }
+
+    drop_data(t, n1);
+    free(n1);
+    (*removed)++;
+
+    return join2_recur(t, left, right);
+}
+
+/** \fn node difference_recur(tree *t, tree *other, node n1, node n2,
+ *                            unsigned int *removed);
+ * \brief Recursive difference of two trees.
+ *
+ * \return Root of tree of all data of \c n1 which are not in \c n2.
+ * \param t Tree which contains \c n1.
+ * \param other Tree which contains \c n2.
+ * \param n1 Root of first tree.
+ * \param n2 Root of second tree.
+ * \param removed Incremented for each deleted node of \c n1.
+ *
+ * All nodes of \c n2 are deleted.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node difference_recur(tree *t, tree *other, node n1, node n2,
+        unsigned int *removed)
+{
+    node lower;
+    node greater;
+    node found;
+    node left;
+    node right;
+
+    if (n2 == NULL)
+        return n1;
+    if (n1 == NULL) {
+        delete_tree_recur(other, n2);
+        return NULL;
+    }
+
+    n2 = own_node(other, n2);
+    push_tag(t, n2);
+    split_recur(t, n1, n2->data, &lower, &greater, &found);
+    left = difference_recur(t, other, lower, n2->left, removed);
+    right = difference_recur(t, other, greater, n2->right, removed);
+
+    if (found != NULL) {
+        drop_data(t, found);
+        free(found);
+        (*removed)++;
+    }
+    drop_data(other, n2);
+    free(n2);
+
+    return join2_recur(t, left, right);
+}
+
+/** \fn unsigned int count_smallest_tree(node a, node b, int *smallest);
+ * \brief Count nodes of the smallest of two trees.
+ *
+ * \return Number of nodes of the smallest tree.
+ * \param a Root of first tree.
+ * \param b Root of second tree.
+ * \param smallest Filled with 0 if \c a is the smallest tree, 1 if not.
+ *
+ * Both trees are browsed in turn, so this function costs
+ * \f$\mathcal{O}(\min(|a|, |b|))\f$.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+unsigned int count_smallest_tree(node a, node b, int *smallest)
+{
+    node *stack[2];
+    unsigned int size[2] = { 0, 0 };
+    unsigned int count = 0;
+    int i;
+
+    stack[0] = malloc((height_tree(a) + 1) * sizeof(node));
+    stack[1] = malloc((height_tree(b) + 1) * sizeof(node));
+    if (a != NULL)
+        stack[0][size[0]++] = a;
+    if (b != NULL)
+        stack[1][size[1]++] = b;
+
+    // Each tree is browsed in preorder, one node at a time.
+    for (;;) {
+        for (i = 0; i < 2; i++) {
+            node n;
+
+            if (size[i] == 0) {
+                *smallest = i;
+                free(stack[0]);
+                free(stack[1]);
+                return count;
+            }
+            n = stack[i][--size[i]];
+            if (n->right != NULL)
+                stack[i][size[i]++] = n->right;
+            if (n->left != NULL)
+                stack[i][size[i]++] = n->left;
+        }
+        count++;
+    }
+}
+
+/** \fn int compatible_trees(tree *t1, tree *t2);
+ * \brief Check if nodes of \c t2 can be moved into \c t1.
+ *
+ * \return 1 if trees are compatible, 0 if not.
+ * \param t1 First tree.
+ * \param t2 Second tree.
+ *
+ * Trees are not changed, callers give them the same arena with
+ * \c share_arena once all their checks passed.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int compatible_trees(tree *t1, tree *t2)
+{
+    unsigned int i;
+
+    if (t1 == NULL || t2 == NULL || t1 == t2)
+        return 0;
+
+    for (i = 0; i < t1->field_count && i < t2->field_count; i++) {
+        if (   t1->fields[i].type != t2->fields[i].type
+            || t1->fields[i].offset != t2->fields[i].offset
+            || t1->fields[i].length != t2->fields[i].length
+            || t1->fields[i].descending != t2->fields[i].descending) {
+            WLOG("Trees do not store the same kind of data");
+            return 0;
+        }
+    }
+
+    if (   t1->data_cmp != t2->data_cmp
+        || t1->data_less != t2->data_less
+        || t1->key.type != t2->key.type
+        || t1->key.offset != t2->key.offset
+        || t1->key.length != t2->key.length
+        || t1->key.descending != t2->key.descending
+        || t1->field_count != t2->field_count
+        || t1->summary_size != t2->summary_size
+        || t1->summary_combine != t2->summary_combine
+        || t1->tag_size != t2->tag_size
+        || t1->tag_apply != t2->tag_apply
+        || t1->tag_compose != t2->tag_compose
+        || t1->multimap != t2->multimap
+        || t1->persistent != t2->persistent
+        || t1->wavl != t2->wavl
+        || t1->relaxed != t2->relaxed) {
+        WLOG("Trees do not store the same kind of data");
+        return 0;
+    }
+
+    if (   t1->key.type == KEY_CSTRING && t1->arena != t2->arena
+        && t1->arena->refs > 1 && t2->arena->refs > 1) {
+        WLOG("Both trees already share their strings with other trees");
+        return 0;
+    }
+
+    return 1;
+}
+
+/** \struct _batch
+ * \brief State of a batch insertion.
+ */
+struct _batch {
+    /** Next data of sorted batch to read */
+    char **next;
+    /** Pointer to the first data of batch, in original order */
+    char *data;
+    /** Size of each data */
+    size_t datasize;
+    /** Filled with 1 for each inserted data and 0 for each duplicate */
+    int *inserted;
+    /** Number of data really inserted */
+    unsigned int added;
+};
+
+/** \fn void *next_batch_data(void *param);
+ * \brief Iterator on a sorted batch, used to build new nodes.
+ *
+ * \return Pointer to the next data of batch.
+ * \param param Pointer to a \c _batch structure.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void *next_batch_data(void *param)
+{
+    struct _batch *batch = (struct _batch *) param;
+
+    return *(batch->next++);
+}
+
+/** \fn void reject_batch_data(struct _batch *batch, char *data);
+ * \brief Mark a data of batch as duplicate.
+ *
+ * \param batch Batch which contains \c data.
+ * \param data Pointer to rejected data.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void reject_batch_data(struct _batch *batch, char *data)
+{
+    if (batch->inserted != NULL)
+        batch->inserted[(size_t) (data - batch->data) / batch->datasize] = 0;
+}
+
+/** \fn void sort_batch(tree *t, char **items, char **buffer,
+ *                      unsigned int count);
+ * \brief Stable merge sort of pointers to data.
+ *
+ * \param t Tree which gives comparison function.
+ * \param items Array of pointers to sort.
+ * \param buffer Array of the same size, used during merges.
+ * \param count Number of pointers to sort.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void sort_batch(tree *t, char **items, char **buffer, unsigned int count)
+{
+    unsigned int half = count / 2;
+    unsigned int i = 0;
+    unsigned int j = half;
+    unsigned int k = 0;
+
+    if (count < 2)
+        return;
+
+    sort_batch(t, items, buffer, half);
+    sort_batch(t, items + half, buffer, count - half);
+
+    // merge both sorted halves, the left one wins on equality.
+    while (i < half && j < count) {
+        if (compare_data(t, items[j], items[i]) < 0)
+            buffer[k++] = items[j++];
+        else
+            buffer[k++] = items[i++];
+    }
+    while (i < half)
+        buffer[k++] = items[i++];
+    while (j < count)
+        buffer[k++] = items[j++];
+    memcpy(items, buffer, count * sizeof(char *));
+}
+
+/** \fn node insert_sorted_recur(tree *t, node n, char **items,
+ *                               unsigned int count, struct _batch *batch);
+ * \brief Recursive insertion of sorted data.
+ *
+ * \return New root of subtree.
+ * \param t Tree which contains \c n.
+ * \param n Root of subtree where data must be inserted.
+ * \param items Sorted array of pointers to distinct data.
+ * \param count Number of data to insert.
+ * \param batch State of batch insertion.
+ *
+ * Data of \c n splits sorted data into two parts, one for each subtree,
+ * and \c n joins both new subtrees. Subtrees without new data are not
+ * visited at all, so inserting \e m data costs
+ * \f$\mathcal{O}(m \log(\frac{n}{m} + 1))\f$, as a finger search does.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node insert_sorted_recur(tree *t, node n, char **items, unsigned int count,
+        struct _batch *batch)
+{
+    unsigned int lo = 0;
+    unsigned int hi = count;
+    unsigned int found = 0;
+    node left;
+    node right;
+
+    if (count == 0)
+        return n;
+
+    if (n == NULL) {
+        // all data are new, build a balanced subtree.
+        batch->next = items;
+        batch->added += count;
+        return build_recur(t, next_batch_data, batch, count, batch->datasize);
+    }
+
+    // look for the first data which is not smaller than current node.
+    n = own_node(t, n);
+    push_tag(t, n);
+    while (lo < hi) {
+        unsigned int mid = lo + (hi - lo) / 2;
+        int cmp = compare_data(t, items[mid], n->data);
+
+        if (cmp == 0 && !t->multimap) {
+            // data already in tree.
+            reject_batch_data(batch, items[mid]);
+            lo = mid;
+            found = 1;
+            break;
+        } else if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            // data equal in multimap goes after current node.
+            hi = mid;
+        }
+    }
+
+    left = insert_sorted_recur(t, n->left, items, lo, batch);
+    right = insert_sorted_recur(t, n->right, items + lo + found,
+                                count - lo - found, batch);
+
+    return join_recur(t, left, n, right);
+}
+
+/** \fn void flatten_tree_recur(tree *t, node n, node *nodes,
+ *                              unsigned int *count);
+ * \brief Store all nodes of a tree in an array, in order.
+ *
+ * \param t Tree which contains \c n.
+ * \param n Root of subtree to flatten.
+ * \param nodes Array big enough to store all nodes of subtree.
+ * \param count Number of nodes already in array, updated.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void flatten_tree_recur(tree *t, node n, node *nodes, unsigned int *count)
+{
+    if (n == NULL)
+        return;
+
+    // all nodes are linked again.
+    n = own_node(t, n);
+    push_tag(t, n);
+    flatten_tree_recur(t, n->left, nodes, count);
+    nodes[(*count)++] = n;
+    flatten_tree_recur(t, n->right, nodes, count);
+}
+
+/** \fn node link_nodes_recur(tree *t, node *nodes, unsigned int count);
+ * \brief Link a sorted array of nodes into a perfectly balanced tree.
+ *
+ * \return Root of the new tree.
+ * \param t Tree which will contain the nodes.
+ * \param nodes Sorted array of nodes.
+ * \param count Number of nodes in array.
+ *
+ * Like \c build_recur, but with already allocated nodes.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node link_nodes_recur(tree *t, node *nodes, unsigned int count)
+{
+    node n;
+
+    if (count == 0)
+        return NULL;
+
+    n = nodes[count / 2];
+    n->left = link_nodes_recur(t, nodes, count / 2);
+    n->right = link_nodes_recur(t, nodes + count / 2 + 1,
+                                count - count / 2 - 1);
+    adjust_tree_height(t, n);
+
+    return n;
+}
+
+/** \fn node merge_sorted(tree *t, char **items, unsigned int count,
+ *                        struct _batch *batch);
+ * \brief Merge sorted data with all nodes of tree and rebuild it.
+ *
+ * \return New root of tree.
+ * \param t Tree where data must be inserted.
+ * \param items Sorted array of pointers to distinct data.
+ * \param count Number of data to insert.
+ * \param batch State of batch insertion.
+ *
+ * Nodes of tree are reused, so this costs \f$\mathcal{O}(n + m)\f$ with
+ * only one allocation for each new data.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node merge_sorted(tree *t, char **items, unsigned int count,
+        struct _batch *batch)
+{
+    node *nodes = malloc(t->count * sizeof(node));
+    node *merged = malloc((t->count + count) * sizeof(node));
+    unsigned int size = 0;
+    unsigned int i = 0;
+    unsigned int j = 0;
+    unsigned int k = 0;
+    node root;
+
+    flatten_tree_recur(t, t->root, nodes, &size);
+
+    while (i < size || j < count) {
+        int cmp;
+
+        if (j == count)
+            cmp = 1;
+        else if (i == size)
+            cmp = -1;
+        else
+            cmp = compare_data(t, items[j], nodes[i]->data);
+
+        if (cmp < 0) {
+            // new data
+            node n = alloc_node(t);
+            n->data = malloc(batch->datasize);
+            store_data(t, items[j++], n->data);
+            merged[k++] = n;
+            batch->added++;
+        } else if (cmp == 0 && !t->multimap) {
+            // data already in tree
+            reject_batch_data(batch, items[j++]);
+        } else {
+            // data of tree first, it is older in multimap.
+            merged[k++] = nodes[i++];
+        }
+    }
+
+    root = link_nodes_recur(t, merged, k);
+    free(nodes);
+    free(merged);
+
+    return root;
+}
+
+/** \fn unsigned int delete_range_recur(tree *t, node n,
+ *                                     void (*removed)(void *, void *),
+ *                                     void *param);
+ * \brief Recursively delete all nodes of an unlinked tree.
+ *
+ * \return Number of deleted nodes.
+ * \param t Tree which contained \c n.
+ * \param n Root of tree to delete.
+ * \param removed Function which receives each data, in increasing order.
+ * If NULL, data is deleted with \c data_delete.
+ * \param param Pointer to extra data to pass to \c removed function.
+ *
+ * Pending tags are applied before data is given to \c removed.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+unsigned int delete_range_recur(tree *t, node n,
+        void (*removed)(void *, void *), void *param)
+{
+    unsigned int count = 1;
+
+    if (n == NULL)
+        return 0;
+    if (t->persistent && NODE_SHARE(t, n)->refs > 1) {
+        // subtree stays in another tree.
+        NODE_SHARE(t, n)->refs--;
+        return copy_range_recur(t, n, removed, param);
+    }
+
+    push_tag(t, n);
+    count += delete_range_recur(t, n->left, removed, param);
+    if (n->flags & NODE_DEAD) {
+        // element was already deleted.
+        drop_data(t, n);
+        t->dead--;
+        count--;
+    } else if (removed != NULL) {
+        removed(take_data(t, n), param);
+    } else {
+        drop_data(t, n);
+    }
+    count += delete_range_recur(t, n->right, removed, param);
+    free(n);
+
+    return count;
+}
+
+/** \fn void reserve_finger(tree *t);
+ * \brief Make room in finger for the path of next insertion.
+ *
+ * \param t Pointer to tree.
+ *
+ * When finger is not valid, it is set to the root of tree.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void reserve_finger(tree *t)
+{
+    unsigned int size = height_tree(t->root) + 2;
+
+    if (t->finger_size < size) {
+        t->finger = realloc(t->finger, size * sizeof(struct _finger));
+        t->finger_size = size;
+    }
+
+    if (t->finger_depth == 0) {
+        t->finger[0].n = t->root;
+        t->finger[0].lower = -1;
+        t->finger[0].upper = -1;
+        t->finger_depth = 1;
+    }
+}
+
+/** \fn void link_finger(tree *t, node add_node, int cmp);
+ * \brief Link a new node under the last node of finger and rebalance.
+ *
+ * \param t Pointer to tree.
+ * \param add_node Node to link.
+ * \param cmp Comparison of last node of finger with \c add_node: new node
+ * is its left son if positive, its right son if not.
+ *
+ * Path is followed backward and each node is rebalanced, until the height
+ * of a subtree does not change. In augmented trees, summaries must be
+ * computed again up to root, and in relaxed trees, marks up to a marked
+ * node. After a rotation, the end of finger is not a path anymore and it
+ * is cut. Spine must be found again when a rotated node is on it.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void link_finger(tree *t, node add_node, int cmp)
+{
+    struct _finger *f = t->finger;
+    unsigned int depth = t->finger_depth;
+    node parent = f[depth - 1].n;
+    node n;
+    int i;
+
+    add_node->left = NULL;
+    add_node->right = NULL;
+    adjust_tree_height(t, add_node);
+
+    push_tag(t, parent);
+    if (cmp > 0) {
+        parent->left = add_node;
+        f[depth].lower = f[depth - 1].lower;
+        f[depth].upper = (int) depth - 1;
+    } else {
+        parent->right = add_node;
+        f[depth].lower = (int) depth - 1;
+        f[depth].upper = f[depth - 1].upper;
+    }
+    f[depth].n = add_node;
+    t->finger_depth = depth + 1;
+
+    // keep extremes, as in insert_elmt.
+    if (t->leftmost->left == add_node) {
+        t->leftmost = add_node;
+        t->spine_depth = 0;
+    } else if (t->rightmost->right == add_node) {
+        t->rightmost = add_node;
+    }
+
+    // rebalance path backward.
+    for (i = (int) depth - 1; i >= 0; i--) {
+        unsigned int height;
+        unsigned int pending;
+
+        n = f[i].n;
+        height = n->height;
+        pending = n->flags & NODE_PENDING;
+        if (n->left == f[i + 1].n)
+            f[i].n = grown(t, n, 1);
+        else
+            f[i].n = grown(t, n, 0);
+
+        if (f[i].n != n) {
+            // a node without lower bound is on spine.
+            if (f[i].lower < 0)
+                t->spine_depth = 0;
+            t->finger_depth = (unsigned int) i + 1;
+            if (i == 0)
+                t->root = f[0].n;
+            else if (f[i - 1].n->left == n)
+                f[i - 1].n->left = f[i].n;
+            else
+                f[i - 1].n->right = f[i].n;
+        }
+
+        // a node newly marked needs its ancestors marked too.
+        if (   t->summary_combine == NULL
+            && (f[i].n != n || f[i].n->height == height)
+            && (   !t->relaxed || pending
+                || !(f[i].n->flags & NODE_PENDING)))
+            break;
+    }
+}
+
+/** \fn void append_finger(tree *t, node add_node);
+ * \brief Link a new node after the maximum node of tree.
+ *
+ * \param t Pointer to tree.
+ * \param add_node Node to link.
+ *
+ * Finger climbs back to the right border of tree and goes down along it,
+ * without any comparison.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void append_finger(tree *t, node add_node)
+{
+    struct _finger *f;
+    unsigned int depth;
+    node n;
+
+    reserve_finger(t);
+    f = t->finger;
+    depth = t->finger_depth;
+
+    // right border is the path without upper bound.
+    while (f[depth - 1].upper >= 0)
+        depth = (unsigned int) f[depth - 1].upper + 1;
+
+    n = f[depth - 1].n;
+    while (n->right != NULL) {
+        push_tag(t, n);
+        f[depth].n = n->right;
+        f[depth].lower = (int) depth - 1;
+        f[depth].upper = -1;
+        n = f[depth++].n;
+    }
+
+    t->finger_depth = depth;
+    link_finger(t, add_node, -1);
+}
+
+/** \fn node scan_end(tree *t, void *bound, int exclude, int reverse);
+ * \brief Find last node of a scan.
+ *
+ * \return Last node not beyond \c bound in scan order, NULL if there is
+ * none.
+ * \param t Pointer to tree.
+ * \param bound Pointer to data ending scan, NULL for no bound.
+ * \param exclude Must be true if data equal to \c bound is not scanned.
+ * \param reverse Must be true if scan runs in decreasing order.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node scan_end(tree *t, void *bound, int exclude, int reverse)
+{
+    node last = NULL;
+    node n = t->root;
+
+    if (bound == NULL)
+        return reverse ? t->leftmost : t->rightmost;
+
+    while (n != NULL) {
+        int cmp;
+
+        push_tag(t, n);
+        cmp = compare_data(t, n->data, bound);
+        cmp = reverse ? (cmp < 0) - (cmp > 0) : (cmp > 0) - (cmp < 0);
+        if (cmp < 0 || (cmp == 0 && !exclude)) {
+            // node is in range, look for a later one.
+            last = n;
+            n = reverse ? n->left : n->right;
+        } else {
+            n = reverse ? n->right : n->left;
+        }
+    }
+
+    return last;
+}
+
+/** \fn unsigned int scan_start(tree *t, void *bound, int exclude,
+ *                              int reverse, node *stack);
+ * \brief Fill stack with the path to the first node of a scan.
+ *
+ * \return Number of nodes in \c stack.
+ * \param t Pointer to tree.
+ * \param bound Pointer to data starting scan, NULL for no bound.
+ * \param exclude Must be true if data equal to \c bound is not scanned.
+ * \param reverse Must be true if scan runs in decreasing order.
+ * \param stack Filled with the nodes of path that are not before
+ * \c bound. First node of scan is on top.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+unsigned int scan_start(tree *t, void *bound, int exclude, int reverse,
+        node *stack)
+{
+    unsigned int size = 0;
+    node n = t->root;
+
+    while (n != NULL) {
+        int cmp = 1;
+
+        push_tag(t, n);
+        if (bound != NULL) {
+            cmp = compare_data(t, n->data, bound);
+            cmp = reverse ? (cmp < 0) - (cmp > 0) : (cmp > 0) - (cmp < 0);
+        }
+        if (cmp > 0 || (cmp == 0 && !exclude)) {
+            // node will be scanned after the nodes of its first subtree.
+            stack[size++] = n;
+            n = reverse ? n->right : n->left;
+        } else {
+            n = reverse ? n->left : n->right;
+        }
+    }
+
+    return size;
+}
+
+/** \fn node search_less(tree *t, void *data);
+ * \brief Look for the node equal to \c data, with one call to
+ * \c data_less per level.
+ *
+ * \return Node equal to \c data, NULL if there is none.
+ * \param t Tree ordered by a less-than predicate.
+ * \param data Data to look for.
+ *
+ * Pending tags of path are applied, so data of node can be replaced.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node search_less(tree *t, void *data)
+{
+    node candidate = NULL;
+    node n = t->root;
+
+    while (n != NULL) {
+        push_tag(t, n);
+        if (t->data_less(data, n->data)) {
+            n = n->left;
+        } else {
+            candidate = n;
+            n = n->right;
+        }
+    }
+
+    // candidate is the greatest node not after data.
+    if (candidate == NULL || t->data_less(candidate->data, data))
+        return NULL;
+
+    return candidate;
+}
+
+/** \fn node find_node(tree *t, void *data);
+ * \brief Look for the node equal to \c data, even if it is marked.
+ *
+ * \return Node equal to \c data, NULL if there is none.
+ * \param t Pointer to tree.
+ * \param data Data to look for.
+ *
+ * Pending tags of path are applied, so data of node can be replaced.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node find_node(tree *t, void *data)
+{
+    node n = t->root;
+
+    if (IS_SEARCH_KEY(t) && t->tag_apply == NULL)
+        return search_key(t, data);
+    if (t->data_less != NULL)
+        return search_less(t, data);
+
+    while (n != NULL) {
+        int cmp;
+
+        push_tag(t, n);
+        cmp = compare_data(t, n->data, data);
+        if (cmp == 0)
+            return n;
+        n = cmp > 0 ? n->left : n->right;
+    }
+
+    return NULL;
+}
+
+/** \fn node find_path(tree *t, void *data, unsigned int *depth, int *left);
+ * \brief Look for the node equal to \c data, keeping path in finger.
+ *
+ * \return Node equal to \c data, even if it is marked, NULL if there is
+ * none.
+ * \param t Pointer to a tree which is not empty.
+ * \param data Data to look for, NULL to follow right border.
+ * \param depth Filled with number of nodes of path.
+ * \param left Filled with 1 if \c data goes left of last node of path, 0
+ * if it goes right.
+ *
+ * Each node of path is compared once, with \c data_less if tree has one,
+ * and data equal to nodes of a multimap goes after them. Path is not
+ * modified, so that nothing is copied when \c data is found.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node find_path(tree *t, void *data, unsigned int *depth, int *left)
+{
+    node candidate = NULL;
+    node n = t->root;
+    int cmp;
+
+    t->finger_depth = 0;
+    reserve_finger(t);
+    *depth = 0;
+    *left = 0;
+    while (n != NULL) {
+        push_tag(t, n);
+        t->finger[(*depth)++].n = n;
+        if (data == NULL) {
+            *left = 0;
+        } else if (t->data_less != NULL) {
+            *left = t->data_less(data, n->data) != 0;
+            if (!*left)
+                candidate = n;
+        } else {
+            cmp = compare_data(t, n->data, data);
+            if (cmp == 0 && !t->multimap)
+                return n;
+            *left = cmp > 0;
+        }
+        n = *left ? n->left : n->right;
+    }
+
+    // candidate is the greatest node not after data.
+    if (   candidate != NULL && !t->multimap
+        && !t->data_less(candidate->data, data))
+        return candidate;
+
+    return NULL;
+}
+
+/** \fn node link_path_recur(tree *t, node n, unsigned int i,
+ *                           unsigned int depth, node add_node, int left);
+ * \brief Link a new node at the end of the path found by \c find_path.
+ *
+ * \return New root of subtree.
+ * \param t Tree which contains \c n.
+ * \param n Node \c i of path, NULL at end of path.
+ * \param i Index of \c n in path.
+ * \param depth Number of nodes of path.
+ * \param add_node Element to be added in tree.
+ * \param left 1 if \c add_node is left son of last node of path.
+ *
+ * Shared nodes of path are copied, and path is rebalanced back, without
+ * comparing data again.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node link_path_recur(tree *t, node n, unsigned int i, unsigned int depth,
+                     node add_node, int left)
+{
+    int go_left = left;
+
+    if (i == depth) {
+        adjust_tree_height(t, add_node);
+        return add_node;
+    }
+
+    if (i + 1 < depth)
+        go_left = n->left == t->finger[i + 1].n;
+    n = own_node(t, n);
+    push_tag(t, n);
+    if (go_left)
+        n->left = link_path_recur(t, n->left, i + 1, depth, add_node, left);
+    else
+        n->right = link_path_recur(t, n->right, i + 1, depth, add_node, left);
+
+    return grown(t, n, go_left);
+}
+
+/** \fn void revive_node(tree *t, node n, void *data, size_t datasize);
+ * \brief Store new data in a marked node.
+ *
+ * \param t Pointer to tree.
+ * \param n Marked node, found with \c find_node.
+ * \param data Pointer to data to add.
+ * \param datasize Size of data.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void revive_node(tree *t, node n, void *data, size_t datasize)
+{
+    drop_data(t, n);
+    n->data = malloc(datasize);
+    store_data(t, data, n->data);
+    n->flags &= ~NODE_DEAD;
+    t->dead--;
+    t->count++;
+}
+
+/** \fn int keep_data(void *data, void *param);
+ * \brief Store \c data in pointer \c param, and stop scan.
+ *
+ * \return Always 1.
+ * \param data Pointer to scanned data.
+ * \param param Pointer to a pointer filled with \c data.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+int keep_data(void *data, void *param)
+{
+    *((void **) param) = data;
+
+    return 1;
+}
+
+/** \fn void split_side_recur(tree *t, node n, void *data, int equal_lower,
+ *                            node *lower, node *greater);
+ * \brief Split a tree around \c data, with equal data on one side.
+ *
+ * \param t Tree which contains \c n.
+ * \param n Root of tree to split.
+ * \param data Data used to split tree.
+ * \param equal_lower Must be true if data equal to \c data go to
+ * \c lower tree, false if they go to \c greater tree.
+ * \param lower Filled with root of tree of smaller data.
+ * \param greater Filled with root of tree of greater data.
+ *
+ * Unlike \c split_recur, any number of nodes can be equal to \c data.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+void split_side_recur(tree *t, node n, void *data, int equal_lower,
+        node *lower, node *greater)
+{
+    node temp;
+    int cmp;
+
+    if (n == NULL) {
+        *lower = NULL;
+        *greater = NULL;
+        return;
+    }
+
+    n = own_node(t, n);
+    push_tag(t, n);
+    cmp = compare_data(t, n->data, data);
+    if (cmp > 0 || (cmp == 0 && !equal_lower)) {
+        // Current node and its right subtree are in greater tree.
+        split_side_recur(t, n->left, data, equal_lower, lower, &temp);
+        *greater = join_recur(t, temp, n, n->right);
+    } else {
+        // Current node and its left subtree are in lower tree.
+        split_side_recur(t, n->right, data, equal_lower, &temp, greater);
+        *lower = join_recur(t, n->left, n, temp);
+    }
+}
+
+/** \fn node rebalance_recur(tree *t, node n, unsigned int *budget);
+ * \brief Balance marked nodes of a relaxed tree.
+ *
+ * \return New root of subtree.
+ * \param t Tree which contains \c n.
+ * \param n Root of subtree.
+ * \param budget Number of nodes which can still be balanced, decreased
+ * for each balanced node.
+ *
+ * Marked sons are balanced first, then node joins its balanced sons in
+ * \f$\mathcal{O}(|h_{left} - h_{right}| + 1)\f$. Node stays marked when
+ * budget is over before its sons are balanced.
+ *
+ * \warning If you use this function you probably make a mistake.
+ */
+node rebalance_recur(tree *t, node n, unsigned int *budget)
+{
+    if (n == NULL || !(n->flags & NODE_PENDING) || *budget == 0)
+        return n;
+
+    n = own_node(t, n);
+    push_tag(t, n);
+    n->left = rebalance_recur(t, n->left, budget);
+    n->right = rebalance_recur(t, n->right, budget);
+    if (   *budget == 0
+        || (n->left != NULL && (n->left->flags & NODE_PENDING))
+        || (n->right != NULL && (n->right->flags & NODE_PENDING))) {
+        // sons may be lower now.
+        adjust_tree_height(t, n);
+        return n;
+    }
+
+    n->flags &= ~NODE_PENDING;
+    (*budget)--;
+
+    // sons are balanced, so rotations of join must not mark any node.
+    t->relaxed = 0;
+    n = join_recur(t, n->left, n, n->right);
+    t->relaxed = 1;
+
+    return n;
+}
+
+/** \fn int stub__data_cmp(void *a, void *b)
+ * \brief Stub function used if no data_cmp functio is provided.
+ *
+ * \param a First node to compare.
+ * \param b Second node to compare.
+ * \return Difference of pointer nodes.
+ *
+ * \warning This function is just a stub and shall never be used
+ * in your production project.
+ */
+int stub__data_cmp(void *a, void *b)
+{
+    return (int) ((ptrdiff_t) a - (ptrdiff_t) b);
+}
+
+/** \fn void stub__data_print(void *d)
+ * \brief Stub function used if no data_print function is provided.
+ *
+ * \param d Data to print.
  *
  * Print to \c stdout the pointer of data.
  *
- * \warning This function is just a stub and shall never be used
- * in your production project.
+ * \warning This function is just a stub and shall never be used
+ * in your production project.
+ */
+void stub__data_print(void *d)
+{
+    printf("0x%p", d);
+}
+
+/** \fn void stub__data_delete(void *d)
+ * \brief Stub function used if no data_delete function is provided.
+ *
+ * \param d Data to delete.
+ *
+ * This fonction call \c free on \c d.
+ *
+ * \warning This function is just a stub. If your data is more
+ * complicated than a single static structure, you must provide
+ * your \c data_delete implementation. If not your program will
+ * cause memory leaks on tree deletion.
+ */
+void stub__data_delete(void *d)
+{
+    free(d);
+}
+
+/** \fn void stub__data_copy(void *src, void *dst)
+ * \brief Stub function used if no data_copy function is provided.
+ *
+ * \param src Data source
+ * \param dst Data destination
+ *
+ * This function call \c memcpy to copy \c src into \c dst.
+ *
+ * \warning This function is just a stub. If your data is more complicated
+ * than a single static structure, you must provide your \c data_copy
+ * implementation.
+ */
+void stub__data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(src));
+}
+
+/* ************************************************************************* *\
+|*                      EXTERNAL FUNCTION                                    *|
+\* ************************************************************************* */
+
+/** \fn tree *init_dictionnary(int (*data_cmp)(void *, void *),
+ *                             void (*data_print)(void *),
+ *                             void (*data_delete)(void *),
+ *                             void *(*data_copy)(void *));
+ * \brief Initialize dictionnary.
+ *
+ * \return Pointer to new tree.
+ *
+ * \param data_cmp Function to compare data.
+ * \param data_print Function to print data.
+ * \param data_delete Function to delete data.
+ * \param data_copy Function to copy data.
+ *
+ * This function return an initilized tree.
+ *
+ * \note By default, if you do not provide function usefull to the tree,
+ * the LibAVL library uses its own function. As LibAVL does not know exactly
+ * the structure and the definition of your data, result can not be as good
+ * as expected. Details on these functions are given in the following.
+ *
+ * \section LibAVL internal data function
+ *
+ *    - Compare function: by default, the internal \c data_cmp function will
+ *      return the difference between the two pointer given in arguments
+ *
+ *          return (int) ((ptrdiff_t) a - (ptrdiff_t) b);
+ *
+ *      The \c data_cmp function is really critical and guarantee efficiency of
+ *      LibAVL.
+ *    - Print function: by default, the internal \c data_print function will
+ *      print the addresse contained in pointer in argument, in hexadecimal
+ *
+ *          printf("0x%08x\n", d);
+ *
+ *      Since \c data_print is mainly used as debug function to dump a complete
+ *      tree, it is not the most important data function, but with the correct
+ *      implementation, it could save lots of time and money when something
+ *      went wrong.
+ *    - Delete function: by default, the internal \c data_delete function will
+ *      call \c free on the argument pointer. If your data is only a static
+ *      structure or a simple type, this function is enough. But for bigger
+ *      object like a string array, it is necessary to provide a new
+ *      \c data_delete function to avoid memory leak.
+ *    - Copy function: by default, the internal \c data_copy function will
+ *      memcpy data.
+ */
+tree *init_dictionnary(int (*data_cmp)(void *, void *),
+                       void (*data_print)(void *),
+                       void (*data_delete)(void *),
+                       void (*data_copy)(void *, void *))
+{
+    // New tree allocation
+    tree *t = malloc(sizeof(tree));
+
+    // Initialized field
+    t->count = 0;
+    t->root = NULL;
+    t->leftmost = NULL;
+    t->rightmost = NULL;
+    t->finger = NULL;
+    t->finger_depth = 0;
+    t->finger_size = 0;
+    t->spine = NULL;
+    t->spine_depth = 0;
+    t->spine_size = 0;
+    t->tombstones = 0;
+    t->dead = 0;
+    t->dead_ratio = 0;
+    t->multimap = 0;
+    t->persistent = 0;
+    t->datasize = 0;
+    t->wavl = 0;
+    t->relaxed = 0;
+    t->rotations = 0;
+    t->key.type = KEY_CUSTOM;
+    t->key.offset = 0;
+    t->key.length = 0;
+    t->key.descending = 0;
+    t->fields = NULL;
+    t->field_count = 0;
+    t->arena = NULL;
+    t->data_cmp = data_cmp ? data_cmp : stub__data_cmp;
+    t->data_less = NULL;
+    t->data_print = data_print ? data_print : stub__data_print;
+    t->data_delete = data_delete ? data_delete : stub__data_delete;
+    t->data_copy = data_copy ? data_copy : stub__data_copy;
+    t->summary_size = 0;
+    t->summary_combine = NULL;
+    t->tag_size = 0;
+    t->tag_apply = NULL;
+    t->tag_compose = NULL;
+
+    return t;
+}
+
+/* \fn int set_augmentation(tree *t, size_t summary_size,
+ *                       void (*summary_combine)(void *, void *,
+ *                                               void *, void *));
+ * \brief Store a user defined summary of each subtree in its root node.
+ *
+ * \return 1 if augmentation is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ * \param summary_size Size of summary stored in each node.
+ * \param summary_combine Function to compute summary of a node.
+ *
+ * Summary of a node is computed again each time its height is updated, with
+ * the call:
+ *
+ *      summary_combine(summary, left_summary, data, right_summary);
+ *
+ * where \c left_summary and \c right_summary are NULL for empty subtree.
+ */
+int set_augmentation(tree *t, size_t summary_size,
+                     void (*summary_combine)(void *, void *, void *, void *))
+{
+    if (t == NULL || summary_combine == NULL || summary_size == 0)
+        return 0;
+    if (t->root != NULL) {
+        WLOG("Augmentation must be set on an empty tree");
+        return 0;
+    }
+    if (t->tombstones) {
+        WLOG("Augmentation can't be set with tombstones");
+        return 0;
+    }
+
+    t->summary_size = summary_size;
+    t->summary_combine = summary_combine;
+
+    return 1;
+}
+
+/* \fn int set_lazy_update(tree *t, size_t tag_size,
+ *                      void (*tag_apply)(void *, void *, void *),
+ *                      void (*tag_compose)(void *, void *));
+ * \brief Allow range update of data with lazy propagation of tags.
+ *
+ * \return 1 if lazy update is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ * \param tag_size Size of tag stored in each node.
+ * \param tag_apply Function to apply a tag on data and on a summary.
+ * \param tag_compose Function to add a newer tag to a pending tag.
+ *
+ * A tag describes an update of data, like "add 3 to value" or "set value
+ * to 0". It is applied with:
+ *
+ *      tag_apply(data, summary, tag);
+ *
+ * where \c summary is the summary of subtree of the updated node, or NULL
+ * if only \c data must be updated or if tree is not augmented. Then tags
+ * are merged with:
+ *
+ *      tag_compose(pending_tag, newer_tag);
+ *
+ * so that applying \c pending_tag gives the same result as applying first
+ * the older \c pending_tag and then \c newer_tag.
+ *
+ * \note A tag must never modify fields used by \c data_cmp.
+ */
+int set_lazy_update(tree *t, size_t tag_size,
+                    void (*tag_apply)(void *, void *, void *),
+                    void (*tag_compose)(void *, void *))
+{
+    if (t == NULL || tag_apply == NULL || tag_compose == NULL || tag_size == 0)
+        return 0;
+    if (t->root != NULL) {
+        WLOG("Lazy update must be set on an empty tree");
+        return 0;
+    }
+    if (t->persistent) {
+        WLOG("Lazy update can't be set on a persistent tree");
+        return 0;
+    }
+
+    t->tag_size = tag_size;
+    t->tag_apply = tag_apply;
+    t->tag_compose = tag_compose;
+
+    return 1;
+}
+
+/* \fn int insert_elmt(tree *t, void *data, size_t datasize);
+ * \brief Insert new element in tree.
+ *
+ * \return Number of element inserted in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to data to add.
+ * \param datasize Size of data to add.
+ *
+ * This function allocate a new memory space with the given size
+ * and copy object pointed by \c data to the newly created space.
+ *
+ * Data greater than the maximum element of tree is appended at the end
+ * of tree, with only one comparison. Other data is compared once with
+ * each node of its path, which is kept to rebalance tree.
+ */
+unsigned int insert_elmt(tree *t, void *data, size_t datasize)
+{
+    node to_add = NULL;
+    node found = NULL;
+    unsigned int depth = 0;
+    int present = 0;
+    int left = 0;
+    int cmp = 1;
+
+    // check if data is after maximum, or already present
+    if (t->rightmost != NULL) {
+        if (t->data_less != NULL)
+            // equality with maximum is checked on the way down.
+            cmp = t->data_less(t->rightmost->data, data) ? -1 : 1;
+        else
+            cmp = compare_data(t, t->rightmost->data, data);
+    }
+    if (t->multimap) {
+        // equal data is inserted after the others.
+        if (cmp == 0)
+            cmp = -1;
+    } else if (cmp == 0 && !(t->rightmost->flags & NODE_DEAD)) {
+        found = t->rightmost;
+    }
+    if (   cmp >= 0 && found == NULL && t->root != NULL
+        && !t->persistent) {
+        // finger follows the path down from root, so that each node is
+        // compared once, and rebalancing climbs it back.
+        t->finger_depth = 0;
+        return insert_elmt_hint(t, data, datasize);
+    }
+    if (t->persistent && t->root != NULL && found == NULL)
+        // path is kept, so that each node is compared once.
+        found = find_path(t, cmp < 0 ? NULL : data, &depth, &left);
+    else if (cmp >= 0 && found == NULL && !t->multimap)
+        found = find_node(t, data);
+    if (found != NULL) {
+        // deleted element is stored again in its node.
+        if (found->flags & NODE_DEAD)
+            revive_node(t, found, data, datasize);
+        return t->count;
+    }
+
+    // Allocate memory for the new data and copy data.
+    to_add = alloc_node(t);
+    to_add->data = malloc(datasize);
+    store_data(t, data, to_add->data);
+
+    if (cmp < 0 && !t->persistent) {
+        // append data along right border of tree.
+        append_finger(t, to_add);
+        return ++t->count;
+    }
+
+    if (depth > 0)
+        // shared nodes of path are copied without comparing again.
+        t->root = link_path_recur(t, t->root, 0, depth, to_add, left);
+    else
+        // recursively insert data in tree.
+        present = insert_elmt_recur(t, &(t->root), to_add);
+    t->finger_depth = 0;
+    t->spine_depth = 0;
+
+    // increment counter of element if so.
+    if (!present) {
+        // A new minimum is always inserted as left son of the previous one,
+        // and rotations never move it away. Same for a new maximum.
+        if (t->leftmost == NULL)
+            t->leftmost = t->rightmost = to_add;
+        else if (t->leftmost->left == to_add)
+            t->leftmost = to_add;
+        else if (t->rightmost->right == to_add)
+            t->rightmost = to_add;
+        DLOG("New data was added.");
+        return ++t->count;
+    } else {
+        // data already present, its copy is released.
+        DLOG("Data was not added.");
+        drop_data(t, to_add);
+        free(to_add);
+        return t->count;
+    }
+}
+
+
+/* \fn void verif_tree(tree *t);
+ * \brief Deffensive check if tree is a real AVL tree.
+ *
+ * \param t Pointer to tree.
+ *
+ * If tree is not an AVL tree, this function end on an assert.
+ */
+void verif_tree(tree *t)
+{
+    node n;
+
+    if (t == NULL)
+        return;
+    if (t->root == NULL) {
+        if (t->leftmost != NULL || t->rightmost != NULL) {
+            DLOG("Extremes of empty tree are not NULL");
+            exit(-5);
+        }
+        return;
+    }
+
+    // recursively check of avl tree.
+    verif_avl(t, t->root, 0, 0, t->root->data, t->root->data);
+
+    // check kept extremes.
+    for (n = t->root; n->left != NULL; n = n->left)
+        ;
+    if (n != t->leftmost) {
+        DLOG("Error in minimum node of tree");
+        exit(-5);
+    }
+    for (n = t->root; n->right != NULL; n = n->right)
+        ;
+    if (n != t->rightmost) {
+        DLOG("Error in maximum node of tree");
+        exit(-5);
+    }
+}
+
+/* \fn void delete_tree(tree *t);
+ * \brief Deallocate all memory used by tree.
+ *
+ * \param t Pointer to tree to delete.
+ */
+void delete_tree(tree *t)
+{
+    struct _arena *arena;
+
+    if (t == NULL)
+        return;
+
+    // strings of an arena used by tree only are freed all at once.
+    arena = t->arena;
+    if (arena != NULL && arena->refs == 1)
+        t->arena = NULL;
+    delete_tree_recur(t, t->root);
+    free(t->finger);
+    free(t->spine);
+    free(t->fields);
+    release_arena(arena);
+    free(t);
+}
+
+/* \fn void print_tree(tree *t);
+ * \brief Use for debug only. Print all element in tree with function
+ * \c data_print.
+ *
+ * \param t Pointer to tree.
+ */
+void print_tree(tree *t)
+{
+    if (t == NULL)
+        return;
+    if (t->root == NULL)
+        return;
+
+    // recursively print the tree.
+    print_tree_recur(t, t->root);
+}
+
+/* \fn void explore_tree(tree *t, void (*treatement)(void *, void *),
+ *                              void *param);
+ * \brief Execute function \c treatement on every node in tree.
+ *
+ * \param t Pointer to tree.
+ * \param treatement Function to apply to each node.
+ * \param param Pointer to extra data to pass to \c treatement function.
+ *
+ * This function goes thought the entire tree and, if \c n is the pointer
+ * to the current node, call the function:
+ *      treatement(n, param);
+ *
+ */
+void explore_tree(tree *t, void (*treatement)(void *, void *), void *param)
+{
+    if (t == NULL)
+        return;
+    if (t->root == NULL)
+        return;
+
+    // recursively explore the whole tree.
+    explore_tree_recur(t, t->root, treatement, param);
+}
+
+/* \fn explore_restrain_tree(tree *t, int (*check)(void *, void *),
+ *                              void *param,
+ *                              void *data_min, void *data_max);
+ * \brief Execute function \c check on every node between \c data_min and
+ * \c data_max.
+ *
+ * \return Accumulation of all return value of \c check function.
+ * \param t Pointer to tree.
+ * \param check Function apply on every node between \c data_min and
+ * \c data_max
+ * \param param Pointer to extra data to pass to \c check function.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ *
+ * This function goes thought a part of tree bounded with \c data_min and
+ * \c data_max, and if \c n is the pointer to the current node, it calls
+ * the function:
+ *
+ *      accu += check(n, param);
+ *
+ * The value of \c accu is returned by \c explore_restrain_tree.
+ *
+ * Only nodes on the paths to \c data_min and \c data_max are compared
+ * to bounds.
+ */
+int explore_restrain_tree(tree *t, int (*check)(void *, void *), void *param,
+        void *data_min, void *data_max)
+{
+    if (t == NULL)
+        return 0;
+    if (t->root == NULL)
+        return 0;
+
+    // recursively explore part of tree.
+    return explore_restrain_tree_recur(t, t->root, check, param,
+                                       data_min, data_max);
+}
+
+/* \fn int is_present(tree *t, void *d);
+ * \brief Function to check if a given data is present in tree.
+ *
+ * \return 1 if data is present, 0 if not.
+ * \param t Pointer to tree.
+ * \param d Pointer to data. Only field used in \c data_cmp need
+ * to be filled in \c d.
+ */
+int is_present(tree *t, void *d)
+{
+    node n;
+
+    if (t == NULL)
+        return 0;
+
+    if (IS_SEARCH_KEY(t)) {
+        n = search_key(t, d);
+        return n != NULL && !(n->flags & NODE_DEAD);
+    }
+    if (t->data_less != NULL) {
+        n = search_less(t, d);
+        return n != NULL && !(n->flags & NODE_DEAD);
+    }
+
+    // Return result of a recursive exploration
+    return is_present_recur(t, t->root, d);
+}
+
+/* \fn void delete_node_min(tree *t);
+ * \brief Delete minimum element of a tree.
+ *
+ * \param t Tree where minimum element will be deleted.
+ */
+void delete_node_min(tree *t)
+{
+    node n;
+
+    if (t == NULL || t->root == NULL)
+        return;
+
+    // marked nodes are skipped by pop_min.
+    if (t->dead > 0) {
+        void *data = pop_min(t);
+
+        if (data != NULL)
+            t->data_delete(data);
+        return;
+    }
+
+    n = unlink_min(t);
+    drop_data(t, n);
+    free(n);
+    t->count--;
+}
+
+/* \fn void delete_node_max(tree *t);
+ * \brief Delete maximum element of a tree.
+ *
+ * \param t Tree where maximum element will be deleted.
+ */
+void delete_node_max(tree *t)
+{
+    void *data = pop_max(t);
+
+    if (data != NULL)
+        t->data_delete(data);
+}
+
+/* \fn void delete_node(tree *t, void *data);
+ * \brief Delete node n of tree.
+ *
+ * \param t Pointer to tree.
+ * \param data Data to delete.
+ */
+void delete_node(tree *t, void *data)
+{
+    node found = NULL;
+    node next = NULL;
+    node n;
+    int deleted;
+
+    if (t == NULL)
+        return;
+    if (t->root == NULL)
+        return;
+
+    if (t->tombstones) {
+        // only mark node, and compact tree when too many are marked.
+        n = find_node(t, data);
+        if (n == NULL || (n->flags & NODE_DEAD))
+            return;
+        n->flags |= NODE_DEAD;
+        t->count--;
+        t->dead++;
+        if (   t->dead_ratio > 0
+            && (size_t) t->dead * 100
+               > (size_t) t->dead_ratio * ((size_t) t->count + t->dead))
+            compact(t);
+        return;
+    }
+    // explore tree recursively to delete node
+    if (t->data_less != NULL)
+        deleted = delete_less_recur(t, &(t->root), data, NULL, &found, &next);
+    else
+        deleted = delete_node_recur(t, &(t->root), data);
+    if (deleted) {
+        t->count--;
+        t->finger_depth = 0;
+        t->spine_depth = 0;
+    }
+}
+
+/* \fn int get_data(tree *t, void *data, size_t data_size);
+ * \brief Fill information pointed by data with the data stored in the tree.
+ *
+ * \return True if value pointed by data are relevant, false if not.
+ *
+ * \param t Pointer to tree.
+ * \param data Data to retrieve. At the begining of the function, only
+ * field used in \c avl_data_cmp must be filled.
+ * \param data_size Size of data structure pointed by data.
+ */
+int get_data(tree *t, void *data, size_t data_size)
+{
+    node n;
+
+    if (t == NULL)
+        return 0;
+    if (t->root == NULL)
+        return 0;
+
+    if ((IS_SEARCH_KEY(t) || t->data_less != NULL) && !t->multimap) {
+        n = find_node(t, data);
+        if (n == NULL || (n->flags & NODE_DEAD))
+            return 0;
+        memcpy(data, n->data, data_size);
+        return 1;
+    }
+
+    return get_data_recur(t, t->root, data, data_size);
+}
+
+/* \fn int aggregate_range(tree *t, void *data_min, void *data_max,
+ *                         void *summary);
+ * \brief Combine summaries of all elements between \c data_min and
+ * \c data_max.
+ *
+ * \return 1 if there is at least one element in range, 0 if not.
+ * \param t Pointer to an augmented tree.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param summary Pointer to memory filled with the resulting summary.
+ *
+ * This function only combines summaries along the two boundary paths of
+ * range, and runs in \f$\mathcal{O}(\log n)\f$.
+ */
+int aggregate_range(tree *t, void *data_min, void *data_max, void *summary)
+{
+    char *buffer;
+    void *result;
+
+    if (t == NULL || t->root == NULL || t->summary_combine == NULL)
+        return 0;
+
+    buffer = malloc(2 * (t->root->height + 1) * t->summary_size);
+    result = aggregate_range_recur(t, t->root, data_min, data_max, buffer);
+    if (result != NULL)
+        memcpy(summary, result, t->summary_size);
+    free(buffer);
+
+    return result != NULL;
+}
+
+/* \fn void update_range(tree *t, void *data_min, void *data_max, void *tag);
+ * \brief Apply \c tag to all elements between \c data_min and \c data_max.
+ *
+ * \param t Pointer to tree with lazy update.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param tag Pointer to tag to apply.
+ *
+ * Only the nodes of the two boundary paths of range are updated at once,
+ * so this function runs in \f$\mathcal{O}(\log n)\f$. Other nodes are
+ * updated on their next visit.
+ */
+void update_range(tree *t, void *data_min, void *data_max, void *tag)
+{
+    if (t == NULL || t->root == NULL || t->tag_apply == NULL)
+        return;
+
+    update_range_recur(t, t->root, data_min, data_max, tag);
+    // nodes of finger may have pending tags now.
+    t->finger_depth = 0;
+}
+
+/* \fn unsigned int build_from_iterator(tree *t, void *(*next)(void *),
+ *                                      void *param, unsigned int count,
+ *                                      size_t datasize);
+ * \brief Fill an empty tree with sorted data given by an iterator.
+ *
+ * \return Number of element in tree.
+ * \param t Pointer to an empty tree.
+ * \param next Function which gives a pointer to the next data.
+ * \param param Pointer to extra data to pass to \c next function.
+ * \param count Number of data given by \c next.
+ * \param datasize Size of each data.
+ *
+ * The function \c next is called exactly \c count times with:
+ *
+ *      d = next(param);
+ *
+ * and each \c d is copied in a new node with \c data_copy. Data must be
+ * given in strictly increasing order since they are never compared. The
+ * resulting tree is perfectly balanced, and is built in
+ * \f$\mathcal{O}(n)\f$ without any rotation.
+ */
+unsigned int build_from_iterator(tree *t, void *(*next)(void *), void *param,
+                                 unsigned int count, size_t datasize)
+{
+    if (t == NULL)
+        return 0;
+    compact(t);
+    if (t->root != NULL) {
+        WLOG("Tree must be empty to be built");
+        return t->count;
+    }
+
+    t->root = build_recur(t, next, param, count, datasize);
+    update_extremes(t);
+    t->count = count;
+
+    return t->count;
+}
+
+/* \fn unsigned int build_from_sorted(tree *t, void *data,
+ *                                    unsigned int count, size_t datasize);
+ * \brief Fill an empty tree with a sorted array of data.
+ *
+ * \return Number of element in tree.
+ * \param t Pointer to an empty tree.
+ * \param data Pointer to the first element of array.
+ * \param count Number of element in array.
+ * \param datasize Size of each element of array.
+ *
+ * Elements of array must be in strictly increasing order. See
+ * \c build_from_iterator.
+ */
+unsigned int build_from_sorted(tree *t, void *data, unsigned int count,
+                               size_t datasize)
+{
+    struct _sorted_array array;
+
+    array.data = (char *) data;
+    array.datasize = datasize;
+
+    return build_from_iterator(t, next_array_data, &array, count, datasize);
+}
+
+/* \fn unsigned int join_tree(tree *t1, void *data, size_t datasize,
+ *                            tree *t2);
+ * \brief Move all elements of \c t2 and \c data into \c t1.
+ *
+ * \return Number of element in \c t1.
+ * \param t1 Tree with all elements smaller than \c data.
+ * \param data Pointer to data to add, NULL to only join both trees.
+ * \param datasize Size of data to add.
+ * \param t2 Tree with all elements greater than \c data.
+ *
+ * Elements of \c t2 must all be greater than elements of \c t1. Nodes of
+ * \c t2 are moved into \c t1 without any allocation, in
+ * \f$\mathcal{O}(\log n)\f$, and \c t2 is left empty.
+ */
+unsigned int join_tree(tree *t1, void *data, size_t datasize, tree *t2)
+{
+    node middle;
+
+    if (t1 == NULL)
+        return 0;
+    if (!compatible_trees(t1, t2))
+        return t1->count;
+    share_arena(t1, t2);
+    compact(t1);
+    compact(t2);
+
+    if (data != NULL) {
+        middle = alloc_node(t1);
+        middle->data = malloc(datasize);
+        store_data(t1, data, middle->data);
+        t1->root = join_recur(t1, t1->root, middle, t2->root);
+        t1->count++;
+    } else {
+        t1->root = join2_recur(t1, t1->root, t2->root);
+    }
+    t1->count += t2->count;
+
+    t2->root = NULL;
+    t2->count = 0;
+    update_extremes(t1);
+    update_extremes(t2);
+
+    return t1->count;
+}
+
+/* \fn int split_tree(tree *t, void *data, tree *greater, void **found);
+ * \brief Move all elements of \c t greater than \c data into \c greater.
+ *
+ * \return 1 if an element equal to \c data was in \c t, 0 if not.
+ * \param t Tree to split, keeps all elements smaller than \c data.
+ * \param data Data used to split tree.
+ * \param greater Empty tree which receives elements greater than \c data.
+ * \param found Filled with the element equal to \c data, if any. If
+ * \c found is NULL, this element is deleted.
+ *
+ * When the element equal to \c data is given back with \c found, it is
+ * not in tree anymore and you must delete it yourself.
+ *
+ * Nodes are moved without any allocation. The split itself costs
+ * \f$\mathcal{O}(\log n)\f$, and counting elements of both trees costs
+ * \f$\mathcal{O}(\min(|t|, |greater|))\f$.
+ */
+int split_tree(tree *t, void *data, tree *greater, void **found)
+{
+    node lower;
+    node equal = NULL;
+    unsigned int count;
+    int smallest;
+
+    if (t == NULL || !compatible_trees(t, greater))
+        return 0;
+    compact(greater);
+    if (greater->root != NULL) {
+        WLOG("Tree must be empty to receive split elements");
+        return 0;
+    }
+    share_arena(t, greater);
+    compact(t);
+
+    if (t->multimap)
+        split_side_recur(t, t->root, data, 0, &lower, &(greater->root));
+    else
+        split_recur(t, t->root, data, &lower, &(greater->root), &equal);
+    t->root = lower;
+    update_extremes(t);
+    update_extremes(greater);
+
+    count = count_smallest_tree(t->root, greater->root, &smallest);
+    if (equal != NULL)
+        t->count--;
+    if (smallest == 0) {
+        greater->count = t->count - count;
+        t->count = count;
+    } else {
+        greater->count = count;
+        t->count -= count;
+    }
+
+    if (equal == NULL)
+        return 0;
+
+    if (found != NULL)
+        *found = take_data(t, equal);
+    else
+        drop_data(t, equal);
+    free(equal);
+
+    return 1;
+}
+
+/* \fn unsigned int union_tree(tree *t1, tree *t2);
+ * \brief Move all elements of \c t2 into \c t1.
+ *
+ * \return Number of element in \c t1.
+ * \param t1 Tree which receives the union of both trees.
+ * \param t2 Tree which is emptied.
+ *
+ * When an element is in both trees, the one of \c t1 is kept. Nodes are
+ * moved without any allocation, in
+ * \f$\mathcal{O}(m \log(\frac{n}{m} + 1))\f$ where \e m is the size of
+ * the smallest tree.
+ */
+unsigned int union_tree(tree *t1, tree *t2)
+{
+    unsigned int common = 0;
+
+    if (t1 == NULL)
+        return 0;
+    if (!compatible_trees(t1, t2))
+        return t1->count;
+    if (t1->multimap) {
+        WLOG("Set operations need unique elements");
+        return t1->count;
+    }
+    share_arena(t1, t2);
+    compact(t1);
+    compact(t2);
+
+    t1->root = union_recur(t1, t2, t1->root, t2->root, &common);
+    t1->count += t2->count - common;
+    t2->root = NULL;
+    t2->count = 0;
+    update_extremes(t1);
+    update_extremes(t2);
+
+    return t1->count;
+}
+
+/* \fn unsigned int intersection_tree(tree *t1, tree *t2);
+ * \brief Keep in \c t1 only elements which are in \c t2 too.
+ *
+ * \return Number of element in \c t1.
+ * \param t1 Tree which receives the intersection of both trees.
+ * \param t2 Tree which is emptied.
+ *
+ * Elements of \c t1 are kept and all elements of \c t2 are deleted. See
+ * \c union_tree for complexity.
+ */
+unsigned int intersection_tree(tree *t1, tree *t2)
+{
+    unsigned int removed = 0;
+
+    if (t1 == NULL)
+        return 0;
+    if (!compatible_trees(t1, t2))
+        return t1->count;
+    if (t1->multimap) {
+        WLOG("Set operations need unique elements");
+        return t1->count;
+    }
+    share_arena(t1, t2);
+    compact(t1);
+    compact(t2);
+
+    t1->root = intersection_recur(t1, t2, t1->root, t2->root, &removed);
+    t1->count -= removed;
+    t2->root = NULL;
+    t2->count = 0;
+    update_extremes(t1);
+    update_extremes(t2);
+
+    return t1->count;
+}
+
+/* \fn unsigned int difference_tree(tree *t1, tree *t2);
+ * \brief Delete from \c t1 all elements which are in \c t2.
+ *
+ * \return Number of element in \c t1.
+ * \param t1 Tree which receives the difference of both trees.
+ * \param t2 Tree which is emptied.
+ *
+ * All elements of \c t2 are deleted. See \c union_tree for complexity.
+ */
+unsigned int difference_tree(tree *t1, tree *t2)
+{
+    unsigned int removed = 0;
+
+    if (t1 == NULL)
+        return 0;
+    if (!compatible_trees(t1, t2))
+        return t1->count;
+    if (t1->multimap) {
+        WLOG("Set operations need unique elements");
+        return t1->count;
+    }
+    share_arena(t1, t2);
+    compact(t1);
+    compact(t2);
+
+    t1->root = difference_recur(t1, t2, t1->root, t2->root, &removed);
+    t1->count -= removed;
+    t2->root = NULL;
+    t2->count = 0;
+    update_extremes(t1);
+    update_extremes(t2);
+
+    return t1->count;
+}
+
+/* \fn unsigned int insert_batch(tree *t, void *data, unsigned int count,
+ *                               size_t datasize, int *inserted);
+ * \brief Insert an array of data, in any order.
+ *
+ * \return Number of element in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to the first data of array.
+ * \param count Number of data in array.
+ * \param datasize Size of each data.
+ * \param inserted Array of \c count integers, filled with 1 for each
+ * inserted data and 0 for each data already in tree or already in array.
+ * Can be NULL.
+ *
+ * Batch is sorted first. Then a small batch is inserted in
+ * \f$\mathcal{O}(m \log(\frac{n}{m} + 1))\f$ by splitting it along
+ * the tree, and a batch bigger than \c 1/BATCH_MERGE_RATIO of tree is
+ * merged with all elements of tree to rebuild it in
+ * \f$\mathcal{O}(n + m)\f$. In both case, tree is only browsed once.
  */
-void stub__data_print(void *d)
+unsigned int insert_batch(tree *t, void *data, unsigned int count,
+                          size_t datasize, int *inserted)
 {
-    printf("0x%p", d);
+    struct _batch batch;
+    char **items;
+    char **buffer;
+    unsigned int unique = 0;
+    unsigned int i;
+
+    if (t == NULL)
+        return 0;
+    if (count == 0)
+        return t->count;
+    compact(t);
+
+    items = malloc(count * sizeof(char *));
+    buffer = malloc(count * sizeof(char *));
+    for (i = 0; i < count; i++) {
+        items[i] = (char *) data + i * datasize;
+        if (inserted != NULL)
+            inserted[i] = 1;
+    }
+
+    batch.data = (char *) data;
+    batch.datasize = datasize;
+    batch.inserted = inserted;
+    batch.added = 0;
+
+    // sort batch and keep only the first of equal data.
+    sort_batch(t, items, buffer, count);
+    for (i = 0; i < count; i++) {
+        if (   !t->multimap && unique > 0
+            && compare_data(t, items[unique - 1], items[i]) == 0)
+            reject_batch_data(&batch, items[i]);
+        else
+            items[unique++] = items[i];
+    }
+
+    if (unique >= t->count / BATCH_MERGE_RATIO)
+        t->root = merge_sorted(t, items, unique, &batch);
+    else
+        t->root = insert_sorted_recur(t, t->root, items, unique, &batch);
+    t->count += batch.added;
+    update_extremes(t);
+
+    free(items);
+    free(buffer);
+
+    return t->count;
 }
 
-/** \fn void stub__data_delete(void *d)
- * \brief Stub function used if no data_delete function is provided.
+/* \fn unsigned int lookup_batch(tree *t, void *data, unsigned int count,
+ *                               size_t datasize, void **found);
+ * \brief Look for an array of data in tree.
  *
- * \param d Data to delete.
+ * \return Number of data found in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to the first data to look for. Only fields used in
+ * \c data_cmp need to be filled.
+ * \param count Number of data in array.
+ * \param datasize Size of each data in array.
+ * \param found Array of \c count pointers, filled with pointer to data
+ * stored in tree, or NULL if data is not found.
  *
- * This fonction call \c free on \c d.
+ * Lookups are run by groups of \c LOOKUP_GROUP. Each lookup of a group
+ * goes down one level in turn, and asks the processor to load the next
+ * node and then its data before it is really needed. So cache misses of
+ * the whole group are waited for at the same time instead of one after
+ * the other, which is much faster for trees bigger than cache.
  *
- * \warning This function is just a stub. If your data is more
- * complicated than a single static structure, you must provide
- * your \c data_delete implementation. If not your program will
- * cause memory leaks on tree deletion.
+ * \note Pointers given back in \c found remain valid until the next
+ * modification of tree.
  */
-void stub__data_delete(void *d)
+unsigned int lookup_batch(tree *t, void *data, unsigned int count,
+                          size_t datasize, void **found)
 {
-    free(d);
+    node current[LOOKUP_GROUP];
+    int loaded[LOOKUP_GROUP];
+    unsigned int result = 0;
+    unsigned int first;
+
+    if (t == NULL)
+        return 0;
+
+    for (first = 0; first < count; first += LOOKUP_GROUP) {
+        unsigned int size = count - first;
+        unsigned int active;
+        unsigned int i;
+
+        if (size > LOOKUP_GROUP)
+            size = LOOKUP_GROUP;
+
+        // start all lookups of group from root.
+        for (i = 0; i < size; i++) {
+            current[i] = t->root;
+            loaded[i] = 0;
+            found[first + i] = NULL;
+        }
+        if (t->root != NULL)
+            PREFETCH(t->root);
+        active = t->root != NULL ? size : 0;
+
+        while (active > 0) {
+            for (i = 0; i < size; i++) {
+                node n = current[i];
+                void *key = (char *) data + (first + i) * datasize;
+                int cmp;
+
+                if (n == NULL)
+                    continue;
+
+                if (!loaded[i]) {
+                    // node is (nearly) in cache, load its data.
+                    PREFETCH(n->data);
+                    loaded[i] = 1;
+                    continue;
+                }
+
+                push_tag(t, n);
+                cmp = compare_data(t, n->data, key);
+                if (cmp == 0) {
+                    if (!(n->flags & NODE_DEAD)) {
+                        found[first + i] = n->data;
+                        result++;
+                    }
+                    n = NULL;
+                } else if (cmp > 0) {
+                    n = n->left;
+                } else {
+                    n = n->right;
+                }
+
+                if (n != NULL)
+                    PREFETCH(n);
+                else
+                    active--;
+                current[i] = n;
+                loaded[i] = 0;
+            }
+        }
+    }
+
+    return result;
 }
 
-/** \fn void stub__data_copy(void *src, void *dst)
- * \brief Stub function used if no data_copy function is provided.
+/* \fn unsigned int lookup_sorted_batch(tree *t, void *data,
+ *                                      unsigned int count, size_t datasize,
+ *                                      void **found);
+ * \brief Look for a sorted array of data in tree.
  *
- * \param src Data source
- * \param dst Data destination
+ * \return Number of data found in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to the first data to look for. Data must be sorted in
+ * increasing order according to \c data_cmp.
+ * \param count Number of data in array.
+ * \param datasize Size of each data in array.
+ * \param found Array of \c count pointers, filled with pointer to data
+ * stored in tree, or NULL if data is not found.
  *
- * This function call \c memcpy to copy \c src into \c dst.
+ * Path of last lookup is kept in a stack. For each node of path, \c bound
+ * is the index of its nearest ancestor whose left subtree holds it. The
+ * data of this ancestor is greater than the whole subtree of node. Next
+ * lookup climbs from bound to bound while the data looked for is not
+ * smaller, then goes down again from there. So close data share the
+ * beginning of their path and the whole batch costs
+ * \f$\mathcal{O}(m \log(n/m + 1))\f$ comparisons for \f$m\f$ data.
+ */
+unsigned int lookup_sorted_batch(tree *t, void *data, unsigned int count,
+                                 size_t datasize, void **found)
+{
+    node *path;
+    int *bound;
+    int depth = 0;
+    unsigned int result = 0;
+    unsigned int i;
+
+    if (t == NULL)
+        return 0;
+    if (t->root == NULL) {
+        for (i = 0; i < count; i++)
+            found[i] = NULL;
+        return 0;
+    }
+
+    path = malloc((height_tree(t->root) + 1) * sizeof(node));
+    bound = malloc((height_tree(t->root) + 1) * sizeof(int));
+    path[0] = t->root;
+    bound[0] = -1;
+    depth = 1;
+
+    for (i = 0; i < count; i++) {
+        void *key = (char *) data + i * datasize;
+        node n;
+        int cmp = 1;
+
+        found[i] = NULL;
+
+        // climb while data is not in subtree of top of path.
+        while (bound[depth - 1] >= 0) {
+            int up = bound[depth - 1];
+
+            cmp = compare_data(t, path[up]->data, key);
+            if (cmp > 0)
+                break;
+            depth = up + 1;
+            if (cmp == 0)
+                break;
+        }
+        if (cmp == 0) {
+            if (!(path[depth - 1]->flags & NODE_DEAD)) {
+                found[i] = path[depth - 1]->data;
+                result++;
+            }
+            continue;
+        }
+
+        // go down from top of path.
+        n = path[depth - 1];
+        for (;;) {
+            node next;
+
+            push_tag(t, n);
+            cmp = compare_data(t, n->data, key);
+            if (cmp == 0) {
+                if (!(n->flags & NODE_DEAD)) {
+                    found[i] = n->data;
+                    result++;
+                }
+                break;
+            }
+            next = cmp > 0 ? n->left : n->right;
+            if (next == NULL)
+                break;
+            bound[depth] = cmp > 0 ? depth - 1 : bound[depth - 1];
+            path[depth++] = next;
+            n = next;
+        }
+    }
+
+    free(path);
+    free(bound);
+
+    return result;
+}
+
+/* \fn unsigned int delete_range(tree *t, void *data_min, void *data_max,
+ *                               void (*removed)(void *, void *),
+ *                               void *param);
+ * \brief Delete all elements between \c data_min and \c data_max.
  *
- * \warning This function is just a stub. If your data is more complicated
- * than a single static structure, you must provide your \c data_copy
- * implementation.
+ * \return Number of deleted elements.
+ * \param t Pointer to tree.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param removed Function which receives each deleted data, in increasing
+ * order, and must free it. If NULL, \c data_delete is used.
+ * \param param Pointer to extra data to pass to \c removed function.
+ *
+ * Tree is split around \c data_min and then around \c data_max. Middle
+ * part is deleted, and both other parts are joined back. So tree is only
+ * rebalanced along a few paths, and the whole function costs
+ * \f$\mathcal{O}(\log n + k)\f$ for \f$k\f$ deleted elements.
  */
-void stub__data_copy(void *src, void *dst)
+unsigned int delete_range(tree *t, void *data_min, void *data_max,
+                          void (*removed)(void *, void *), void *param)
 {
-    memcpy(dst, src, sizeof(src));
+    node lower = NULL;
+    node middle;
+    node greater = NULL;
+    unsigned int count;
+
+    if (t == NULL || t->root == NULL)
+        return 0;
+    if (   data_min != NULL && data_max != NULL
+        && compare_data(t, data_min, data_max) > 0)
+        return 0;
+
+    // data equal to bounds stay in middle tree.
+    middle = t->root;
+    if (data_min != NULL)
+        split_side_recur(t, middle, data_min, 0, &lower, &middle);
+    if (data_max != NULL)
+        split_side_recur(t, middle, data_max, 1, &middle, &greater);
+
+    count = delete_range_recur(t, middle, removed, param);
+
+    t->root = join2_recur(t, lower, greater);
+    t->count -= count;
+    update_extremes(t);
+
+    return count;
 }
 
-/* ************************************************************************* *\
-|*                      EXTERNAL FUNCTION                                    *|
-\* ************************************************************************* */
+/* \fn void *peek_min(tree *t);
+ * \brief Give minimum element of tree, without removing it.
+ *
+ * \return Pointer to minimum data stored in tree, NULL if tree is empty.
+ * \param t Pointer to tree.
+ */
+void *peek_min(tree *t)
+{
+    node n;
 
-/** \fn tree *init_dictionnary(int (*data_cmp)(void *, void *),
- *                             void (*data_print)(void *),
- *                             void (*data_delete)(void *),
- *                             void *(*data_copy)(void *));
- * \brief Initialize dictionnary.
+    if (t == NULL || t->leftmost == NULL)
+        return NULL;
+
+    // minimum node may be marked, look for the first element.
+    if (t->dead > 0) {
+        void *data = NULL;
+
+        scan_range(t, NULL, NULL, 0, 0, keep_data, &data, NULL);
+        return data;
+    }
+
+    // pending tags of left border must reach minimum.
+    if (t->tag_apply != NULL)
+        for (n = t->root; n != t->leftmost; n = n->left)
+            push_tag(t, n);
+
+    return t->leftmost->data;
+}
+
+/* \fn void *peek_max(tree *t);
+ * \brief Give maximum element of tree, without removing it.
  *
- * \return Pointer to new tree.
+ * \return Pointer to maximum data stored in tree, NULL if tree is empty.
+ * \param t Pointer to tree.
+ */
+void *peek_max(tree *t)
+{
+    node n;
+
+    if (t == NULL || t->rightmost == NULL)
+        return NULL;
+
+    // maximum node may be marked, look for the last element.
+    if (t->dead > 0) {
+        void *data = NULL;
+
+        scan_range(t, NULL, NULL, SCAN_REVERSE, 0, keep_data, &data, NULL);
+        return data;
+    }
+
+    // pending tags of right border must reach maximum.
+    if (t->tag_apply != NULL)
+        for (n = t->root; n != t->rightmost; n = n->right)
+            push_tag(t, n);
+
+    return t->rightmost->data;
+}
+
+/* \fn void *pop_min(tree *t);
+ * \brief Remove minimum element of tree and give it back.
  *
- * \param data_cmp Function to compare data.
- * \param data_print Function to print data.
- * \param data_delete Function to delete data.
- * \param data_copy Function to copy data.
+ * \return Pointer to minimum data, NULL if tree is empty.
+ * \param t Pointer to tree.
+ */
+void *pop_min(tree *t)
+{
+    node n;
+    void *data;
+
+    if (t == NULL || t->root == NULL)
+        return NULL;
+
+    // marked nodes met on the way are released.
+    while ((n = unlink_min(t))->flags & NODE_DEAD) {
+        drop_data(t, n);
+        free(n);
+        t->dead--;
+        if (t->root == NULL)
+            return NULL;
+    }
+    data = take_data(t, n);
+    free(n);
+    t->count--;
+
+    return data;
+}
+
+/* \fn void *pop_max(tree *t);
+ * \brief Remove maximum element of tree and give it back.
  *
- * This function return an initilized tree.
+ * \return Pointer to maximum data, NULL if tree is empty.
+ * \param t Pointer to tree.
+ */
+void *pop_max(tree *t)
+{
+    node n;
+    void *data;
+
+    if (t == NULL || t->root == NULL)
+        return NULL;
+
+    // marked nodes met on the way are released.
+    t->finger_depth = 0;
+    t->spine_depth = 0;
+    while ((n = extract_node_max_recur(t, &(t->root)))->flags & NODE_DEAD) {
+        drop_data(t, n);
+        free(n);
+        t->dead--;
+        if (t->root == NULL) {
+            t->leftmost = NULL;
+            return NULL;
+        }
+    }
+    data = take_data(t, n);
+    free(n);
+    t->count--;
+    if (t->root == NULL)
+        t->leftmost = NULL;
+
+    return data;
+}
+
+/* \fn unsigned int insert_elmt_hint(tree *t, void *data, size_t datasize);
+ * \brief Insert new element in tree, starting from the previous one.
  *
- * \note By default, if you do not provide function usefull to the tree,
- * the LibAVL library uses its own function. As LibAVL does not know exactly
- * the structure and the definition of your data, result can not be as good
- * as expected. Details on these functions are given in the following.
+ * \return Number of element inserted in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to data to add.
+ * \param datasize Size of data.
  *
- * \section LibAVL internal data function
+ * Finger climbs from bound to bound while \c data is out of the subtree
+ * of its last node, as in \c lookup_sorted_batch but on both sides. Then
+ * data is looked for from there, and finger follows the path down to the
+ * new node.
+ */
+unsigned int insert_elmt_hint(tree *t, void *data, size_t datasize)
+{
+    struct _finger *f;
+    unsigned int depth;
+    unsigned int candidate = 0;
+    node to_add;
+    node n;
+    int cmp;
+
+    if (t == NULL)
+        return 0;
+    // finger would point to nodes shared with snapshots.
+    if (t->root == NULL || t->persistent)
+        return insert_elmt(t, data, datasize);
+
+    reserve_finger(t);
+    f = t->finger;
+    depth = t->finger_depth;
+
+    // climb while data is out of subtree of last node.
+    for (;;) {
+        int up = f[depth - 1].lower;
+
+        // in multimap, data equal to lower bound goes in its subtree.
+        if (up >= 0) {
+            cmp = compare_data(t, f[up].n->data, data);
+            if (cmp > 0 || (cmp == 0 && !t->multimap)) {
+                depth = (unsigned int) up + 1;
+                continue;
+            }
+        }
+        up = f[depth - 1].upper;
+        if (up >= 0 && compare_data(t, f[up].n->data, data) <= 0) {
+            depth = (unsigned int) up + 1;
+            continue;
+        }
+        break;
+    }
+
+    // go down from there.
+    for (;;) {
+        node next;
+
+        n = f[depth - 1].n;
+        push_tag(t, n);
+        if (t->data_less != NULL) {
+            // equality is only checked at the end, see set_less_than.
+            cmp = t->data_less(data, n->data) ? 1 : -1;
+            if (cmp < 0)
+                candidate = depth;
+        } else {
+            cmp = compare_data(t, n->data, data);
+        }
+        if (cmp == 0 && !t->multimap) {
+            t->finger_depth = depth;
+            if (n->flags & NODE_DEAD)
+                revive_node(t, n, data, datasize);
+            return t->count;
+        }
+        next = cmp > 0 ? n->left : n->right;
+        if (next == NULL)
+            break;
+        f[depth].n = next;
+        f[depth].lower = cmp > 0 ? f[depth - 1].lower : (int) depth - 1;
+        f[depth].upper = cmp > 0 ? (int) depth - 1 : f[depth - 1].upper;
+        depth++;
+    }
+
+    if (   candidate > 0 && !t->multimap
+        && !t->data_less(f[candidate - 1].n->data, data)) {
+        n = f[candidate - 1].n;
+        t->finger_depth = candidate;
+        if (n->flags & NODE_DEAD)
+            revive_node(t, n, data, datasize);
+        return t->count;
+    }
+
+    // Allocate memory for the new data and copy data.
+    to_add = alloc_node(t);
+    to_add->data = malloc(datasize);
+    store_data(t, data, to_add->data);
+
+    t->finger_depth = depth;
+    link_finger(t, to_add, cmp);
+
+    return ++t->count;
+}
+
+/* \fn unsigned int scan_range(tree *t, void *data_min, void *data_max,
+ *                             unsigned int flags, unsigned int limit,
+ *                             int (*treatement)(void *, void *),
+ *                             void *param, void **next);
+ * \brief Execute function \c treatement on a page of elements between
+ * \c data_min and \c data_max.
  *
- *    - Compare function: by default, the internal \c data_cmp function will
- *      return the difference between the two pointer given in arguments
+ * \return Number of elements given to \c treatement.
+ * \param t Pointer to tree.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param flags Combination of \c SCAN_EXCLUDE_MIN, \c SCAN_EXCLUDE_MAX
+ * and \c SCAN_REVERSE.
+ * \param limit Maximum number of elements to scan, 0 for no limit.
+ * \param treatement Function to apply to each element, may be NULL. A non
+ * zero result stops scan.
+ * \param param Pointer to extra data to pass to \c treatement function.
+ * \param next Filled with the first element of range which was not
+ * scanned, or NULL if the whole range was scanned. May be NULL.
  *
- *          return (int) ((ptrdiff_t) a - (ptrdiff_t) b);
+ * Last node of range is found first, then the first one with its path.
+ * Scan goes from node to node with this path as a stack, and stops on
+ * last node: only the nodes of both paths are compared to bounds.
+ */
+unsigned int scan_range(tree *t, void *data_min, void *data_max,
+                        unsigned int flags, unsigned int limit,
+                        int (*treatement)(void *, void *), void *param,
+                        void **next)
+{
+    int reverse = (flags & SCAN_REVERSE) != 0;
+    void *from = reverse ? data_max : data_min;
+    void *to = reverse ? data_min : data_max;
+    int exclude_from = (flags & (reverse ? SCAN_EXCLUDE_MAX : SCAN_EXCLUDE_MIN)) != 0;
+    int exclude_to = (flags & (reverse ? SCAN_EXCLUDE_MIN : SCAN_EXCLUDE_MAX)) != 0;
+    unsigned int count = 0;
+    unsigned int size;
+    int stop = 0;
+    node *stack;
+    node last;
+    node n;
+
+    if (next != NULL)
+        *next = NULL;
+    if (t == NULL || t->root == NULL)
+        return 0;
+
+    last = scan_end(t, to, exclude_to, reverse);
+    if (last == NULL)
+        return 0;
+
+    stack = malloc((height_tree(t->root) + 1) * sizeof(node));
+    size = scan_start(t, from, exclude_from, reverse, stack);
+
+    // range is empty if its first node is after its last one.
+    if (size > 0 && from != NULL && to != NULL) {
+        int cmp = compare_data(t, stack[size - 1]->data, last->data);
+
+        if (reverse ? cmp < 0 : cmp > 0)
+            size = 0;
+    }
+
+    while (size > 0) {
+        n = stack[--size];
+        if (!(n->flags & NODE_DEAD)) {
+            if (stop || (limit > 0 && count == limit)) {
+                if (next != NULL)
+                    *next = n->data;
+                break;
+            }
+
+            count++;
+            if (treatement != NULL && treatement(n->data, param))
+                stop = 1;
+        }
+        if (n == last)
+            break;
+
+        // next nodes are in the other subtree of current node.
+        for (n = reverse ? n->left : n->right;
+             n != NULL;
+             n = reverse ? n->right : n->left) {
+            push_tag(t, n);
+            stack[size++] = n;
+        }
+    }
+
+    free(stack);
+
+    return count;
+}
+
+/* \fn unsigned int collect_range(tree *t, void *data_min, void *data_max,
+ *                                void **out, unsigned int cap,
+ *                                range_cursor *cursor);
+ * \brief Fill an array with the first elements between \c data_min and
+ * \c data_max.
  *
- *      The \c data_cmp function is really critical and guarantee efficiency of
- *      LibAVL.
- *    - Print function: by default, the internal \c data_print function will
- *      print the addresse contained in pointer in argument, in hexadecimal
+ * \return Number of elements put in \c out.
+ * \param t Pointer to tree.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param out Array filled with pointers to data, in increasing order.
+ * \param cap Number of pointers \c out can hold.
+ * \param cursor Filled with the state of range, to get next elements with
+ * \c collect_next. May be NULL.
+ *
+ * Range is found as in \c scan_range, and its stack is kept in cursor.
+ */
+unsigned int collect_range(tree *t, void *data_min, void *data_max,
+                           void **out, unsigned int cap, range_cursor *cursor)
+{
+    range_cursor c;
+    unsigned int count;
+
+    c.stack = NULL;
+    c.size = 0;
+    c.last = NULL;
+
+    if (t != NULL && t->root != NULL)
+        c.last = scan_end(t, data_max, 0, 0);
+    if (c.last != NULL) {
+        c.stack = malloc((height_tree(t->root) + 1) * sizeof(node));
+        c.size = scan_start(t, data_min, 0, 0, c.stack);
+
+        // range is empty if its first node is after its last one.
+        if (   c.size > 0 && data_min != NULL && data_max != NULL
+            && compare_data(t, c.stack[c.size - 1]->data, c.last->data) > 0)
+            c.size = 0;
+    }
+
+    count = collect_next(t, out, cap, &c);
+    if (cursor != NULL)
+        *cursor = c;
+    else
+        release_cursor(&c);
+
+    return count;
+}
+
+/* \fn unsigned int collect_next(tree *t, void **out, unsigned int cap,
+ *                               range_cursor *cursor);
+ * \brief Fill an array with the next elements of a range.
+ *
+ * \return Number of elements put in \c out, 0 when the whole range was
+ * collected.
+ * \param t Pointer to tree.
+ * \param out Array filled with pointers to data, in increasing order.
+ * \param cap Number of pointers \c out can hold.
+ * \param cursor State of range, from \c collect_range.
+ *
+ * Data of the next node is prefetched while the current one is stored,
+ * and so is the right son of the next node, which is often the following
+ * one.
+ */
+unsigned int collect_next(tree *t, void **out, unsigned int cap,
+                          range_cursor *cursor)
+{
+    unsigned int count = 0;
+    node n;
+
+    if (t == NULL || cursor == NULL || cursor->stack == NULL)
+        return 0;
+
+    while (count < cap && cursor->size > 0) {
+        n = cursor->stack[--cursor->size];
+        if (!(n->flags & NODE_DEAD))
+            out[count++] = n->data;
+        if (n == cursor->last) {
+            cursor->size = 0;
+            break;
+        }
+
+        // next nodes are in right subtree of current node.
+        for (n = n->right; n != NULL; n = n->left) {
+            push_tag(t, n);
+            cursor->stack[cursor->size++] = n;
+        }
+        if (cursor->size > 0) {
+            n = cursor->stack[cursor->size - 1];
+            PREFETCH(n->data);
+            if (n->right != NULL)
+                PREFETCH(n->right);
+        }
+    }
+
+    if (cursor->size == 0)
+        release_cursor(cursor);
+
+    return count;
+}
+
+/* \fn void release_cursor(range_cursor *cursor);
+ * \brief Release memory of a cursor before the end of its range.
  *
- *          printf("0x%08x\n", d);
+ * \param cursor Cursor to release.
+ */
+void release_cursor(range_cursor *cursor)
+{
+    if (cursor == NULL)
+        return;
+
+    free(cursor->stack);
+    cursor->stack = NULL;
+    cursor->size = 0;
+    cursor->last = NULL;
+}
+
+/* \fn int set_tombstones(tree *t, unsigned int ratio);
+ * \brief Only mark deleted elements, and remove them later.
  *
- *      Since \c data_print is mainly used as debug function to dump a complete
- *      tree, it is not the most important data function, but with the correct
- *      implementation, it could save lots of time and money when something
- *      went wrong.
- *    - Delete function: by default, the internal \c data_delete function will
- *      call \c free on the argument pointer. If your data is only a static
- *      structure or a simple type, this function is enough. But for bigger
- *      object like a string array, it is necessary to provide a new
- *      \c data_delete function to avoid memory leak.
- *    - Copy function: by default, the internal \c data_copy function will
- *      memcpy data.
+ * \return 1 if tombstones are set, 0 if not.
+ * \param t Pointer to an empty tree.
+ * \param ratio Percent of marked elements in tree which triggers
+ * \c compact, 0 to only compact explicitly.
  */
-tree *init_dictionnary(int (*data_cmp)(void *, void *),
-                       void (*data_print)(void *),
-                       void (*data_delete)(void *),
-                       void (*data_copy)(void *, void *))
+int set_tombstones(tree *t, unsigned int ratio)
 {
-    // New tree allocation
-    tree *t = malloc(sizeof(tree));
+    if (t == NULL || ratio > 100)
+        return 0;
+    if (t->root != NULL) {
+        WLOG("Tombstones must be set on an empty tree");
+        return 0;
+    }
+    if (t->summary_combine != NULL) {
+        WLOG("Tombstones can't be set on an augmented tree");
+        return 0;
+    }
+    if (t->multimap) {
+        WLOG("Tombstones can't be set on a multimap");
+        return 0;
+    }
+    if (t->persistent) {
+        WLOG("Tombstones can't be set on a persistent tree");
+        return 0;
+    }
 
-    // Initialized field
-    t->count = 0;
-    t->root = NULL;
-    t->data_cmp = data_cmp ? data_cmp : stub__data_cmp;
-    t->data_print = data_print ? data_print : stub__data_print;
-    t->data_delete = data_delete ? data_delete : stub__data_delete;
-    t->data_copy = data_copy ? data_copy : stub__data_copy;
+    t->tombstones = 1;
+    t->dead_ratio = ratio;
 
-    return t;
+    return 1;
 }
 
-/* \fn int insert_elmt(tree *t, void *data, size_t datasize);
- * \brief Insert new element in tree.
+/* \fn unsigned int compact(tree *t);
+ * \brief Remove all marked elements from tree.
  *
- * \return Number of element inserted in tree.
+ * \return Number of removed elements.
  * \param t Pointer to tree.
- * \param data Pointer to data to add.
- * \param datasize Size of data to add.
  *
- * This function allocate a new memory space with the given size
- * and copy object pointed by \c data to the newly created space.
+ * Tree is flattened, marked nodes are released, and others are linked
+ * again as in \c insert_batch.
  */
-unsigned int insert_elmt(tree *t, void *data, size_t datasize)
+unsigned int compact(tree *t)
 {
-    node to_add = NULL;
-    int present = 0;
+    node *nodes;
+    unsigned int count = 0;
+    unsigned int live = 0;
+    unsigned int removed;
+    unsigned int i;
 
-    // check if data is already present
-    if (is_present(t, data))
-        return t->count;
+    if (t == NULL || t->dead == 0)
+        return 0;
 
-    // Allocate memory for the new data and copy data.
-    to_add = malloc(sizeof(struct _node));
-    to_add->data = malloc(datasize);
-    t->data_copy(data, to_add->data);
-    to_add->height = 0;
-    to_add->left = to_add->right = NULL;
+    nodes = malloc((t->count + t->dead) * sizeof(node));
+    flatten_tree_recur(t, t->root, nodes, &count);
+    for (i = 0; i < count; i++) {
+        if (nodes[i]->flags & NODE_DEAD) {
+            drop_data(t, nodes[i]);
+            free(nodes[i]);
+        } else {
+            nodes[live++] = nodes[i];
+        }
+    }
 
-    // recursively insert data in tree.
-    present = insert_elmt_recur(&(t->root), to_add, t->data_cmp);
+    t->root = link_nodes_recur(t, nodes, live);
+    removed = t->dead;
+    t->dead = 0;
+    update_extremes(t);
+    free(nodes);
 
-    // increment counter of element if so.
-    if (!present) {
-        DLOG("New data was added.");
-        return ++t->count;
-    } else {
-        DLOG("Data was updated.");
-        return t->count;
-    }
+    return removed;
 }
 
-
-/* \fn void verif_tree(tree *t);
- * \brief Deffensive check if tree is a real AVL tree.
+/* \fn int set_multimap(tree *t);
+ * \brief Keep all equal elements in tree.
  *
- * \param t Pointer to tree.
+ * \return 1 if multimap is set, 0 if not.
+ * \param t Pointer to an empty tree.
  *
- * If tree is not an AVL tree, this function end on an assert.
+ * Equal data always goes to the right subtree, which keeps insertion
+ * order through rotations, joins and splits.
  */
-void verif_tree(tree *t)
+int set_multimap(tree *t)
 {
     if (t == NULL)
-        return;
-    if (t->root == NULL)
-        return;
+        return 0;
+    if (t->root != NULL) {
+        WLOG("Multimap must be set on an empty tree");
+        return 0;
+    }
+    if (t->tombstones) {
+        WLOG("Multimap can't be set with tombstones");
+        return 0;
+    }
 
-    // recursively check of avl tree.
-    verif_avl(t->root, 0, 0, t->root->data, t->root->data, t->data_cmp);
+    t->multimap = 1;
+
+    return 1;
 }
 
-/* \fn void delete_tree(tree *t);
- * \brief Deallocate all memory used by tree.
+/* \fn unsigned int equal_range(tree *t, void *data,
+ *                              int (*treatement)(void *, void *),
+ *                              void *param);
+ * \brief Execute function \c treatement on every element equal to
+ * \c data, in insertion order.
  *
- * \param t Pointer to tree to delete.
+ * \return Number of elements given to \c treatement.
+ * \param t Pointer to tree.
+ * \param data Pointer to data to look for.
+ * \param treatement Function to apply to each element, may be NULL. A non
+ * zero result stops scan.
+ * \param param Pointer to extra data to pass to \c treatement function.
  */
-void delete_tree(tree *t)
+unsigned int equal_range(tree *t, void *data,
+                         int (*treatement)(void *, void *), void *param)
 {
-    if (t == NULL)
-        return;
+    if (data == NULL)
+        return 0;
 
-    delete_tree_recur(t->root, t->data_delete);
-    free(t);
+    return scan_range(t, data, data, 0, 0, treatement, param, NULL);
 }
 
-/* \fn void print_tree(tree *t);
- * \brief Use for debug only. Print all element in tree with function
- * \c data_print.
+/* \fn unsigned int count_equal(tree *t, void *data);
+ * \brief Count elements equal to \c data.
  *
+ * \return Number of elements equal to \c data.
  * \param t Pointer to tree.
+ * \param data Pointer to data to look for.
  */
-void print_tree(tree *t)
+unsigned int count_equal(tree *t, void *data)
 {
-    if (t == NULL)
-        return;
-    if (t->root == NULL)
-        return;
+    return equal_range(t, data, NULL, NULL);
+}
 
-    // recursively print the tree.
-    print_tree_recur(t->root, t->data_print);
+/* \fn int set_persistent(tree *t, size_t datasize);
+ * \brief Allow snapshots of tree, with path copying.
+ *
+ * \return 1 if persistence is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ * \param datasize Size of each data stored in tree.
+ *
+ * Reference counters are stored after the summary of each node, at the
+ * place of pending tags.
+ */
+int set_persistent(tree *t, size_t datasize)
+{
+    if (t == NULL || datasize == 0)
+        return 0;
+    if (t->root != NULL) {
+        WLOG("Persistence must be set on an empty tree");
+        return 0;
+    }
+    if (t->tombstones || t->tag_apply != NULL) {
+        WLOG("Persistence can't be set with tombstones or lazy update");
+        return 0;
+    }
+
+    t->persistent = 1;
+    t->datasize = datasize;
+
+    return 1;
 }
 
-/* \fn void explore_tree(tree *t, void (*treatement)(void *, void *),
- *                              void *param);
- * \brief Execute function \c treatement on every node in tree.
+/* \fn tree *snapshot(tree *t);
+ * \brief Give a frozen version of a persistent tree.
  *
- * \param t Pointer to tree.
- * \param treatement Function to apply to each node.
- * \param param Pointer to extra data to pass to \c treatement function.
+ * \return Pointer to snapshot, NULL on error.
+ * \param t Pointer to a persistent tree.
  *
- * This function goes thought the entire tree and, if \c n is the pointer
- * to the current node, call the function:
- *      treatement(n, param);
+ * A snapshot is a clone that is only read.
+ */
+tree *snapshot(tree *t)
+{
+    return clone_tree(t);
+}
+
+/* \fn tree *clone_tree(tree *t);
+ * \brief Give a copy of a persistent tree, which can be modified.
  *
+ * \return Pointer to clone, NULL on error.
+ * \param t Pointer to a persistent tree.
  */
-void explore_tree(tree *t, void (*treatement)(void *, void *), void *param)
+tree *clone_tree(tree *t)
 {
+    tree *c;
+
     if (t == NULL)
-        return;
-    if (t->root == NULL)
-        return;
+        return NULL;
+    if (!t->persistent) {
+        WLOG("Only a persistent tree can be cloned");
+        return NULL;
+    }
 
-    // recursively explore the whole tree.
-    explore_tree_recur(t->root, treatement, param);
+    c = malloc(sizeof(tree));
+    *c = *t;
+    c->finger = NULL;
+    c->finger_depth = 0;
+    c->finger_size = 0;
+    c->spine = NULL;
+    c->spine_depth = 0;
+    c->spine_size = 0;
+    if (t->fields != NULL) {
+        c->fields = malloc(t->field_count * sizeof(key_desc));
+        memcpy(c->fields, t->fields, t->field_count * sizeof(key_desc));
+    }
+    if (t->arena != NULL)
+        t->arena->refs++;
+
+    // root is referenced by both trees.
+    if (t->root != NULL)
+        NODE_SHARE(t, t->root)->refs++;
+
+    return c;
 }
 
-/* \fn explore_restrain_tree(tree *t, int (*check)(void *, void *),
- *                              void *param,
- *                              void *data_min, void *data_max);
- * \brief Execute function \c check on every node between \c data_min and
- * \c data_max.
+/* \fn int set_wavl(tree *t);
+ * \brief Balance tree by ranks, as a weak AVL tree.
  *
- * \return Accumulation of all return value of \c check function.
- * \param t Pointer to tree.
- * \param check Function apply on every node between \c data_min and
- * \c data_max
- * \param param Pointer to extra data to pass to \c check function.
- * \param data_min Pointer to the minimum element.
- * \param data_max Pointer to the maximum element.
+ * \return 1 if rank balance is set, 0 if not.
+ * \param t Pointer to an empty tree.
  *
- * This function goes thought a part of tree bounded with \c data_min and
- * \c data_max, and if \c n is the pointer to the current node, it calls
- * the function:
+ * Height field of nodes holds rank plus one, so that rotations and
+ * promotions of an AVL tree still give a weak AVL tree. Height of a node
+ * which is not rotated is never computed again from its sons: it would
+ * demote a node whose sons are both 2 ranks lower.
+ */
+int set_wavl(tree *t)
+{
+    if (t == NULL)
+        return 0;
+    if (t->root != NULL) {
+        WLOG("Rank balance must be set on an empty tree");
+        return 0;
+    }
+    if (t->relaxed) {
+        WLOG("Rank balance can't be set on a relaxed tree");
+        return 0;
+    }
+
+    t->wavl = 1;
+
+    return 1;
+}
+
+/* \fn int set_relaxed(tree *t);
+ * \brief Defer balancing of tree to \c rebalance_step.
  *
- *      accu += check(n, param);
+ * \return 1 if relaxed balance is set, 0 if not.
+ * \param t Pointer to an empty tree.
  *
- * The value of \c accu is returned by \c explore_restrain_tree.
+ * Heights stay exact, so every function still works on a tree which is not
+ * balanced. Only \c rebalance_step balances it.
  */
-int explore_restrain_tree(tree *t, int (*check)(void *, void *), void *param,
-        void *data_min, void *data_max)
+int set_relaxed(tree *t)
 {
     if (t == NULL)
         return 0;
-    if (t->root == NULL)
+    if (t->root != NULL) {
+        WLOG("Relaxed balance must be set on an empty tree");
+        return 0;
+    }
+    if (t->wavl) {
+        WLOG("Relaxed balance can't be set on a rank balanced tree");
         return 0;
+    }
 
-    // recursively explore part of tree.
-    return explore_restrain_tree_recur(t->root, check, param,
-                                       data_min, data_max,
-                                       t->data_cmp);
+    t->relaxed = 1;
+
+    return 1;
 }
 
-/* \fn int is_present(tree *t, void *d);
- * \brief Function to check if a given data is present in tree.
+/* \fn unsigned int rebalance_step(tree *t, unsigned int budget);
+ * \brief Balance some nodes of a relaxed tree.
  *
- * \return 1 if data is present, 0 if not.
- * \param t Pointer to tree.
- * \param d Pointer to data. Only field used in \c data_cmp need
- * to be filled in \c d.
+ * \return Number of balanced nodes.
+ * \param t Pointer to a relaxed tree.
+ * \param budget Maximum number of nodes to balance, 0 for no limit.
  */
-int is_present(tree *t, void *d)
+unsigned int rebalance_step(tree *t, unsigned int budget)
 {
-    if (t == NULL)
+    unsigned int left = budget;
+
+    if (t == NULL || !t->relaxed)
         return 0;
+    if (budget == 0)
+        left = UINT_MAX;
 
-    // Return result of a recursive exploration
-    return is_present_recur(t->root, d, t->data_cmp);
+    t->root = rebalance_recur(t, t->root, &left);
+    t->finger_depth = 0;
+    t->spine_depth = 0;
+
+    return (budget == 0 ? UINT_MAX : budget) - left;
 }
 
-/* \fn void delete_node_min(tree *t);
- * \brief Delete minimum element of a tree.
+/* \fn tree *init_key_dictionnary(const key_desc *key,
+ *                                 void (*data_print)(void *),
+ *                                 void (*data_delete)(void *),
+ *                                 void (*data_copy)(void *, void *));
+ * \brief Initialize dictionnary whose data is ordered by a typed key.
  *
- * \param t Tree where minimum element will be deleted.
+ * \return Pointer to new tree, NULL if key is not valid.
+ * \param key Type, offset and length of key in each data.
+ * \param data_print Function to print data.
+ * \param data_delete Function to delete data.
+ * \param data_copy Function to copy data.
  */
-void delete_node_min(tree *t)
+tree *init_key_dictionnary(const key_desc *key,
+                           void (*data_print)(void *),
+                           void (*data_delete)(void *),
+                           void (*data_copy)(void *, void *))
 {
-    if (t == NULL || t->root == NULL)
-        return;
+    tree *t;
 
-    // go recursively in tree to delete minimum node
-    if (delete_node_min_recur(&(t->root), t->data_delete))
-        t->count--;
+    if (key == NULL || !valid_key(key)) {
+        WLOG("Key is not valid");
+        return NULL;
+    }
+
+    t = init_dictionnary(NULL, data_print, data_delete, data_copy);
+    t->key = *key;
+    t->data_cmp = NULL;
+    if (key->type == KEY_CSTRING) {
+        t->arena = malloc(sizeof(struct _arena));
+        memset(t->arena, 0, sizeof(struct _arena));
+        t->arena->refs = 1;
+    }
+
+    return t;
 }
 
-/* \fn void delete_node(tree *t, void *data);
- * \brief Delete node n of tree.
+/* \fn tree *init_composite_dictionnary(const key_desc *fields,
+ *                                       unsigned int count,
+ *                                       void (*data_print)(void *),
+ *                                       void (*data_delete)(void *),
+ *                                       void (*data_copy)(void *, void *));
+ * \brief Initialize dictionnary whose data is ordered by several fields.
  *
- * \param t Pointer to tree.
- * \param data Data to delete.
+ * \return Pointer to new tree, NULL if a field is not valid.
+ * \param fields Description of each field, from the most significant one.
+ * \param count Number of fields.
+ * \param data_print Function to print data.
+ * \param data_delete Function to delete data.
+ * \param data_copy Function to copy data.
  */
-void delete_node(tree *t, void *data)
+tree *init_composite_dictionnary(const key_desc *fields, unsigned int count,
+                                 void (*data_print)(void *),
+                                 void (*data_delete)(void *),
+                                 void (*data_copy)(void *, void *))
 {
-    if (t == NULL)
-        return;
-    if (t->root == NULL)
-        return;
-    // explore tree recursively to delete node
-    if (delete_node_recur(&(t->root), data, t->data_cmp, t->data_delete))
-        t->count--;
+    tree *t;
+    unsigned int i;
+
+    if (fields == NULL || count == 0)
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (!valid_key(&fields[i]) || fields[i].type == KEY_CSTRING) {
+            WLOG("Field %u is not valid", i);
+            return NULL;
+        }
+    }
+
+    t = init_dictionnary(NULL, data_print, data_delete, data_copy);
+    t->key.type = KEY_COMPOSITE;
+    t->data_cmp = NULL;
+    t->fields = malloc(count * sizeof(key_desc));
+    memcpy(t->fields, fields, count * sizeof(key_desc));
+    t->field_count = count;
+
+    return t;
 }
 
-/* \fn int get_data(tree *t, void *data, size_t data_size);
- * \brief Fill information pointed by data with the data stored in the tree.
+/* \fn unsigned int scan_fields(tree *t, void *data, unsigned int count,
+ *                              int (*treatement)(void *, void *),
+ *                              void *param);
+ * \brief Execute function \c treatement on every element whose first
+ * fields are equal to the ones of \c data.
  *
- * \return True if value pointed by data are relevant, false if not.
+ * \return Number of elements given to \c treatement.
+ * \param t Pointer to a tree with a composite key.
+ * \param data Pointer to data, only its first \c count fields are used.
+ * \param count Number of fields to compare.
+ * \param treatement Function to apply to each element, may be NULL. A non
+ * zero result stops scan.
+ * \param param Pointer to extra data to pass to \c treatement function.
+ */
+unsigned int scan_fields(tree *t, void *data, unsigned int count,
+                         int (*treatement)(void *, void *), void *param)
+{
+    tree prefix;
+
+    if (t == NULL || data == NULL || count == 0)
+        return 0;
+    if (t->key.type != KEY_COMPOSITE || count > t->field_count) {
+        WLOG("Tree has not %u fields", count);
+        return 0;
+    }
+
+    // ordering by first fields only is coarser than tree order, so a copy
+    // of tree which only compares them finds the range as equal elements.
+    prefix = *t;
+    prefix.field_count = count;
+
+    return scan_range(&prefix, data, data, 0, 0, treatement, param, NULL);
+}
+
+/* \fn unsigned int scan_prefix(tree *t, const char *prefix,
+ *                              int (*treatement)(void *, void *),
+ *                              void *param);
+ * \brief Execute function \c treatement on every element whose string key
+ * starts with \c prefix.
  *
- * \param t Pointer to tree.
- * \param data Data to retrieve. At the begining of the function, only
- * field used in \c avl_data_cmp must be filled.
- * \param data_size Size of data structure pointed by data.
+ * \return Number of elements given to \c treatement.
+ * \param t Pointer to a tree with a \c KEY_CSTRING key.
+ * \param prefix Null terminated prefix of keys to scan.
+ * \param treatement Function to apply to each element, may be NULL. A non
+ * zero result stops scan.
+ * \param param Pointer to extra data to pass to \c treatement function.
  */
-int get_data(tree *t, void *data, size_t data_size)
+unsigned int scan_prefix(tree *t, const char *prefix,
+                         int (*treatement)(void *, void *), void *param)
 {
-    if (t == NULL)
+    tree bounded;
+    char *probe;
+    unsigned int count;
+
+    if (t == NULL || prefix == NULL)
         return 0;
-    if (t->root == NULL)
+    if (t->key.type != KEY_CSTRING) {
+        WLOG("Tree has no string key");
         return 0;
+    }
+    if (*prefix == '\0')
+        return scan_range(t, NULL, NULL, 0, 0, treatement, param, NULL);
+
+    // ordering by first characters only is coarser than tree order, so a
+    // copy of tree which only compares them finds the range as equal
+    // elements.
+    bounded = *t;
+    bounded.key.length = strlen(prefix);
+    probe = malloc(t->key.offset + sizeof(prefix));
+    memcpy(probe + t->key.offset, &prefix, sizeof(prefix));
 
-    return get_data_recur(t->root, data, data_size, t->data_cmp);
+    count = scan_range(&bounded, probe, probe, 0, 0, treatement, param, NULL);
+    free(probe);
+
+    return count;
 }
 
+/* \fn int set_less_than(tree *t, int (*data_less)(void *, void *));
+ * \brief Order data with a less-than predicate instead of \c data_cmp.
+ *
+ * \return 1 if predicate is set, 0 if not.
+ * \param t Pointer to an empty tree ordered by a \c data_cmp function.
+ * \param data_less Predicate which gives non zero if its first data is
+ * before its second one.
+ */
+int set_less_than(tree *t, int (*data_less)(void *, void *))
+{
+    if (t == NULL || data_less == NULL)
+        return 0;
+    if (t->root != NULL) {
+        WLOG("Predicate must be set on an empty tree");
+        return 0;
+    }
+    if (t->key.type != KEY_CUSTOM) {
+        WLOG("Predicate can't be set on a tree with a typed key");
+        return 0;
+    }
+
+    t->data_less = data_less;
+
+    return 1;
+}
@@ -72,7 +72,8 @@
  *       if (!aa || !bb)
  *           return 0;
  *
- *       return aa->key - bb->key;
+ *       // Difference of keys could overflow
+ *       return (aa->key > bb->key) - (aa->key < bb->key);
  *   }
  *
  *   // Function that dumps data structure
@@ -149,22 +150,78 @@
  * To start a new tree, you need to init a new one with function
  * \b init_tree.
  *
+ * When data is ordered by an integer, a double or a string stored in it,
+ * \b init_key_dictionnary describes this key instead of a \c data_cmp
+ * function, and library compares keys itself. Keys made of several fields
+ * are described with \b init_composite_dictionnary, and elements sharing
+ * their first fields are found with \b scan_fields. Strings of any length,
+ * such as paths or URLs, are \c KEY_CSTRING keys, and elements starting
+ * with a prefix are found with \b scan_prefix.
+ *
  * \subsection Manage data
  *
  * The libavl provide all necessary function to store, retrieve and
  * browse your data. The following set gives basic operation:
  *  * \b insert_elmt
+ *  * \b insert_batch
+ *  * \b insert_elmt_hint
  *  * \b is_present
  *  * \b get_data
+ *  * \b lookup_batch
+ *  * \b lookup_sorted_batch
  *  * \b delete_node
  *  * \b delete_node_min
+ *  * \b delete_node_max
+ *  * \b delete_range
+ *
+ * Both ends of tree are kept, so a tree is also a priority queue with:
+ *  * \b peek_min and \b peek_max
+ *  * \b pop_min and \b pop_max
+ *
+ * A tree can also be filled at once with sorted data, without any
+ * comparison, with \b build_from_sorted or \b build_from_iterator.
+ *
+ * Whole trees are combined, without any allocation, with:
+ *  * \b join_tree
+ *  * \b split_tree
+ *  * \b union_tree
+ *  * \b intersection_tree
+ *  * \b difference_tree
  *
  * Moreover, libavl gives the availability to browse your entire data
  * or a subset of your data with:
  *  * \b explore_tree
  *  * \b explore_restrain_tree
+ *  * \b scan_range
+ *  * \b collect_range
  *  * \b print_tree
  *
+ * With \b set_multimap, equal elements are all kept in insertion order,
+ * and found with \b count_equal and \b equal_range.
+ *
+ * With \b set_tombstones, deleted elements are only marked, and removed
+ * later all at once with \b compact.
+ *
+ * With \b set_wavl, tree is a weak AVL tree, whose deletions need
+ * \f$\mathcal{O}(1)\f$ amortized rebalancing steps and at most two
+ * rotations, where an AVL deletion can rotate each node of its path.
+ *
+ * With \b set_relaxed, insertions and deletions do not rotate tree, which
+ * is balanced later, by pieces, only when \b rebalance_step is called.
+ *
+ * With \b set_less_than, data is ordered by a less-than predicate, and
+ * lookups, insertions and deletions call it once per level and a last
+ * time, instead of twice per level to know if data is equal.
+ *
+ * With \b set_persistent, \b snapshot gives in constant time a frozen
+ * version of tree, and \b clone_tree a copy you can modify. Both share
+ * all their nodes with tree until they are modified.
+ *
+ * With \b set_augmentation, each node keeps a summary of its subtree, and
+ * \b aggregate_range combines a range of data in logarithmic time. With
+ * \b set_lazy_update, \b update_range modifies a range of data in
+ * logarithmic time too.
+ *
  * Finally, libavl take care of your memory and deallocate all memory
  * used in a tree when you want to destroy it with \b delete_tree.
  *
@@ -184,6 +241,8 @@
 struct _node {
         /** Size of subtree */
         unsigned height;
+        /** Internal state of node */
+        unsigned flags;
         /** Left son */
         struct _node *left;
         /** Right son */
@@ -197,6 +256,65 @@ struct _node {
  */
 typedef struct _node *node;
 
+/** \def KEY_CUSTOM
+ * \brief Data is compared by \c data_cmp.
+ */
+#define KEY_CUSTOM      0
+/** \def KEY_INT32
+ * \brief Key is a signed 32 bits integer.
+ */
+#define KEY_INT32       1
+/** \def KEY_INT64
+ * \brief Key is a signed 64 bits integer.
+ */
+#define KEY_INT64       2
+/** \def KEY_UINT32
+ * \brief Key is an unsigned 32 bits integer.
+ */
+#define KEY_UINT32      3
+/** \def KEY_UINT64
+ * \brief Key is an unsigned 64 bits integer.
+ */
+#define KEY_UINT64      4
+/** \def KEY_DOUBLE
+ * \brief Key is a double, ordered as a number, with -0.0 before 0.0.
+ */
+#define KEY_DOUBLE      5
+/** \def KEY_BYTES
+ * \brief Key is an array of bytes, ordered as by \c memcmp.
+ */
+#define KEY_BYTES       6
+/** \def KEY_STRING
+ * \brief Key is an array of characters, ended by a null character if it
+ * is shorter than array, ordered as by \c strncmp.
+ */
+#define KEY_STRING      7
+/** \def KEY_COMPOSITE
+ * \brief Key is made of several fields, see
+ * \c init_composite_dictionnary.
+ */
+#define KEY_COMPOSITE   8
+/** \def KEY_CSTRING
+ * \brief Key is a pointer to a null terminated string of any length,
+ * ordered as by \c strcmp. Strings are copied in an arena of tree.
+ */
+#define KEY_CSTRING     9
+
+/**
+ * \brief Description of a key stored in each data, see
+ * \c init_key_dictionnary.
+ */
+typedef struct _key_desc {
+        /** Type of key, one of \c KEY_* */
+        unsigned type;
+        /** Offset of key in data */
+        size_t offset;
+        /** Length of key in bytes, only for \c KEY_BYTES and \c KEY_STRING */
+        size_t length;
+        /** 1 to order keys in decreasing order */
+        int descending;
+} key_desc;
+
 /**
  * \brief Tree structure wich contains all necessary element.
  */
@@ -205,6 +323,51 @@ typedef struct _tree {
         unsigned count;
         /** Pointer to the first node of tree */
         node root;
+        /** Pointer to the node of minimum element, NULL if tree is empty */
+        node leftmost;
+        /** Pointer to the node of maximum element, NULL if tree is empty */
+        node rightmost;
+        /** Path to the last node inserted with \c insert_elmt_hint or at
+         * the end of tree */
+        struct _finger *finger;
+        /** Number of nodes in \c finger, 0 if it must be found again */
+        unsigned finger_depth;
+        /** Number of nodes \c finger can hold */
+        unsigned finger_size;
+        /** Left border of tree, from root to \c leftmost, kept by
+         * \c delete_node_min and \c pop_min */
+        node *spine;
+        /** Number of nodes in \c spine, 0 if it must be found again */
+        unsigned spine_depth;
+        /** Number of nodes \c spine can hold */
+        unsigned spine_size;
+        /** 1 if deleted elements are only marked, see \c set_tombstones */
+        int tombstones;
+        /** Number of marked nodes still in tree, not counted in \c count */
+        unsigned dead;
+        /** Percent of marked nodes which triggers compaction, 0 for never */
+        unsigned dead_ratio;
+        /** 1 if equal elements can be stored, see \c set_multimap */
+        int multimap;
+        /** 1 if nodes can be shared with snapshots, see \c set_persistent */
+        int persistent;
+        /** Size of each data of a persistent tree */
+        size_t datasize;
+        /** 1 if tree is balanced by ranks, see \c set_wavl */
+        int wavl;
+        /** Number of rotations done in tree, for statistics */
+        unsigned long rotations;
+        /** 1 if balancing is deferred, see \c set_relaxed */
+        int relaxed;
+        /** Key compared by library, type is \c KEY_CUSTOM for \c data_cmp */
+        key_desc key;
+        /** Fields of a \c KEY_COMPOSITE key, most significant first */
+        key_desc *fields;
+        /** Number of fields of a composite key */
+        unsigned field_count;
+        /** Strings of a \c KEY_CSTRING key, shared with trees which
+         * exchanged nodes with tree */
+        struct _arena *arena;
         /** \brief External function to compare data
          *
          * \param a Pointer to first element to compare
@@ -213,9 +376,21 @@ typedef struct _tree {
          * \return 0 if a = b, positive if a > b and negative if a < b.
          *
          * \note \e You must implement this function. It is necessary for the library
-         * to work and depends on your data you want to store.
+         * to work and depends on your data you want to store. It is NULL
+         * when tree compares a typed key, see \c init_key_dictionnary.
          */
         int (* data_cmp) (void *, void *);
+        /** \brief External predicate which orders data, used instead of
+         * \c data_cmp when it is not NULL.
+         *
+         * \param a Pointer to first element to compare
+         * \param b Pointer to second element to compare
+         *
+         * \return Non zero if a < b, 0 if not.
+         *
+         * \note This function is optional, see \c set_less_than.
+         */
+        int (* data_less) (void *, void *);
         /** \brief External function to print data.
          *
          * \param d Pointer to data to print.
@@ -248,8 +423,53 @@ typedef struct _tree {
          * to work and depends on your data you want to store.
          */
         void (* data_copy) (void *, void *);
+
+        /** Size of summary stored in each node, 0 if tree is not augmented */
+        size_t summary_size;
+        /** \brief External function to compute summary of a subtree.
+         *
+         * \param summary Pointer to summary to compute.
+         * \param left Pointer to summary of left subtree, NULL if empty.
+         * \param data Pointer to data stored in node.
+         * \param right Pointer to summary of right subtree, NULL if empty.
+         *
+         * \note This function is optional, see \c set_augmentation.
+         */
+        void (* summary_combine) (void *, void *, void *, void *);
+
+        /** Size of tag stored in each node, 0 if tree has no lazy update */
+        size_t tag_size;
+        /** \brief External function to apply a tag.
+         *
+         * \param data Pointer to data to update.
+         * \param summary Pointer to summary to update, may be NULL.
+         * \param tag Pointer to tag to apply.
+         *
+         * \note This function is optional, see \c set_lazy_update.
+         */
+        void (* tag_apply) (void *, void *, void *);
+        /** \brief External function to merge two tags.
+         *
+         * \param tag Pointer to pending tag, updated with newer tag.
+         * \param newer Pointer to tag applied after pending tag.
+         *
+         * \note This function is optional, see \c set_lazy_update.
+         */
+        void (* tag_compose) (void *, void *);
 } tree;
 
+/**
+ * \brief State of a range collected by chunks, see \c collect_range.
+ */
+typedef struct _range_cursor {
+        /** Nodes to collect next, next one on top */
+        node *stack;
+        /** Number of nodes in stack */
+        unsigned size;
+        /** Last node of range */
+        node last;
+} range_cursor;
+
 
 
 /* ************************************************************************* *\
@@ -307,6 +527,59 @@ tree *init_dictionnary(int (*data_cmp)(void *, void *),
                        void (*data_delete)(void *),
                        void (*data_copy)(void *, void *));
 
+/** \fn int set_augmentation(tree *t, size_t summary_size,
+ *                       void (*summary_combine)(void *, void *,
+ *                                               void *, void *));
+ * \brief Store a user defined summary of each subtree in its root node.
+ *
+ * \return 1 if augmentation is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ * \param summary_size Size of summary stored in each node.
+ * \param summary_combine Function to compute summary of a node.
+ *
+ * Summary of a node is computed again each time its height is updated, with
+ * the call:
+ *
+ *      summary_combine(summary, left_summary, data, right_summary);
+ *
+ * where \c left_summary and \c right_summary are NULL for empty subtree.
+ * A summary can be a sum, a minimum, a maximum or any associative
+ * operation over your data.
+ */
+int set_augmentation(tree *t, size_t summary_size,
+                     void (*summary_combine)(void *, void *, void *, void *));
+
+/** \fn int set_lazy_update(tree *t, size_t tag_size,
+ *                      void (*tag_apply)(void *, void *, void *),
+ *                      void (*tag_compose)(void *, void *));
+ * \brief Allow range update of data with lazy propagation of tags.
+ *
+ * \return 1 if lazy update is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ * \param tag_size Size of tag stored in each node.
+ * \param tag_apply Function to apply a tag on data and on a summary.
+ * \param tag_compose Function to add a newer tag to a pending tag.
+ *
+ * A tag describes an update of data, like "add 3 to value" or "set value
+ * to 0". It is applied with:
+ *
+ *      tag_apply(data, summary, tag);
+ *
+ * where \c summary is the summary of subtree of the updated node, or NULL
+ * if only \c data must be updated or if tree is not augmented. Then tags
+ * are merged with:
+ *
+ *      tag_compose(pending_tag, newer_tag);
+ *
+ * so that applying \c pending_tag gives the same result as applying first
+ * the older \c pending_tag and then \c newer_tag.
+ *
+ * \note A tag must never modify fields used by \c data_cmp.
+ */
+int set_lazy_update(tree *t, size_t tag_size,
+                    void (*tag_apply)(void *, void *, void *),
+                    void (*tag_compose)(void *, void *));
+
 /** \fn int insert_elmt(tree *t, void *data, size_t datasize);
  * \brief Insert new element in tree.
  *
@@ -317,6 +590,10 @@ tree *init_dictionnary(int (*data_cmp)(void *, void *),
  *
  * This function allocate a new memory space with the given size
  * and copy object pointed by \c data to the newly created space.
+ *
+ * Data greater than the maximum element of tree is appended at the end
+ * of tree, with only one comparison. Other data is compared once with
+ * each node of its path, which is kept to rebalance tree.
  */
 unsigned int insert_elmt(tree *t, void *data, size_t datasize);
 
@@ -371,8 +648,8 @@ void explore_tree(tree *t, void (*treatement)(void *, void *), void *param);
  * \param check Function apply on every node between \c data_min and
  * \c data_max
  * \param param Pointer to extra data to pass to \c check function.
- * \param data_min Pointer to the minimum element.
- * \param data_max Pointer to the maximum element.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
  *
  * This function goes thought a part of tree bounded with \c data_min and
  * \c data_max, and if \c n is the pointer to the current node, it calls
@@ -381,6 +658,10 @@ void explore_tree(tree *t, void (*treatement)(void *, void *), void *param);
  *      accu += check(n, param);
  *
  * The value of \c accu is returned by \c explore_restrain_tree.
+ *
+ * Only nodes on the paths to \c data_min and \c data_max are compared
+ * to bounds, so this function costs \f$\mathcal{O}(\log n)\f$ comparisons
+ * for any number of elements in range.
  */
 int explore_restrain_tree(tree *t, int (*check)(void *, void *), void *param,
                                 void *data_min, void *data_max);
@@ -399,9 +680,22 @@ int is_present(tree *t, void *d);
  * \brief Delete minimum element of a tree.
  *
  * \param t Tree where minimum element will be deleted.
+ *
+ * Left border of tree is kept between calls, and only its end is balanced
+ * again, unless tree is persistent, relaxed, augmented or lazily updated.
+ * Path kept for appends is kept too, so that a sliding window, where
+ * elements are appended and minimum is deleted, costs
+ * \f$\mathcal{O}(1)\f$ amortized per element.
  */
 void delete_node_min(tree *t);
 
+/** \fn void delete_node_max(tree *t);
+ * \brief Delete maximum element of a tree.
+ *
+ * \param t Tree where maximum element will be deleted.
+ */
+void delete_node_max(tree *t);
+
 /** \fn void delete_node(tree *t, void *data);
  * \brief Delete node n of tree.
  *
@@ -422,4 +716,761 @@ void delete_node(tree *t, void *data);
  */
 int get_data(tree *t, void *data, size_t data_size);
 
+/** \fn int aggregate_range(tree *t, void *data_min, void *data_max,
+ *                         void *summary);
+ * \brief Combine summaries of all elements between \c data_min and
+ * \c data_max.
+ *
+ * \return 1 if there is at least one element in range, 0 if not.
+ * \param t Pointer to an augmented tree.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param summary Pointer to memory filled with the resulting summary.
+ *
+ * This function only combines summaries along the two boundary paths of
+ * range, and runs in \f$\mathcal{O}(\log n)\f$.
+ */
+int aggregate_range(tree *t, void *data_min, void *data_max, void *summary);
+
+/** \fn void update_range(tree *t, void *data_min, void *data_max, void *tag);
+ * \brief Apply \c tag to all elements between \c data_min and \c data_max.
+ *
+ * \param t Pointer to tree with lazy update.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param tag Pointer to tag to apply.
+ *
+ * Only the nodes of the two boundary paths of range are updated at once,
+ * so this function runs in \f$\mathcal{O}(\log n)\f$. Other nodes are
+ * updated on their next visit.
+ */
+void update_range(tree *t, void *data_min, void *data_max, void *tag);
+
+/** \fn unsigned int build_from_iterator(tree *t, void *(*next)(void *),
+ *                                      void *param, unsigned int count,
+ *                                      size_t datasize);
+ * \brief Fill an empty tree with sorted data given by an iterator.
+ *
+ * \return Number of element in tree.
+ * \param t Pointer to an empty tree.
+ * \param next Function which gives a pointer to the next data.
+ * \param param Pointer to extra data to pass to \c next function.
+ * \param count Number of data given by \c next.
+ * \param datasize Size of each data.
+ *
+ * The function \c next is called exactly \c count times with:
+ *
+ *      d = next(param);
+ *
+ * and each \c d is copied in a new node with \c data_copy. Data must be
+ * given in strictly increasing order since they are never compared. The
+ * resulting tree is perfectly balanced, and is built in
+ * \f$\mathcal{O}(n)\f$ without any rotation.
+ */
+unsigned int build_from_iterator(tree *t, void *(*next)(void *), void *param,
+                                 unsigned int count, size_t datasize);
+
+/** \fn unsigned int build_from_sorted(tree *t, void *data,
+ *                                    unsigned int count, size_t datasize);
+ * \brief Fill an empty tree with a sorted array of data.
+ *
+ * \return Number of element in tree.
+ * \param t Pointer to an empty tree.
+ * \param data Pointer to the first element of array.
+ * \param count Number of element in array.
+ * \param datasize Size of each element of array.
+ *
+ * Elements of array must be in strictly increasing order. See
+ * \c build_from_iterator.
+ */
+unsigned int build_from_sorted(tree *t, void *data, unsigned int count,
+                               size_t datasize);
+
+/** \fn unsigned int join_tree(tree *t1, void *data, size_t datasize,
+ *                            tree *t2);
+ * \brief Move all elements of \c t2 and \c data into \c t1.
+ *
+ * \return Number of element in \c t1.
+ * \param t1 Tree with all elements smaller than \c data.
+ * \param data Pointer to data to add, NULL to only join both trees.
+ * \param datasize Size of data to add.
+ * \param t2 Tree with all elements greater than \c data.
+ *
+ * Elements of \c t2 must all be greater than elements of \c t1. Nodes of
+ * \c t2 are moved into \c t1 without any allocation, in
+ * \f$\mathcal{O}(\log n)\f$, and \c t2 is left empty.
+ *
+ * \note Both trees must be initialized with the same functions. This is
+ * true for all functions which move elements from a tree to another one.
+ */
+unsigned int join_tree(tree *t1, void *data, size_t datasize, tree *t2);
+
+/** \fn int split_tree(tree *t, void *data, tree *greater, void **found);
+ * \brief Move all elements of \c t greater than \c data into \c greater.
+ *
+ * \return 1 if an element equal to \c data was in \c t, 0 if not.
+ * \param t Tree to split, keeps all elements smaller than \c data.
+ * \param data Data used to split tree.
+ * \param greater Empty tree which receives elements greater than \c data.
+ * \param found Filled with the element equal to \c data, if any. If
+ * \c found is NULL, this element is deleted.
+ *
+ * When the element equal to \c data is given back with \c found, it is
+ * not in tree anymore and you must delete it yourself.
+ *
+ * Nodes are moved without any allocation. The split itself costs
+ * \f$\mathcal{O}(\log n)\f$, and counting elements of both trees costs
+ * \f$\mathcal{O}(\min(|t|, |greater|))\f$.
+ */
+int split_tree(tree *t, void *data, tree *greater, void **found);
+
+/** \fn unsigned int union_tree(tree *t1, tree *t2);
+ * \brief Move all elements of \c t2 into \c t1.
+ *
+ * \return Number of element in \c t1.
+ * \param t1 Tree which receives the union of both trees.
+ * \param t2 Tree which is emptied.
+ *
+ * When an element is in both trees, the one of \c t1 is kept. Nodes are
+ * moved without any allocation, in
+ * \f$\mathcal{O}(m \log(\frac{n}{m} + 1))\f$ where \e m is the size of
+ * the smallest tree.
+ */
+unsigned int union_tree(tree *t1, tree *t2);
+
+/** \fn unsigned int intersection_tree(tree *t1, tree *t2);
+ * \brief Keep in \c t1 only elements which are in \c t2 too.
+ *
+ * \return Number of element in \c t1.
+ * \param t1 Tree which receives the intersection of both trees.
+ * \param t2 Tree which is emptied.
+ *
+ * Elements of \c t1 are kept and all elements of \c t2 are deleted. See
+ * \c union_tree for complexity.
+ */
+unsigned int intersection_tree(tree *t1, tree *t2);
+
+/** \fn unsigned int difference_tree(tree *t1, tree *t2);
+ * \brief Delete from \c t1 all elements which are in \c t2.
+ *
+ * \return Number of element in \c t1.
+ * \param t1 Tree which receives the difference of both trees.
+ * \param t2 Tree which is emptied.
+ *
+ * All elements of \c t2 are deleted. See \c union_tree for complexity.
+ */
+unsigned int difference_tree(tree *t1, tree *t2);
+
+/** \fn unsigned int insert_batch(tree *t, void *data, unsigned int count,
+ *                               size_t datasize, int *inserted);
+ * \brief Insert an array of data, in any order.
+ *
+ * \return Number of element in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to the first data of array.
+ * \param count Number of data in array.
+ * \param datasize Size of each data.
+ * \param inserted Array of \c count integers, filled with 1 for each
+ * inserted data and 0 for each data already in tree or already in array.
+ * Can be NULL.
+ *
+ * Batch is sorted first. Then a small batch is inserted in
+ * \f$\mathcal{O}(m \log(\frac{n}{m} + 1))\f$ by splitting it along
+ * the tree, and a batch bigger than a quarter of tree is merged with all
+ * elements of tree to rebuild it in \f$\mathcal{O}(n + m)\f$. In both
+ * case, tree is only browsed once.
+ */
+unsigned int insert_batch(tree *t, void *data, unsigned int count,
+                          size_t datasize, int *inserted);
+
+/** \fn unsigned int lookup_batch(tree *t, void *data, unsigned int count,
+ *                               size_t datasize, void **found);
+ * \brief Look for an array of data in tree.
+ *
+ * \return Number of data found in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to the first data to look for. Only fields used in
+ * \c data_cmp need to be filled.
+ * \param count Number of data in array.
+ * \param datasize Size of each data in array.
+ * \param found Array of \c count pointers, filled with pointer to data
+ * stored in tree, or NULL if data is not found.
+ *
+ * Several lookups go down the tree together, and memory of their next
+ * nodes is prefetched, so that their cache misses overlap. This is much
+ * faster than \c is_present for trees bigger than cache.
+ *
+ * \note Pointers given back in \c found remain valid until the next
+ * modification of tree.
+ */
+unsigned int lookup_batch(tree *t, void *data, unsigned int count,
+                          size_t datasize, void **found);
+
+/** \fn unsigned int lookup_sorted_batch(tree *t, void *data,
+ *                                      unsigned int count, size_t datasize,
+ *                                      void **found);
+ * \brief Look for a sorted array of data in tree.
+ *
+ * \return Number of data found in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to the first data to look for. Data must be sorted in
+ * increasing order according to \c data_cmp.
+ * \param count Number of data in array.
+ * \param datasize Size of each data in array.
+ * \param found Array of \c count pointers, filled with pointer to data
+ * stored in tree, or NULL if data is not found.
+ *
+ * Tree is browsed only once in increasing order: each lookup starts from
+ * the path of the previous one, and climbs only as far as needed. This
+ * costs \f$\mathcal{O}(m \log(n/m + 1))\f$ comparisons for \f$m\f$ data
+ * instead of \f$\mathcal{O}(m \log n)\f$.
+ *
+ * \note Pointers given back in \c found remain valid until the next
+ * modification of tree.
+ */
+unsigned int lookup_sorted_batch(tree *t, void *data, unsigned int count,
+                                 size_t datasize, void **found);
+
+/** \fn unsigned int delete_range(tree *t, void *data_min, void *data_max,
+ *                               void (*removed)(void *, void *),
+ *                               void *param);
+ * \brief Delete all elements between \c data_min and \c data_max.
+ *
+ * \return Number of deleted elements.
+ * \param t Pointer to tree.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param removed Function which receives each deleted data, in increasing
+ * order, and must free it. If NULL, \c data_delete is used.
+ * \param param Pointer to extra data to pass to \c removed function.
+ *
+ * If \c d is the pointer to a deleted data, it calls the function:
+ *
+ *      removed(d, param);
+ *
+ * Range is split out of tree and remaining parts are joined back, so this
+ * function costs \f$\mathcal{O}(\log n + k)\f$ for \f$k\f$ deleted elements,
+ * instead of one lookup and one rebalancing for each of them.
+ */
+unsigned int delete_range(tree *t, void *data_min, void *data_max,
+                          void (*removed)(void *, void *), void *param);
+
+/** \fn void *peek_min(tree *t);
+ * \brief Give minimum element of tree, without removing it.
+ *
+ * \return Pointer to minimum data stored in tree, NULL if tree is empty.
+ * \param t Pointer to tree.
+ *
+ * Minimum node is kept in tree, so this function runs in
+ * \f$\mathcal{O}(1)\f$. With lazy update, pending tags of the left border
+ * must be applied first, and it runs in \f$\mathcal{O}(\log n)\f$.
+ *
+ * \note Pointer remains valid until the next modification of tree.
+ */
+void *peek_min(tree *t);
+
+/** \fn void *peek_max(tree *t);
+ * \brief Give maximum element of tree, without removing it.
+ *
+ * \return Pointer to maximum data stored in tree, NULL if tree is empty.
+ * \param t Pointer to tree.
+ *
+ * See \c peek_min.
+ */
+void *peek_max(tree *t);
+
+/** \fn void *pop_min(tree *t);
+ * \brief Remove minimum element of tree and give it back.
+ *
+ * \return Pointer to minimum data, NULL if tree is empty.
+ * \param t Pointer to tree.
+ *
+ * Data is not copied nor deleted: it is not in tree anymore and you must
+ * delete it yourself. Left border is kept as in \c delete_node_min.
+ */
+void *pop_min(tree *t);
+
+/** \fn void *pop_max(tree *t);
+ * \brief Remove maximum element of tree and give it back.
+ *
+ * \return Pointer to maximum data, NULL if tree is empty.
+ * \param t Pointer to tree.
+ *
+ * See \c pop_min.
+ */
+void *pop_max(tree *t);
+
+/** \fn unsigned int insert_elmt_hint(tree *t, void *data, size_t datasize);
+ * \brief Insert new element in tree, starting from the previous one.
+ *
+ * \return Number of element inserted in tree.
+ * \param t Pointer to tree.
+ * \param data Pointer to data to add.
+ * \param datasize Size of data.
+ *
+ * Tree keeps the path to the last element inserted with this function, or
+ * appended after the maximum by \c insert_elmt. Insertion climbs this
+ * path only as far as needed and goes down from there, so a stream of
+ * close data costs a few comparisons by element instead of
+ * \f$\mathcal{O}(\log n)\f$. Rebalancing also stops as soon as heights do
+ * not change anymore.
+ *
+ * Any other modification of tree forgets this path, and the next
+ * insertion starts again from root.
+ */
+unsigned int insert_elmt_hint(tree *t, void *data, size_t datasize);
+
+/** \def SCAN_EXCLUDE_MIN
+ * \brief Flag of \c scan_range to exclude element equal to \c data_min.
+ */
+#define SCAN_EXCLUDE_MIN    0x01u
+
+/** \def SCAN_EXCLUDE_MAX
+ * \brief Flag of \c scan_range to exclude element equal to \c data_max.
+ */
+#define SCAN_EXCLUDE_MAX    0x02u
+
+/** \def SCAN_REVERSE
+ * \brief Flag of \c scan_range to scan elements in decreasing order.
+ */
+#define SCAN_REVERSE        0x04u
+
+/** \fn unsigned int scan_range(tree *t, void *data_min, void *data_max,
+ *                             unsigned int flags, unsigned int limit,
+ *                             int (*treatement)(void *, void *),
+ *                             void *param, void **next);
+ * \brief Execute function \c treatement on a page of elements between
+ * \c data_min and \c data_max.
+ *
+ * \return Number of elements given to \c treatement.
+ * \param t Pointer to tree.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param flags Combination of \c SCAN_EXCLUDE_MIN, \c SCAN_EXCLUDE_MAX
+ * and \c SCAN_REVERSE.
+ * \param limit Maximum number of elements to scan, 0 for no limit.
+ * \param treatement Function to apply to each element, may be NULL. A non
+ * zero result stops scan.
+ * \param param Pointer to extra data to pass to \c treatement function.
+ * \param next Filled with the first element of range which was not
+ * scanned, or NULL if the whole range was scanned. May be NULL.
+ *
+ * Elements are scanned in increasing order, or decreasing order with
+ * \c SCAN_REVERSE. If \c d is the pointer to the current element, it
+ * calls the function:
+ *
+ *      stop = treatement(d, param);
+ *
+ * Scan stops after \c limit elements or when \c stop is not zero. Next
+ * page starts from \c next, which must be copied before any modification
+ * of tree. Each page costs \f$\mathcal{O}(\log n + k)\f$ for \f$k\f$
+ * scanned elements.
+ */
+unsigned int scan_range(tree *t, void *data_min, void *data_max,
+                        unsigned int flags, unsigned int limit,
+                        int (*treatement)(void *, void *), void *param,
+                        void **next);
+
+/** \fn unsigned int collect_range(tree *t, void *data_min, void *data_max,
+ *                                void **out, unsigned int cap,
+ *                                range_cursor *cursor);
+ * \brief Fill an array with the first elements between \c data_min and
+ * \c data_max.
+ *
+ * \return Number of elements put in \c out.
+ * \param t Pointer to tree.
+ * \param data_min Pointer to the minimum element, NULL for no lower bound.
+ * \param data_max Pointer to the maximum element, NULL for no upper bound.
+ * \param out Array filled with pointers to data, in increasing order.
+ * \param cap Number of pointers \c out can hold.
+ * \param cursor Filled with the state of range, to get next elements with
+ * \c collect_next. May be NULL.
+ *
+ * Elements are given by chunks, so they can be processed in a tight loop
+ * instead of one call of a function for each of them:
+ *
+ *      range_cursor c;
+ *      unsigned int i, n;
+ *
+ *      n = collect_range(t, &min, &max, out, 64, &c);
+ *      while (n > 0) {
+ *          for (i = 0; i < n; i++)
+ *              ... use out[i] ...
+ *          n = collect_next(t, out, 64, &c);
+ *      }
+ *
+ * Tree must not be modified while range is collected. Pointers remain
+ * valid until the next modification of tree.
+ */
+unsigned int collect_range(tree *t, void *data_min, void *data_max,
+                           void **out, unsigned int cap, range_cursor *cursor);
+
+/** \fn unsigned int collect_next(tree *t, void **out, unsigned int cap,
+ *                               range_cursor *cursor);
+ * \brief Fill an array with the next elements of a range.
+ *
+ * \return Number of elements put in \c out, 0 when the whole range was
+ * collected.
+ * \param t Pointer to tree.
+ * \param out Array filled with pointers to data, in increasing order.
+ * \param cap Number of pointers \c out can hold.
+ * \param cursor State of range, from \c collect_range.
+ *
+ * Memory of cursor is released when the whole range is collected.
+ */
+unsigned int collect_next(tree *t, void **out, unsigned int cap,
+                          range_cursor *cursor);
+
+/** \fn void release_cursor(range_cursor *cursor);
+ * \brief Release memory of a cursor before the end of its range.
+ *
+ * \param cursor Cursor to release.
+ */
+void release_cursor(range_cursor *cursor);
+
+/** \fn int set_tombstones(tree *t, unsigned int ratio);
+ * \brief Only mark deleted elements, and remove them later.
+ *
+ * \return 1 if tombstones are set, 0 if not.
+ * \param t Pointer to an empty tree.
+ * \param ratio Percent of marked elements in tree which triggers
+ * \c compact, 0 to only compact explicitly.
+ *
+ * Then \c delete_node only looks for element and marks it, without any
+ * rotation nor memory release. Marked elements are skipped by lookups
+ * and scans, and inserting them again reuses their node. Whole tree
+ * operations like \c join_tree, \c split_tree or \c insert_batch compact
+ * tree first.
+ *
+ * Summaries would hold marked elements, so tombstones can't be set on an
+ * augmented tree.
+ */
+int set_tombstones(tree *t, unsigned int ratio);
+
+/** \fn unsigned int compact(tree *t);
+ * \brief Remove all marked elements from tree.
+ *
+ * \return Number of removed elements.
+ * \param t Pointer to tree.
+ *
+ * Remaining nodes are linked again in a perfectly balanced tree, in
+ * \f$\mathcal{O}(n)\f$ and without any allocation.
+ */
+unsigned int compact(tree *t);
+
+/** \fn int set_multimap(tree *t);
+ * \brief Keep all equal elements in tree.
+ *
+ * \return 1 if multimap is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ *
+ * Then an element equal to some elements of tree is inserted after them,
+ * so equal elements stay in insertion order and need no extra field in
+ * their key. Lookups still run in \f$\mathcal{O}(\log n)\f$:
+ *  * \c get_data gives the first inserted of equal elements, and
+ *    \c is_present, \c lookup_batch or \c lookup_sorted_batch any of them;
+ *  * \c delete_node deletes one of them, \c delete_range all of them;
+ *  * \c split_tree moves them into greater tree and never finds one;
+ *  * \c union_tree, \c intersection_tree and \c difference_tree are
+ *    not available.
+ *
+ * Multimap can't be set with tombstones.
+ */
+int set_multimap(tree *t);
+
+/** \fn unsigned int equal_range(tree *t, void *data,
+ *                              int (*treatement)(void *, void *),
+ *                              void *param);
+ * \brief Execute function \c treatement on every element equal to
+ * \c data, in insertion order.
+ *
+ * \return Number of elements given to \c treatement.
+ * \param t Pointer to tree.
+ * \param data Pointer to data to look for.
+ * \param treatement Function to apply to each element, may be NULL. A non
+ * zero result stops scan.
+ * \param param Pointer to extra data to pass to \c treatement function.
+ *
+ * See \c scan_range.
+ */
+unsigned int equal_range(tree *t, void *data,
+                         int (*treatement)(void *, void *), void *param);
+
+/** \fn unsigned int count_equal(tree *t, void *data);
+ * \brief Count elements equal to \c data.
+ *
+ * \return Number of elements equal to \c data.
+ * \param t Pointer to tree.
+ * \param data Pointer to data to look for.
+ *
+ * This function costs \f$\mathcal{O}(\log n + k)\f$ for \f$k\f$ equal
+ * elements.
+ */
+unsigned int count_equal(tree *t, void *data);
+
+/** \fn int set_persistent(tree *t, size_t datasize);
+ * \brief Allow snapshots of tree, with path copying.
+ *
+ * \return 1 if persistence is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ * \param datasize Size of each data stored in tree.
+ *
+ * Each node of a persistent tree counts its references, so it can be
+ * shared by a tree, its snapshots and its clones. Then any modification
+ * only copies the shared nodes it modifies: \c insert_elmt or
+ * \c delete_node copy the \f$\mathcal{O}(\log n)\f$ nodes of their path,
+ * and joins, splits, batches and range deletions the nodes along the
+ * borders they follow. Data is never copied while it is in tree, but data
+ * given back to you (see \c pop_min) is copied if another tree still
+ * uses it.
+ *
+ * \c insert_elmt_hint is a simple \c insert_elmt on a persistent tree.
+ * Persistence can't be set with tombstones or lazy update.
+ */
+int set_persistent(tree *t, size_t datasize);
+
+/** \fn tree *snapshot(tree *t);
+ * \brief Give a frozen version of a persistent tree.
+ *
+ * \return Pointer to snapshot, NULL on error.
+ * \param t Pointer to a persistent tree.
+ *
+ * Snapshot shares all nodes of \c t, and costs \f$\mathcal{O}(1)\f$.
+ * Later modifications of \c t are not seen in snapshot, which can be used
+ * with any function that only reads tree, like \c get_data,
+ * \c scan_range or \c collect_range. A snapshot of a snapshot is another
+ * handle on the same version.
+ *
+ * Snapshot must never be modified, and must be released with
+ * \c delete_tree. Nodes which are not used anymore by any version are
+ * then deleted. Use \c clone_tree for a version you can modify.
+ */
+tree *snapshot(tree *t);
+
+/** \fn tree *clone_tree(tree *t);
+ * \brief Give a copy of a persistent tree, which can be modified.
+ *
+ * \return Pointer to clone, NULL on error.
+ * \param t Pointer to a persistent tree.
+ *
+ * Clone shares all nodes of \c t, and costs \f$\mathcal{O}(1)\f$. Both
+ * trees can then be modified independently, each one copying shared nodes
+ * only where it changes them, so a clone only uses memory for its changes.
+ * Clone must be released with \c delete_tree.
+ */
+tree *clone_tree(tree *t);
+
+/** \fn int set_wavl(tree *t);
+ * \brief Balance tree by ranks, as a weak AVL tree.
+ *
+ * \return 1 if rank balance is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ *
+ * Each node has a rank, which is 1 or 2 more than the ranks of its sons,
+ * and leaves have the lowest rank. Insertions balance tree exactly as in
+ * an AVL tree, so a tree which is only filled keeps the same shape. But a
+ * deletion only demotes nodes, and stops after at most two rotations. So
+ * both insertion and deletion need \f$\mathcal{O}(1)\f$ amortized
+ * rebalancing steps, and tree height stays below \f$2 \log_2 n\f$.
+ *
+ * Rank balance bounds the worst deletion, not the average one. When
+ * random keys are deleted from a tree whose nodes all lean to the same
+ * side, an AVL deletion does up to 10 rotations and 0.39 per deletion,
+ * a weak AVL deletion at most 2 and 0.35 per deletion. When random keys
+ * are deleted from a tree filled with random keys, both do about 0.38
+ * rotations per deletion. See \c bench/bench.c.
+ *
+ * \c verif_tree checks ranks instead of AVL balance. A weak AVL tree can
+ * only be joined with, split into or combined with another one. Those
+ * operations rebalance borders of trees as insertions do, so they cost
+ * the same as in an AVL tree.
+ */
+int set_wavl(tree *t);
+
+/** \fn int set_relaxed(tree *t);
+ * \brief Defer balancing of tree to \c rebalance_step.
+ *
+ * \return 1 if relaxed balance is set, 0 if not.
+ * \param t Pointer to an empty tree.
+ *
+ * Insertions and deletions of a relaxed tree only update heights along
+ * their path, and mark nodes which are not balanced anymore, without any
+ * rotation. Paths can then become longer than \f$\log_2 n\f$, until tree
+ * is balanced again with \c rebalance_step, for instance after a burst of
+ * writes, or between two of them.
+ *
+ * No other function balances tree: lookups and writes never call
+ * \c rebalance_step, so a tree left idle stays as unbalanced as its last
+ * write left it. Writes are not cheaper either, as their paths get longer:
+ * relaxed balance only moves rotations out of a burst of writes, into
+ * calls to \c rebalance_step made when caller has time for them.
+ *
+ * All functions work on a relaxed tree which is not balanced, but
+ * \c verif_tree only accepts it once \c rebalance_step has balanced all
+ * nodes. Relaxed balance can't be set on a rank balanced tree.
+ */
+int set_relaxed(tree *t);
+
+/** \fn unsigned int rebalance_step(tree *t, unsigned int budget);
+ * \brief Balance some nodes of a relaxed tree.
+ *
+ * \return Number of balanced nodes.
+ * \param t Pointer to a relaxed tree.
+ * \param budget Maximum number of nodes to balance, 0 for no limit.
+ *
+ * Marked nodes are balanced from bottom to top, each one by joining its
+ * two balanced subtrees. So each call costs
+ * \f$\mathcal{O}(budget \log n)\f$ at most, and tree is balanced once a
+ * call returns less than \c budget. Tree must not be used by another
+ * thread during call.
+ */
+unsigned int rebalance_step(tree *t, unsigned int budget);
+
+/** \fn tree *init_key_dictionnary(const key_desc *key,
+ *                                 void (*data_print)(void *),
+ *                                 void (*data_delete)(void *),
+ *                                 void (*data_copy)(void *, void *));
+ * \brief Initialize dictionnary whose data is ordered by a typed key.
+ *
+ * \return Pointer to new tree, NULL if key is not valid.
+ * \param key Type, offset and length of key in each data.
+ * \param data_print Function to print data.
+ * \param data_delete Function to delete data.
+ * \param data_copy Function to copy data.
+ *
+ * Library compares keys itself, without any call to a \c data_cmp
+ * function, and without overflow: integers are compared as numbers,
+ * doubles as integers whose order is the order of numbers, bytes with
+ * \c memcmp and strings with \c strncmp. A key may not be aligned in data.
+ *
+ *      struct item { int id; double price; char name[32]; };
+ *      key_desc by_name = { KEY_STRING, offsetof(struct item, name), 32, 0 };
+ *      tree *t = init_key_dictionnary(&by_name, NULL, NULL, NULL);
+ *
+ * A key with \c descending set orders data in decreasing order.
+ *
+ * A \c KEY_CSTRING key has a length of 0. Its strings are copied with data
+ * in an arena of tree: \c data_delete must not free them. The string of
+ * an element deleted by tree is reused by a later insertion of a key of
+ * similar length, so a key read with \c get_data is valid while its
+ * element stays in tree. Keys of data given back by tree, as by \c pop_min
+ * or \c delete_range, are never reused, and stay valid until tree and
+ * all trees it was joined or combined with are deleted.
+ * Lookups resume each comparison after the prefix that the bounds of
+ * current subtree already share with the searched key.
+ *
+ * Any other mode can be set on this tree as on any other one. Only trees
+ * with the same key can be joined or combined.
+ */
+tree *init_key_dictionnary(const key_desc *key,
+                           void (*data_print)(void *),
+                           void (*data_delete)(void *),
+                           void (*data_copy)(void *, void *));
+
+/** \fn tree *init_composite_dictionnary(const key_desc *fields,
+ *                                       unsigned int count,
+ *                                       void (*data_print)(void *),
+ *                                       void (*data_delete)(void *),
+ *                                       void (*data_copy)(void *, void *));
+ * \brief Initialize dictionnary whose data is ordered by several fields.
+ *
+ * \return Pointer to new tree, NULL if a field is not valid.
+ * \param fields Description of each field, from the most significant one.
+ * \param count Number of fields.
+ * \param data_print Function to print data.
+ * \param data_delete Function to delete data.
+ * \param data_copy Function to copy data.
+ *
+ * Data is ordered by its first field, then by its second one when first
+ * fields are equal, and so on. Each field has its own type and direction,
+ * as a key of \c init_key_dictionnary, and comparison stops at the first
+ * different field, without any function call. A field can't be a
+ * \c KEY_CSTRING key.
+ *
+ *      struct row { uint32_t tenant; int64_t time; uint32_t seq; };
+ *      key_desc fields[] = {
+ *          { KEY_UINT32, offsetof(struct row, tenant), 0, 0 },
+ *          { KEY_INT64, offsetof(struct row, time), 0, 1 },
+ *          { KEY_UINT32, offsetof(struct row, seq), 0, 0 },
+ *      };
+ *      tree *t = init_composite_dictionnary(fields, 3, NULL, NULL, NULL);
+ *
+ * Here, rows of each tenant are ordered from the newest one.
+ */
+tree *init_composite_dictionnary(const key_desc *fields, unsigned int count,
+                                 void (*data_print)(void *),
+                                 void (*data_delete)(void *),
+                                 void (*data_copy)(void *, void *));
+
+/** \fn unsigned int scan_fields(tree *t, void *data, unsigned int count,
+ *                              int (*treatement)(void *, void *),
+ *                              void *param);
+ * \brief Execute function \c treatement on every element whose first
+ * fields are equal to the ones of \c data.
+ *
+ * \return Number of elements given to \c treatement.
+ * \param t Pointer to a tree with a composite key.
+ * \param data Pointer to data, only its first \c count fields are used.
+ * \param count Number of fields to compare.
+ * \param treatement Function to apply to each element, may be NULL. A non
+ * zero result stops scan.
+ * \param param Pointer to extra data to pass to \c treatement function.
+ *
+ * Elements are scanned in tree order, as with \c scan_range, which seeks
+ * directly to the first matching element: scan costs
+ * \f$\mathcal{O}(\log n + k)\f$ for \f$k\f$ scanned elements, and needs
+ * no sentinel data. With the example of \c init_composite_dictionnary, all
+ * rows of tenant 42 are scanned with:
+ *
+ *      struct row r = { 42, 0, 0 };
+ *      scan_fields(t, &r, 1, treatement, param);
+ */
+unsigned int scan_fields(tree *t, void *data, unsigned int count,
+                         int (*treatement)(void *, void *), void *param);
+
+/** \fn unsigned int scan_prefix(tree *t, const char *prefix,
+ *                              int (*treatement)(void *, void *),
+ *                              void *param);
+ * \brief Execute function \c treatement on every element whose string key
+ * starts with \c prefix.
+ *
+ * \return Number of elements given to \c treatement.
+ * \param t Pointer to a tree with a \c KEY_CSTRING key.
+ * \param prefix Null terminated prefix of keys to scan.
+ * \param treatement Function to apply to each element, may be NULL. A non
+ * zero result stops scan.
+ * \param param Pointer to extra data to pass to \c treatement function.
+ *
+ * As with \c scan_fields, scan seeks directly to the first matching
+ * element, and costs \f$\mathcal{O}(\log n + k)\f$ for \f$k\f$ scanned
+ * elements.
+ */
+unsigned int scan_prefix(tree *t, const char *prefix,
+                         int (*treatement)(void *, void *), void *param);
+
+/** \fn int set_less_than(tree *t, int (*data_less)(void *, void *));
+ * \brief Order data with a less-than predicate instead of \c data_cmp.
+ *
+ * \return 1 if predicate is set, 0 if not.
+ * \param t Pointer to an empty tree, whose \c data_cmp may be NULL.
+ * \param data_less Predicate which gives non zero if its first data is
+ * before its second one.
+ *
+ * Predicate is meant for data ordered only by a less-than relation, such
+ * as C++ operator<. A three-way comparison built from it costs two calls
+ * per level, and stops a lookup as soon as an equal node is met. Lookups,
+ * insertions and deletions of this tree instead only ask at each level if
+ * data is before node, and remember the last node which data is not
+ * before: data is equal to it if it is not after it either, so the whole
+ * path costs one call per level and a last one.
+ *
+ * Such a path always goes down to a leaf, so it makes one or two calls
+ * more than a path of \c data_cmp calls, which stops on an equal node: a
+ * tree which has a three-way \c data_cmp should keep it.
+ *
+ * Other functions compare data with one or two calls. Insertions of all
+ * trees compare each node of their path once.
+ */
+int set_less_than(tree *t, int (*data_less)(void *, void *));
+
 #endif
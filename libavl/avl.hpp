@@ -0,0 +1,892 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+/**
+ * \file avl.hpp
+ * \brief C++ ordered map balanced as AVL trees of \c avl.h.
+ *
+ * Trees of \c avl.h hold \c void \c * data of \c datasize bytes, copied in
+ * each node through \c data_copy and compared through \c data_cmp. This
+ * header provides instead \c avl::map, a template with the interface of
+ * \c std::map: values are constructed in place in nodes, may be move-only,
+ * and the comparator is inlined at compile time.
+ *
+ *      avl::map<std::string, std::unique_ptr<int>, std::less<>> m;
+ *      m.emplace("one", std::unique_ptr<int>(new int(1)));
+ *      auto it = m.find("one");
+ *
+ * With a transparent comparator, such as \c std::less<>, \c find,
+ * \c count, \c contains, \c lower_bound, \c upper_bound and \c equal_range
+ * accept any type comparable with keys, without building a key.
+ */
+#ifndef __AVL_HPP__
+#define __AVL_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace avl {
+
+/**
+ * \brief Ordered map of unique keys stored in an AVL tree.
+ *
+ * As in \c avl.h, height of both subtrees of a node differs by one at
+ * most, so a tree of \c n elements has a height of \c 1.44 \c log(n) at
+ * most. Nodes also hold a link to their parent, so iterators move to the
+ * next element in amortized constant time.
+ */
+template <class Key,
+          class T,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<std::pair<const Key, T> > >
+class map {
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Compare key_compare;
+    typedef Allocator allocator_type;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef typename std::allocator_traits<Allocator>::pointer pointer;
+    typedef typename std::allocator_traits<Allocator>::const_pointer
+        const_pointer;
+
+private:
+    struct node {
+        value_type value;
+        node *left;
+        node *right;
+        node *parent;
+        unsigned height;
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template
+        rebind_alloc<node> node_allocator;
+    typedef std::allocator_traits<node_allocator> node_traits;
+
+public:
+    /**
+     * \brief Bidirectional iterator over values of a map, in key order.
+     */
+    template <bool Const>
+    class basic_iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef typename map::value_type value_type;
+        typedef typename map::difference_type difference_type;
+        typedef typename std::conditional<Const, const value_type *,
+                                          value_type *>::type pointer;
+        typedef typename std::conditional<Const, const value_type &,
+                                          value_type &>::type reference;
+
+        basic_iterator() : n(nullptr), m(nullptr) {}
+        // Conversion from iterator to const_iterator.
+        template <bool C, class = typename std::enable_if<Const && !C>::type>
+        basic_iterator(const basic_iterator<C> &it) : n(it.n), m(it.m) {}
+
+        reference operator*() const { return n->value; }
+        pointer operator->() const { return &n->value; }
+
+        basic_iterator &operator++()
+        {
+            n = map::next(n);
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            basic_iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        // Decrement of end() gives the last element.
+        basic_iterator &operator--()
+        {
+            n = n == nullptr ? map::last(m->root) : map::prev(n);
+            return *this;
+        }
+
+        basic_iterator operator--(int)
+        {
+            basic_iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        friend bool operator==(const basic_iterator &a,
+                               const basic_iterator &b)
+        {
+            return a.n == b.n;
+        }
+
+        friend bool operator!=(const basic_iterator &a,
+                               const basic_iterator &b)
+        {
+            return a.n != b.n;
+        }
+
+    private:
+        friend class map;
+        template <bool C> friend class basic_iterator;
+
+        basic_iterator(node *current, const map *owner)
+            : n(current), m(owner) {}
+
+        node *n;
+        const map *m;
+    };
+
+    typedef basic_iterator<false> iterator;
+    typedef basic_iterator<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    map() : root(nullptr), elements(0), cmp(), alloc() {}
+
+    explicit map(const Compare &comp, const Allocator &a = Allocator())
+        : root(nullptr), elements(0), cmp(comp), alloc(a) {}
+
+    explicit map(const Allocator &a)
+        : root(nullptr), elements(0), cmp(), alloc(a) {}
+
+    template <class InputIt>
+    map(InputIt first, InputIt last, const Compare &comp = Compare(),
+        const Allocator &a = Allocator())
+        : root(nullptr), elements(0), cmp(comp), alloc(a)
+    {
+        insert(first, last);
+    }
+
+    map(std::initializer_list<value_type> init,
+        const Compare &comp = Compare(), const Allocator &a = Allocator())
+        : root(nullptr), elements(0), cmp(comp), alloc(a)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    map(const map &other)
+        : root(nullptr), elements(0), cmp(other.cmp),
+          alloc(node_traits::select_on_container_copy_construction(
+                    other.alloc))
+    {
+        root = copy_tree(other.root, nullptr);
+        elements = other.elements;
+    }
+
+    map(map &&other) noexcept
+        : root(other.root), elements(other.elements),
+          cmp(std::move(other.cmp)), alloc(std::move(other.alloc))
+    {
+        other.root = nullptr;
+        other.elements = 0;
+    }
+
+    ~map() { clear(); }
+
+    map &operator=(const map &other)
+    {
+        if (this != &other) {
+            clear();
+            if (node_traits::propagate_on_container_copy_assignment::value)
+                alloc = other.alloc;
+            cmp = other.cmp;
+            root = copy_tree(other.root, nullptr);
+            elements = other.elements;
+        }
+        return *this;
+    }
+
+    map &operator=(map &&other)
+    {
+        if (this == &other)
+            return *this;
+        clear();
+        cmp = std::move(other.cmp);
+        // As std::map, values are only moved one by one when allocators
+        // may differ, so move-only keys are fine with std::allocator.
+        typedef typename node_traits::propagate_on_container_move_assignment
+            propagate;
+        move_assign(other, std::integral_constant<bool, propagate::value
+                               || std::is_empty<node_allocator>::value>());
+        return *this;
+    }
+
+    allocator_type get_allocator() const { return allocator_type(alloc); }
+    key_compare key_comp() const { return cmp; }
+
+    iterator begin() { return iterator(first(root), this); }
+    const_iterator begin() const { return const_iterator(first(root), this); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(nullptr, this); }
+    const_iterator end() const { return const_iterator(nullptr, this); }
+    const_iterator cend() const { return end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    bool empty() const { return elements == 0; }
+    size_type size() const { return elements; }
+    size_type max_size() const { return node_traits::max_size(alloc); }
+
+    /**
+     * \brief Height of the tree, 0 when map is empty.
+     */
+    unsigned height() const { return height(root); }
+
+    void clear()
+    {
+        destroy_tree(root);
+        root = nullptr;
+        elements = 0;
+    }
+
+    /**
+     * \brief Build a value from \c args and insert it, unless its key is
+     * already in map.
+     *
+     * \return Iterator on element of the key and \c true if value was
+     * inserted.
+     */
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        node *n = create(std::forward<Args>(args)...);
+        std::pair<node *, bool> r = link(n->value.first, n);
+        if (!r.second)
+            destroy(n);
+        return std::make_pair(iterator(r.first, this), r.second);
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator, Args &&...args)
+    {
+        return emplace(std::forward<Args>(args)...).first;
+    }
+
+    /**
+     * \brief Insert a value built from \c key and \c args, unless \c key is
+     * already in map. Nothing is built nor moved when key is present.
+     */
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args)
+    {
+        return try_emplace_key(key, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args)
+    {
+        return try_emplace_key(std::move(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value)
+    {
+        return emplace(std::move(value));
+    }
+
+    template <class P, class = typename std::enable_if<
+                  std::is_constructible<value_type, P &&>::value>::type>
+    std::pair<iterator, bool> insert(P &&value)
+    {
+        return emplace(std::forward<P>(value));
+    }
+
+    template <class InputIt>
+    void insert(InputIt first_it, InputIt last_it)
+    {
+        for (; first_it != last_it; ++first_it)
+            emplace(*first_it);
+    }
+
+    void insert(std::initializer_list<value_type> init)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj)
+    {
+        std::pair<iterator, bool> r = try_emplace(key, std::forward<M>(obj));
+        if (!r.second)
+            r.first->second = std::forward<M>(obj);
+        return r;
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(key_type &&key, M &&obj)
+    {
+        std::pair<iterator, bool> r = try_emplace(std::move(key),
+                                                  std::forward<M>(obj));
+        if (!r.second)
+            r.first->second = std::forward<M>(obj);
+        return r;
+    }
+
+    mapped_type &operator[](const key_type &key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    mapped_type &operator[](key_type &&key)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    mapped_type &at(const key_type &key)
+    {
+        node *n = search(key);
+        if (n == nullptr)
+            throw std::out_of_range("avl::map::at");
+        return n->value.second;
+    }
+
+    const mapped_type &at(const key_type &key) const
+    {
+        node *n = search(key);
+        if (n == nullptr)
+            throw std::out_of_range("avl::map::at");
+        return n->value.second;
+    }
+
+    /**
+     * \brief Remove element of \c pos.
+     *
+     * \return Iterator on the following element.
+     */
+    iterator erase(const_iterator pos)
+    {
+        node *following = next(pos.n);
+        unlink(pos.n);
+        destroy(pos.n);
+        return iterator(following, this);
+    }
+
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    iterator erase(const_iterator first_it, const_iterator last_it)
+    {
+        while (first_it != last_it)
+            first_it = erase(first_it);
+        return iterator(last_it.n, this);
+    }
+
+    size_type erase(const key_type &key)
+    {
+        node *n = search(key);
+        if (n == nullptr)
+            return 0;
+        unlink(n);
+        destroy(n);
+        return 1;
+    }
+
+    void swap(map &other) noexcept
+    {
+        using std::swap;
+        swap(root, other.root);
+        swap(elements, other.elements);
+        swap(cmp, other.cmp);
+        if (node_traits::propagate_on_container_swap::value)
+            swap(alloc, other.alloc);
+    }
+
+    iterator find(const key_type &key) { return iterator(search(key), this); }
+    const_iterator find(const key_type &key) const
+    {
+        return const_iterator(search(key), this);
+    }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    iterator find(const K &key) { return iterator(search(key), this); }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    const_iterator find(const K &key) const
+    {
+        return const_iterator(search(key), this);
+    }
+
+    size_type count(const key_type &key) const
+    {
+        return search(key) != nullptr;
+    }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    size_type count(const K &key) const
+    {
+        return search(key) != nullptr;
+    }
+
+    bool contains(const key_type &key) const
+    {
+        return search(key) != nullptr;
+    }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    bool contains(const K &key) const
+    {
+        return search(key) != nullptr;
+    }
+
+    iterator lower_bound(const key_type &key)
+    {
+        return iterator(lower(key), this);
+    }
+    const_iterator lower_bound(const key_type &key) const
+    {
+        return const_iterator(lower(key), this);
+    }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    iterator lower_bound(const K &key) { return iterator(lower(key), this); }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    const_iterator lower_bound(const K &key) const
+    {
+        return const_iterator(lower(key), this);
+    }
+
+    iterator upper_bound(const key_type &key)
+    {
+        return iterator(upper(key), this);
+    }
+    const_iterator upper_bound(const key_type &key) const
+    {
+        return const_iterator(upper(key), this);
+    }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    iterator upper_bound(const K &key) { return iterator(upper(key), this); }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    const_iterator upper_bound(const K &key) const
+    {
+        return const_iterator(upper(key), this);
+    }
+
+    std::pair<iterator, iterator> equal_range(const key_type &key)
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+    std::pair<const_iterator, const_iterator>
+    equal_range(const key_type &key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    std::pair<iterator, iterator> equal_range(const K &key)
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+    template <class K, class C = Compare,
+              class = typename C::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+private:
+    node *root;
+    size_type elements;
+    Compare cmp;
+    node_allocator alloc;
+
+    static unsigned height(const node *n) { return n == nullptr ? 0 : n->height; }
+
+    static node *first(node *n)
+    {
+        if (n != nullptr)
+            while (n->left != nullptr)
+                n = n->left;
+        return n;
+    }
+
+    static node *last(node *n)
+    {
+        if (n != nullptr)
+            while (n->right != nullptr)
+                n = n->right;
+        return n;
+    }
+
+    static node *next(node *n)
+    {
+        if (n->right != nullptr)
+            return first(n->right);
+        while (n->parent != nullptr && n->parent->right == n)
+            n = n->parent;
+        return n->parent;
+    }
+
+    static node *prev(node *n)
+    {
+        if (n->left != nullptr)
+            return last(n->left);
+        while (n->parent != nullptr && n->parent->left == n)
+            n = n->parent;
+        return n->parent;
+    }
+
+    template <class... Args>
+    node *create(Args &&...args)
+    {
+        node *n = node_traits::allocate(alloc, 1);
+        try {
+            node_traits::construct(alloc, &n->value,
+                                   std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(alloc, n, 1);
+            throw;
+        }
+        n->left = nullptr;
+        n->right = nullptr;
+        n->parent = nullptr;
+        n->height = 1;
+        return n;
+    }
+
+    void destroy(node *n)
+    {
+        node_traits::destroy(alloc, &n->value);
+        node_traits::deallocate(alloc, n, 1);
+    }
+
+    void destroy_tree(node *n)
+    {
+        while (n != nullptr) {
+            destroy_tree(n->right);
+            node *left = n->left;
+            destroy(n);
+            n = left;
+        }
+    }
+
+    void take_nodes(map &other)
+    {
+        root = other.root;
+        elements = other.elements;
+        other.root = nullptr;
+        other.elements = 0;
+    }
+
+    void move_alloc(map &other, std::true_type)
+    {
+        alloc = std::move(other.alloc);
+    }
+
+    void move_alloc(map &, std::false_type) {}
+
+    // Allocator of other can free its nodes here: take them.
+    void move_assign(map &other, std::true_type)
+    {
+        move_alloc(other, typename node_traits::
+                              propagate_on_container_move_assignment());
+        take_nodes(other);
+    }
+
+    void move_assign(map &other, std::false_type)
+    {
+        if (alloc == other.alloc) {
+            take_nodes(other);
+            return;
+        }
+        // Nodes of other cannot be freed by our allocator: move values.
+        for (iterator it = other.begin(); it != other.end(); ++it)
+            emplace(std::move(*it));
+        other.clear();
+    }
+
+    node *copy_tree(const node *n, node *parent)
+    {
+        if (n == nullptr)
+            return nullptr;
+        node *c = create(n->value);
+        c->parent = parent;
+        c->height = n->height;
+        try {
+            c->left = copy_tree(n->left, c);
+            c->right = copy_tree(n->right, c);
+        } catch (...) {
+            destroy_tree(c);
+            throw;
+        }
+        return c;
+    }
+
+    template <class K>
+    node *search(const K &key) const
+    {
+        node *n = root;
+        while (n != nullptr) {
+            if (cmp(key, n->value.first))
+                n = n->left;
+            else if (cmp(n->value.first, key))
+                n = n->right;
+            else
+                return n;
+        }
+        return nullptr;
+    }
+
+    // First node whose key is not less than key.
+    template <class K>
+    node *lower(const K &key) const
+    {
+        node *n = root;
+        node *found = nullptr;
+        while (n != nullptr) {
+            if (cmp(n->value.first, key)) {
+                n = n->right;
+            } else {
+                found = n;
+                n = n->left;
+            }
+        }
+        return found;
+    }
+
+    // First node whose key is greater than key.
+    template <class K>
+    node *upper(const K &key) const
+    {
+        node *n = root;
+        node *found = nullptr;
+        while (n != nullptr) {
+            if (cmp(key, n->value.first)) {
+                found = n;
+                n = n->left;
+            } else {
+                n = n->right;
+            }
+        }
+        return found;
+    }
+
+    template <class K, class... Args>
+    std::pair<iterator, bool> try_emplace_key(K &&key, Args &&...args)
+    {
+        node *parent = nullptr;
+        bool left = false;
+        node *n = root;
+        while (n != nullptr) {
+            parent = n;
+            if (cmp(key, n->value.first)) {
+                left = true;
+                n = n->left;
+            } else if (cmp(n->value.first, key)) {
+                left = false;
+                n = n->right;
+            } else {
+                return std::make_pair(iterator(n, this), false);
+            }
+        }
+        n = create(std::piecewise_construct,
+                   std::forward_as_tuple(std::forward<K>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+        attach(n, parent, left);
+        return std::make_pair(iterator(n, this), true);
+    }
+
+    // Link node n in tree, or give node of same key.
+    std::pair<node *, bool> link(const key_type &key, node *n)
+    {
+        node *parent = nullptr;
+        bool left = false;
+        node *current = root;
+        while (current != nullptr) {
+            parent = current;
+            if (cmp(key, current->value.first)) {
+                left = true;
+                current = current->left;
+            } else if (cmp(current->value.first, key)) {
+                left = false;
+                current = current->right;
+            } else {
+                return std::make_pair(current, false);
+            }
+        }
+        attach(n, parent, left);
+        return std::make_pair(n, true);
+    }
+
+    void attach(node *n, node *parent, bool left)
+    {
+        n->parent = parent;
+        if (parent == nullptr)
+            root = n;
+        else if (left)
+            parent->left = n;
+        else
+            parent->right = n;
+        elements++;
+        rebalance(parent);
+    }
+
+    void replace_child(node *parent, node *old_child, node *new_child)
+    {
+        if (parent == nullptr)
+            root = new_child;
+        else if (parent->left == old_child)
+            parent->left = new_child;
+        else
+            parent->right = new_child;
+        if (new_child != nullptr)
+            new_child->parent = parent;
+    }
+
+    // Remove node n from tree, without destroying it.
+    void unlink(node *n)
+    {
+        node *start;
+
+        if (n->left != nullptr && n->right != nullptr) {
+            // Successor of n takes its place.
+            node *s = first(n->right);
+            if (s->parent == n) {
+                start = s;
+            } else {
+                start = s->parent;
+                replace_child(s->parent, s, s->right);
+                s->right = n->right;
+                s->right->parent = s;
+            }
+            s->left = n->left;
+            s->left->parent = s;
+            s->height = n->height;
+            replace_child(n->parent, n, s);
+        } else {
+            start = n->parent;
+            replace_child(n->parent, n,
+                          n->left != nullptr ? n->left : n->right);
+        }
+        elements--;
+        rebalance(start);
+    }
+
+    static void update(node *n)
+    {
+        unsigned hl = height(n->left);
+        unsigned hr = height(n->right);
+        n->height = (hl > hr ? hl : hr) + 1;
+    }
+
+    node *rotate_left(node *n)
+    {
+        node *r = n->right;
+        n->right = r->left;
+        if (r->left != nullptr)
+            r->left->parent = n;
+        replace_child(n->parent, n, r);
+        r->left = n;
+        n->parent = r;
+        update(n);
+        update(r);
+        return r;
+    }
+
+    node *rotate_right(node *n)
+    {
+        node *l = n->left;
+        n->left = l->right;
+        if (l->right != nullptr)
+            l->right->parent = n;
+        replace_child(n->parent, n, l);
+        l->right = n;
+        n->parent = l;
+        update(n);
+        update(l);
+        return l;
+    }
+
+    // Restore balance from node n up to the root, stopping as soon as a
+    // subtree keeps its height.
+    void rebalance(node *n)
+    {
+        while (n != nullptr) {
+            unsigned before = n->height;
+            unsigned hl = height(n->left);
+            unsigned hr = height(n->right);
+
+            if (hl > hr + 1) {
+                if (height(n->left->left) < height(n->left->right))
+                    rotate_left(n->left);
+                n = rotate_right(n);
+            } else if (hr > hl + 1) {
+                if (height(n->right->right) < height(n->right->left))
+                    rotate_right(n->right);
+                n = rotate_left(n);
+            } else {
+                update(n);
+            }
+            if (n->height == before)
+                break;
+            n = n->parent;
+        }
+    }
+};
+
+template <class Key, class T, class Compare, class Allocator>
+bool operator==(const map<Key, T, Compare, Allocator> &a,
+                const map<Key, T, Compare, Allocator> &b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <class Key, class T, class Compare, class Allocator>
+bool operator!=(const map<Key, T, Compare, Allocator> &a,
+                const map<Key, T, Compare, Allocator> &b)
+{
+    return !(a == b);
+}
+
+template <class Key, class T, class Compare, class Allocator>
+void swap(map<Key, T, Compare, Allocator> &a,
+          map<Key, T, Compare, Allocator> &b) noexcept
+{
+    a.swap(b);
+}
+
+} // namespace avl
+
+#endif
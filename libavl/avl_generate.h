@@ -0,0 +1,575 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+/**
+ * \file avl_generate.h
+ * \brief AVL trees specialized at compile time for one type of element.
+ *
+ * Generic functions of \c avl.h store any data, but each comparison is a
+ * call through \c data_cmp, and each element is copied in a node. Macros of
+ * this file instead generate, as BSD \c tree.h does, a tree for one type of
+ * structure, which holds its own links, with a comparison function which
+ * is inlined:
+ *
+ *      struct item {
+ *          int key;
+ *          AVL_ENTRY(item) link;
+ *      };
+ *
+ *      static int item_cmp(struct item *a, struct item *b)
+ *      {
+ *          return (a->key > b->key) - (a->key < b->key);
+ *      }
+ *
+ *      AVL_HEAD(item_tree, item);
+ *      AVL_GENERATE(item_tree, item, link, item_cmp)
+ *
+ *      struct item_tree head = AVL_INITIALIZER;
+ *      AVL_INSERT(item_tree, &head, elm);
+ *      AVL_FOREACH(elm, item_tree, &head)
+ *          printf("%d\n", elm->key);
+ *
+ * Elements are never allocated nor freed by the tree, and equal elements
+ * are stored once. Elements have no link to their father, so loops keep
+ * their path from root in an iterator.
+ */
+#ifndef __AVL_GENERATE_H__
+#define __AVL_GENERATE_H__
+
+#include <stddef.h>
+
+/** \def AVL_HEAD(name, type)
+ * \brief Declare \c struct \c name, root of a tree of \c struct \c type.
+ */
+#define AVL_HEAD(name, type)                                                \
+struct name {                                                               \
+    struct type *avl_root;                                                  \
+    unsigned avl_count;                                                     \
+}
+
+/** \def AVL_INITIALIZER
+ * \brief Initial value of an empty tree.
+ */
+#define AVL_INITIALIZER { NULL, 0 }
+
+/** \def AVL_INIT(head)
+ * \brief Empty a tree, without touching its elements.
+ */
+#define AVL_INIT(head) do {                                                 \
+    (head)->avl_root = NULL;                                                \
+    (head)->avl_count = 0;                                                  \
+} while (0)
+
+/** \def AVL_ENTRY(type)
+ * \brief Links stored in each element of a tree of \c struct \c type.
+ */
+#define AVL_ENTRY(type)                                                     \
+struct {                                                                    \
+    struct type *avl_left;                                                  \
+    struct type *avl_right;                                                 \
+    unsigned avl_height;                                                    \
+}
+
+/** \def AVL_MAX_HEIGHT
+ * \brief Maximum height of a tree, which is the size of iterators.
+ *
+ * An AVL tree of height 46 holds more than \f$2^{32}\f$ elements.
+ */
+#define AVL_MAX_HEIGHT  48
+
+/** \def AVL_ITER(name)
+ * \brief Type of iterators of tree \c name.
+ */
+#define AVL_ITER(name)  struct name##_AVL_ITER
+
+/** \def AVL_ROOT(head)
+ * \brief Root element of tree, NULL if tree is empty.
+ */
+#define AVL_ROOT(head)          ((head)->avl_root)
+/** \def AVL_EMPTY(head)
+ * \brief True if tree is empty.
+ */
+#define AVL_EMPTY(head)         ((head)->avl_root == NULL)
+/** \def AVL_COUNT(head)
+ * \brief Number of elements in tree.
+ */
+#define AVL_COUNT(head)         ((head)->avl_count)
+/** \def AVL_LEFT(elm, field)
+ * \brief Left son of element.
+ */
+#define AVL_LEFT(elm, field)    ((elm)->field.avl_left)
+/** \def AVL_RIGHT(elm, field)
+ * \brief Right son of element.
+ */
+#define AVL_RIGHT(elm, field)   ((elm)->field.avl_right)
+/** \def AVL_HEIGHT(elm, field)
+ * \brief Height of subtree of element, 0 for NULL.
+ */
+#define AVL_HEIGHT(elm, field)  ((elm) == NULL ? 0u : (elm)->field.avl_height)
+
+/** \def AVL_GENERATE(name, type, field, cmp)
+ * \brief Define all functions of tree \c name.
+ *
+ * \param name Name of tree, declared with \c AVL_HEAD.
+ * \param type Name of structure of elements.
+ * \param field Name of \c AVL_ENTRY field in structure.
+ * \param cmp Function, or macro, which compares two pointers to elements
+ * and gives 0 if they are equal, positive if first one is greater and
+ * negative if it is smaller.
+ *
+ * Functions are static, so each file which uses a tree generates it.
+ * Insertion and removal cost \f$\mathcal{O}(\log n)\f$ comparisons and
+ * at most \f$\mathcal{O}(\log n)\f$ rotations.
+ */
+#define AVL_GENERATE(name, type, field, cmp)                                \
+                                                                            \
+struct name##_AVL_ITER {                                                    \
+    struct type *avl_path[AVL_MAX_HEIGHT];                                  \
+    unsigned avl_depth;                                                     \
+};                                                                          \
+                                                                            \
+static inline void name##_AVL_ADJUST(struct type *n)                        \
+{                                                                           \
+    unsigned hl = AVL_HEIGHT(n->field.avl_left, field);                     \
+    unsigned hr = AVL_HEIGHT(n->field.avl_right, field);                    \
+                                                                            \
+    n->field.avl_height = (hl > hr ? hl : hr) + 1;                          \
+}                                                                           \
+                                                                            \
+static inline struct type *name##_AVL_ROTATE_RIGHT(struct type *n)          \
+{                                                                           \
+    struct type *l = n->field.avl_left;                                     \
+                                                                            \
+    n->field.avl_left = l->field.avl_right;                                 \
+    l->field.avl_right = n;                                                 \
+    name##_AVL_ADJUST(n);                                                   \
+    name##_AVL_ADJUST(l);                                                   \
+                                                                            \
+    return l;                                                               \
+}                                                                           \
+                                                                            \
+static inline struct type *name##_AVL_ROTATE_LEFT(struct type *n)           \
+{                                                                           \
+    struct type *r = n->field.avl_right;                                    \
+                                                                            \
+    n->field.avl_right = r->field.avl_left;                                 \
+    r->field.avl_left = n;                                                  \
+    name##_AVL_ADJUST(n);                                                   \
+    name##_AVL_ADJUST(r);                                                   \
+                                                                            \
+    return r;                                                               \
+}                                                                           \
+                                                                            \
+static inline struct type *name##_AVL_BALANCE(struct type *n)               \
+{                                                                           \
+    struct type *s;                                                         \
+    unsigned hl = AVL_HEIGHT(n->field.avl_left, field);                     \
+    unsigned hr = AVL_HEIGHT(n->field.avl_right, field);                    \
+                                                                            \
+    if (hl > hr + 1) {                                                      \
+        s = n->field.avl_left;                                              \
+        if (  AVL_HEIGHT(s->field.avl_right, field)                         \
+            > AVL_HEIGHT(s->field.avl_left, field))                         \
+            n->field.avl_left = name##_AVL_ROTATE_LEFT(s);                  \
+        return name##_AVL_ROTATE_RIGHT(n);                                  \
+    }                                                                       \
+    if (hr > hl + 1) {                                                      \
+        s = n->field.avl_right;                                             \
+        if (  AVL_HEIGHT(s->field.avl_left, field)                          \
+            > AVL_HEIGHT(s->field.avl_right, field))                        \
+            n->field.avl_right = name##_AVL_ROTATE_RIGHT(s);                \
+        return name##_AVL_ROTATE_LEFT(n);                                   \
+    }                                                                       \
+    n->field.avl_height = (hl > hr ? hl : hr) + 1;                          \
+                                                                            \
+    return n;                                                               \
+}                                                                           \
+                                                                            \
+static struct type *name##_AVL_INSERT_RECUR(struct type *n,                 \
+                                            struct type *elm,               \
+                                            struct type **found)            \
+{                                                                           \
+    int c;                                                                  \
+                                                                            \
+    if (n == NULL) {                                                        \
+        elm->field.avl_left = NULL;                                         \
+        elm->field.avl_right = NULL;                                        \
+        elm->field.avl_height = 1;                                          \
+        return elm;                                                         \
+    }                                                                       \
+                                                                            \
+    c = cmp(elm, n);                                                        \
+    if (c == 0) {                                                           \
+        *found = n;                                                         \
+        return n;                                                           \
+    }                                                                       \
+    if (c < 0)                                                              \
+        n->field.avl_left = name##_AVL_INSERT_RECUR(n->field.avl_left,      \
+                                                    elm, found);            \
+    else                                                                    \
+        n->field.avl_right = name##_AVL_INSERT_RECUR(n->field.avl_right,    \
+                                                     elm, found);           \
+                                                                            \
+    return *found != NULL ? n : name##_AVL_BALANCE(n);                      \
+}                                                                           \
+                                                                            \
+/* Insert elm, give back the equal element already in tree, or NULL. */     \
+static inline struct type *name##_AVL_INSERT(struct name *head,             \
+                                             struct type *elm)              \
+{                                                                           \
+    struct type *found = NULL;                                              \
+                                                                            \
+    head->avl_root = name##_AVL_INSERT_RECUR(head->avl_root, elm, &found);  \
+    if (found == NULL)                                                      \
+        head->avl_count++;                                                  \
+                                                                            \
+    return found;                                                           \
+}                                                                           \
+                                                                            \
+/* Give element equal to elm, or NULL. */                                   \
+static inline struct type *name##_AVL_FIND(struct name *head,               \
+                                           struct type *elm)                \
+{                                                                           \
+    struct type *n = head->avl_root;                                        \
+                                                                            \
+    while (n != NULL) {                                                     \
+        int c = cmp(elm, n);                                                \
+                                                                            \
+        if (c == 0)                                                         \
+            return n;                                                       \
+        n = c < 0 ? n->field.avl_left : n->field.avl_right;                 \
+    }                                                                       \
+                                                                            \
+    return NULL;                                                            \
+}                                                                           \
+                                                                            \
+/* Give smallest element greater than or equal to elm, or NULL. */          \
+static inline struct type *name##_AVL_NFIND(struct name *head,              \
+                                            struct type *elm)               \
+{                                                                           \
+    struct type *n = head->avl_root;                                        \
+    struct type *result = NULL;                                             \
+                                                                            \
+    while (n != NULL) {                                                     \
+        int c = cmp(elm, n);                                                \
+                                                                            \
+        if (c == 0)                                                         \
+            return n;                                                       \
+        if (c < 0) {                                                        \
+            result = n;                                                     \
+            n = n->field.avl_left;                                          \
+        } else {                                                            \
+            n = n->field.avl_right;                                         \
+        }                                                                   \
+    }                                                                       \
+                                                                            \
+    return result;                                                          \
+}                                                                           \
+                                                                            \
+static struct type *name##_AVL_REMOVE_MIN(struct type *n,                   \
+                                          struct type **min)                \
+{                                                                           \
+    if (n->field.avl_left == NULL) {                                        \
+        *min = n;                                                           \
+        return n->field.avl_right;                                          \
+    }                                                                       \
+    n->field.avl_left = name##_AVL_REMOVE_MIN(n->field.avl_left, min);      \
+                                                                            \
+    return name##_AVL_BALANCE(n);                                           \
+}                                                                           \
+                                                                            \
+static struct type *name##_AVL_REMOVE_RECUR(struct type *n,                 \
+                                            struct type *elm,               \
+                                            struct type **removed)          \
+{                                                                           \
+    struct type *min;                                                       \
+    int c;                                                                  \
+                                                                            \
+    if (n == NULL)                                                          \
+        return NULL;                                                        \
+                                                                            \
+    c = cmp(elm, n);                                                        \
+    if (c < 0) {                                                            \
+        n->field.avl_left = name##_AVL_REMOVE_RECUR(n->field.avl_left,      \
+                                                    elm, removed);          \
+    } else if (c > 0) {                                                     \
+        n->field.avl_right = name##_AVL_REMOVE_RECUR(n->field.avl_right,    \
+                                                     elm, removed);         \
+    } else {                                                                \
+        *removed = n;                                                       \
+        if (n->field.avl_left == NULL)                                      \
+            return n->field.avl_right;                                      \
+        if (n->field.avl_right == NULL)                                     \
+            return n->field.avl_left;                                       \
+        /* minimum of right subtree takes place of element. */              \
+        n->field.avl_right = name##_AVL_REMOVE_MIN(n->field.avl_right,      \
+                                                   &min);                   \
+        min->field.avl_left = n->field.avl_left;                            \
+        min->field.avl_right = n->field.avl_right;                          \
+        n = min;                                                            \
+    }                                                                       \
+                                                                            \
+    return *removed != NULL ? name##_AVL_BALANCE(n) : n;                    \
+}                                                                           \
+                                                                            \
+/* Remove element equal to elm, give it back, or NULL if there is none. */  \
+static inline struct type *name##_AVL_REMOVE(struct name *head,             \
+                                             struct type *elm)              \
+{                                                                           \
+    struct type *removed = NULL;                                            \
+                                                                            \
+    head->avl_root = name##_AVL_REMOVE_RECUR(head->avl_root, elm,           \
+                                             &removed);                     \
+    if (removed != NULL)                                                    \
+        head->avl_count--;                                                  \
+                                                                            \
+    return removed;                                                         \
+}                                                                           \
+                                                                            \
+/* Give minimum element, or NULL. */                                        \
+static inline struct type *name##_AVL_MIN(struct name *head)                \
+{                                                                           \
+    struct type *n = head->avl_root;                                        \
+                                                                            \
+    while (n != NULL && n->field.avl_left != NULL)                          \
+        n = n->field.avl_left;                                              \
+                                                                            \
+    return n;                                                               \
+}                                                                           \
+                                                                            \
+/* Give maximum element, or NULL. */                                        \
+static inline struct type *name##_AVL_MAX(struct name *head)                \
+{                                                                           \
+    struct type *n = head->avl_root;                                        \
+                                                                            \
+    while (n != NULL && n->field.avl_right != NULL)                         \
+        n = n->field.avl_right;                                             \
+                                                                            \
+    return n;                                                               \
+}                                                                           \
+                                                                            \
+/* Give element following elm in tree, or NULL, in O(log n) comparisons. */ \
+static inline struct type *name##_AVL_NEXT(struct name *head,               \
+                                           struct type *elm)                \
+{                                                                           \
+    struct type *n = elm->field.avl_right;                                  \
+    struct type *result = NULL;                                             \
+                                                                            \
+    if (n != NULL) {                                                        \
+        while (n->field.avl_left != NULL)                                   \
+            n = n->field.avl_left;                                          \
+        return n;                                                           \
+    }                                                                       \
+    for (n = head->avl_root; n != elm; ) {                                  \
+        if (cmp(elm, n) < 0) {                                              \
+            result = n;                                                     \
+            n = n->field.avl_left;                                          \
+        } else {                                                            \
+            n = n->field.avl_right;                                         \
+        }                                                                   \
+    }                                                                       \
+                                                                            \
+    return result;                                                          \
+}                                                                           \
+                                                                            \
+/* Give element preceding elm in tree, or NULL, in O(log n) comparisons. */ \
+static inline struct type *name##_AVL_PREV(struct name *head,               \
+                                           struct type *elm)                \
+{                                                                           \
+    struct type *n = elm->field.avl_left;                                   \
+    struct type *result = NULL;                                             \
+                                                                            \
+    if (n != NULL) {                                                        \
+        while (n->field.avl_right != NULL)                                  \
+            n = n->field.avl_right;                                         \
+        return n;                                                           \
+    }                                                                       \
+    for (n = head->avl_root; n != elm; ) {                                  \
+        if (cmp(elm, n) > 0) {                                              \
+            result = n;                                                     \
+            n = n->field.avl_right;                                         \
+        } else {                                                            \
+            n = n->field.avl_left;                                          \
+        }                                                                   \
+    }                                                                       \
+                                                                            \
+    return result;                                                          \
+}                                                                           \
+                                                                            \
+/* Set iterator to minimum element and give it, or NULL. */                 \
+static inline struct type *name##_AVL_ITER_FIRST(                           \
+                                            struct name##_AVL_ITER *it,     \
+                                            struct name *head)              \
+{                                                                           \
+    struct type *n;                                                         \
+                                                                            \
+    it->avl_depth = 0;                                                      \
+    for (n = head->avl_root; n != NULL; n = n->field.avl_left)              \
+        it->avl_path[it->avl_depth++] = n;                                  \
+                                                                            \
+    return it->avl_depth > 0 ? it->avl_path[it->avl_depth - 1] : NULL;      \
+}                                                                           \
+                                                                            \
+/* Set iterator to maximum element and give it, or NULL. */                 \
+static inline struct type *name##_AVL_ITER_LAST(struct name##_AVL_ITER *it, \
+                                                struct name *head)          \
+{                                                                           \
+    struct type *n;                                                         \
+                                                                            \
+    it->avl_depth = 0;                                                      \
+    for (n = head->avl_root; n != NULL; n = n->field.avl_right)             \
+        it->avl_path[it->avl_depth++] = n;                                  \
+                                                                            \
+    return it->avl_depth > 0 ? it->avl_path[it->avl_depth - 1] : NULL;      \
+}                                                                           \
+                                                                            \
+/* Move iterator to next element and give it, or NULL at the end. */        \
+static inline struct type *name##_AVL_ITER_NEXT(struct name##_AVL_ITER *it) \
+{                                                                           \
+    struct type *n;                                                         \
+                                                                            \
+    if (it->avl_depth == 0)                                                 \
+        return NULL;                                                        \
+    n = it->avl_path[it->avl_depth - 1]->field.avl_right;                   \
+    if (n != NULL) {                                                        \
+        /* go down to minimum of right subtree. */                          \
+        for (; n != NULL; n = n->field.avl_left)                            \
+            it->avl_path[it->avl_depth++] = n;                              \
+    } else {                                                                \
+        /* climb up to the first father on the right. */                    \
+        do {                                                                \
+            n = it->avl_path[--it->avl_depth];                              \
+        } while (   it->avl_depth > 0                                       \
+                 && it->avl_path[it->avl_depth - 1]->field.avl_right == n); \
+    }                                                                       \
+                                                                            \
+    return it->avl_depth > 0 ? it->avl_path[it->avl_depth - 1] : NULL;      \
+}                                                                           \
+                                                                            \
+/* Move iterator to previous element and give it, or NULL at the end. */    \
+static inline struct type *name##_AVL_ITER_PREV(struct name##_AVL_ITER *it) \
+{                                                                           \
+    struct type *n;                                                         \
+                                                                            \
+    if (it->avl_depth == 0)                                                 \
+        return NULL;                                                        \
+    n = it->avl_path[it->avl_depth - 1]->field.avl_left;                    \
+    if (n != NULL) {                                                        \
+        /* go down to maximum of left subtree. */                           \
+        for (; n != NULL; n = n->field.avl_right)                           \
+            it->avl_path[it->avl_depth++] = n;                              \
+    } else {                                                                \
+        /* climb up to the first father on the left. */                     \
+        do {                                                                \
+            n = it->avl_path[--it->avl_depth];                              \
+        } while (   it->avl_depth > 0                                       \
+                 && it->avl_path[it->avl_depth - 1]->field.avl_left == n);  \
+    }                                                                       \
+                                                                            \
+    return it->avl_depth > 0 ? it->avl_path[it->avl_depth - 1] : NULL;      \
+}
+
+/** \def AVL_INSERT(name, head, elm)
+ * \brief Insert \c elm, give back the equal element already in tree, or
+ * NULL when \c elm is inserted.
+ */
+#define AVL_INSERT(name, head, elm)     name##_AVL_INSERT(head, elm)
+/** \def AVL_REMOVE(name, head, elm)
+ * \brief Remove element equal to \c elm, give it back, or NULL.
+ */
+#define AVL_REMOVE(name, head, elm)     name##_AVL_REMOVE(head, elm)
+/** \def AVL_FIND(name, head, elm)
+ * \brief Give element equal to \c elm, or NULL.
+ */
+#define AVL_FIND(name, head, elm)       name##_AVL_FIND(head, elm)
+/** \def AVL_NFIND(name, head, elm)
+ * \brief Give smallest element greater than or equal to \c elm, or NULL.
+ */
+#define AVL_NFIND(name, head, elm)      name##_AVL_NFIND(head, elm)
+/** \def AVL_MIN(name, head)
+ * \brief Give minimum element, or NULL.
+ */
+#define AVL_MIN(name, head)             name##_AVL_MIN(head)
+/** \def AVL_MAX(name, head)
+ * \brief Give maximum element, or NULL.
+ */
+#define AVL_MAX(name, head)             name##_AVL_MAX(head)
+/** \def AVL_NEXT(name, head, elm)
+ * \brief Give element following \c elm, which must be in tree, or NULL.
+ *
+ * Without father links, \c elm is looked for again from root when it has
+ * no right son, which costs \f$\mathcal{O}(\log n)\f$ comparisons. Loops
+ * should use an iterator instead.
+ */
+#define AVL_NEXT(name, head, elm)       name##_AVL_NEXT(head, elm)
+/** \def AVL_PREV(name, head, elm)
+ * \brief Give element preceding \c elm, which must be in tree, or NULL.
+ *
+ * As \c AVL_NEXT, it costs \f$\mathcal{O}(\log n)\f$ comparisons.
+ */
+#define AVL_PREV(name, head, elm)       name##_AVL_PREV(head, elm)
+/** \def AVL_ITER_FIRST(name, it, head)
+ * \brief Set iterator \c it to minimum element and give it, or NULL.
+ */
+#define AVL_ITER_FIRST(name, it, head)  name##_AVL_ITER_FIRST(it, head)
+/** \def AVL_ITER_LAST(name, it, head)
+ * \brief Set iterator \c it to maximum element and give it, or NULL.
+ */
+#define AVL_ITER_LAST(name, it, head)   name##_AVL_ITER_LAST(it, head)
+/** \def AVL_ITER_NEXT(name, it)
+ * \brief Move iterator \c it to next element and give it, or NULL.
+ *
+ * Iterator keeps the path from root to its element, so a whole loop
+ * costs \f$\mathcal{O}(n)\f$ without any comparison. Tree must not be
+ * modified while an iterator is used.
+ */
+#define AVL_ITER_NEXT(name, it)         name##_AVL_ITER_NEXT(it)
+/** \def AVL_ITER_PREV(name, it)
+ * \brief Move iterator \c it to previous element and give it, or NULL.
+ */
+#define AVL_ITER_PREV(name, it)         name##_AVL_ITER_PREV(it)
+
+/** \def AVL_FOREACH(x, name, head)
+ * \brief Loop over elements of tree in increasing order.
+ *
+ * Variable \c x names the iterator declared by loop, which costs
+ * \f$\mathcal{O}(n)\f$ without any comparison. Tree must not be modified
+ * in loop.
+ */
+#define AVL_FOREACH(x, name, head)                                          \
+    for (AVL_ITER(name) x##_avl_iter,                                       \
+         *x##_avl_it = ((x) = AVL_ITER_FIRST(name, &x##_avl_iter, head),    \
+                        &x##_avl_iter);                                     \
+         (x) != NULL;                                                       \
+         (x) = AVL_ITER_NEXT(name, x##_avl_it))
+
+/** \def AVL_FOREACH_REVERSE(x, name, head)
+ * \brief Loop over elements of tree in decreasing order.
+ *
+ * As in \c AVL_FOREACH, tree must not be modified in loop.
+ */
+#define AVL_FOREACH_REVERSE(x, name, head)                                  \
+    for (AVL_ITER(name) x##_avl_iter,                                       \
+         *x##_avl_it = ((x) = AVL_ITER_LAST(name, &x##_avl_iter, head),     \
+                        &x##_avl_iter);                                     \
+         (x) != NULL;                                                       \
+         (x) = AVL_ITER_PREV(name, x##_avl_it))
+
+#endif
@@ -37,7 +37,7 @@
  * and \c args... arguments use the \c printf format.
  */
 #if LOGLEVEL > 0
-#   define ELOG(fmt, args...) printf("[E] %s:%u "fmt"\n", __func__,\
+#   define ELOG(fmt, args...) printf("[E] %s:%u " fmt "\n", __func__,\
                                                           __LINE__,\
                                                           ##args)
 #else
@@ -56,7 +56,7 @@
  * and \c args... arguments use the \c printf format.
  */
 #if LOGLEVEL > 1
-#   define WLOG(fmt, args...) printf("[W] %s:%u "fmt"\n", __func__,\
+#   define WLOG(fmt, args...) printf("[W] %s:%u " fmt "\n", __func__,\
                                                           __LINE__,\
                                                           ##args)
 #else
@@ -75,7 +75,7 @@
  * and \c args... arguments use the \c printf format.
  */
 #if LOGLEVEL > 2
-#   define ILOG(fmt, args...) printf("[I] %s:%u "fmt"\n", __func__,\
+#   define ILOG(fmt, args...) printf("[I] %s:%u " fmt "\n", __func__,\
                                                           __LINE__,\
                                                           ##args)
 #else
@@ -94,7 +94,7 @@
  * and \c args... arguments use the \c printf format.
  */
 #if LOGLEVEL > 3
-#   define DLOG(fmt, args...) printf("[D] %s:%u "fmt"\n", __func__,\
+#   define DLOG(fmt, args...) printf("[D] %s:%u " fmt "\n", __func__,\
                                                           __LINE__,\
                                                           ##args)
 #else
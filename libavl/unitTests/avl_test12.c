@@ -0,0 +1,236 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+struct _tree_summary {
+    long sum;
+    int min;
+    int max;
+    unsigned int count;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+static void summary_combine(void *summary, void *left, void *data, void *right)
+{
+    struct _tree_summary *s = (struct _tree_summary *) summary;
+    struct _tree_summary *l = (struct _tree_summary *) left;
+    struct _tree_summary *r = (struct _tree_summary *) right;
+    struct _tree_data *d = (struct _tree_data *) data;
+
+    s->sum = d->value;
+    s->min = d->value;
+    s->max = d->value;
+    s->count = 1;
+    if (l != NULL) {
+        s->sum += l->sum;
+        s->min = l->min < s->min ? l->min : s->min;
+        s->max = l->max > s->max ? l->max : s->max;
+        s->count += l->count;
+    }
+    if (r != NULL) {
+        s->sum += r->sum;
+        s->min = r->min < s->min ? r->min : s->min;
+        s->max = r->max > s->max ? r->max : s->max;
+        s->count += r->count;
+    }
+}
+
+static int summary_treat(void *n, void *param)
+{
+    struct _tree_data *data = (struct _tree_data *) n;
+    struct _tree_summary *s = (struct _tree_summary *) param;
+
+    s->sum += data->value;
+    if (s->count == 0 || data->value < s->min)
+        s->min = data->value;
+    if (s->count == 0 || data->value > s->max)
+        s->max = data->value;
+    s->count++;
+
+    return 1;
+}
+
+#define MAX_ELEMENT 5000
+#define MAX_KEY     20000
+
+static char *check_range(tree *t, struct _tree_data *node_min,
+                         struct _tree_data *node_max)
+{
+    struct _tree_summary expected;
+    struct _tree_summary result;
+    int found;
+
+    memset(&expected, 0, sizeof(expected));
+    explore_restrain_tree(t, summary_treat, &expected, node_min, node_max);
+
+    found = aggregate_range(t, node_min, node_max, &result);
+    if (found != (expected.count != 0)) {
+        ELOG("Wrong aggregate result");
+        return "Wrong aggregate result";
+    }
+    if (found && (   result.sum != expected.sum
+                  || result.min != expected.min
+                  || result.max != expected.max
+                  || result.count != expected.count)) {
+        ELOG("Wrong aggregated summary");
+        return "Wrong aggregated summary";
+    }
+
+    return NULL;
+}
+
+char *aggregate_tests()
+{
+    tree *first = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data node_min;
+    struct _tree_data node_max;
+    struct _tree_summary expected;
+    struct _tree_summary result;
+    char *message;
+    int i = 0;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    // aggregate on a NULL tree
+    if (aggregate_range(first, NULL, NULL, &result)) {
+        ELOG("Wrong result on NULL tree");
+        return "Wrong result on NULL tree";
+    }
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+    if (!set_augmentation(first, sizeof(struct _tree_summary), summary_combine)) {
+        ELOG("Augmentation not set");
+        return "Augmentation not set";
+    }
+
+    // aggregate on an empty tree
+    if (aggregate_range(first, NULL, NULL, &result)) {
+        ELOG("Wrong result on empty tree");
+        return "Wrong result on empty tree";
+    }
+
+    // Add data
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand() % 1000 - 500;
+        insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+    }
+    verif_tree(first);
+
+    // Augmentation can not be changed on a non empty tree
+    if (set_augmentation(first, sizeof(struct _tree_summary), summary_combine)) {
+        ELOG("Augmentation set on non empty tree");
+        return "Augmentation set on non empty tree";
+    }
+
+    // Delete some data
+    for (i = 0; i < MAX_ELEMENT / 2; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(first, &tmp_elmnt);
+        if (i % 100 == 0)
+            delete_node_min(first);
+    }
+    verif_tree(first);
+
+    // Whole tree
+    if (!aggregate_range(first, NULL, NULL, &result) || result.count != first->count) {
+        ELOG("Wrong count of whole tree");
+        return "Wrong count of whole tree";
+    }
+
+    // Random ranges
+    for (i = 0; i < 1000; i++) {
+        node_min.key = rand() % MAX_KEY;
+        node_max.key = node_min.key + rand() % (MAX_KEY / 4);
+        message = check_range(first, &node_min, &node_max);
+        if (message != NULL)
+            return message;
+    }
+
+    // Half bounded ranges
+    node_min.key = -1;
+    node_max.key = rand() % MAX_KEY;
+    message = check_range(first, &node_min, &node_max);
+    if (message != NULL)
+        return message;
+    memset(&expected, 0, sizeof(expected));
+    explore_restrain_tree(first, summary_treat, &expected, &node_min, &node_max);
+    if (   aggregate_range(first, NULL, &node_max, &result) != (expected.count != 0)
+        || (expected.count != 0 && result.sum != expected.sum)) {
+        ELOG("Wrong count of half bounded range");
+        return "Wrong count of half bounded range";
+    }
+
+    // Empty range
+    node_min.key = MAX_KEY + 1;
+    node_max.key = MAX_KEY + 2;
+    if (aggregate_range(first, &node_min, &node_max, &result)) {
+        ELOG("Wrong result on empty range");
+        return "Wrong result on empty range";
+    }
+
+    // Try to delete it
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,244 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    long value;
+};
+
+struct _tree_summary {
+    long sum;
+    long max;
+    long count;
+};
+
+struct _tree_tag {
+    int set;
+    long set_value;
+    long add;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%ld", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+static void summary_combine(void *summary, void *left, void *data, void *right)
+{
+    struct _tree_summary *s = (struct _tree_summary *) summary;
+    struct _tree_summary *l = (struct _tree_summary *) left;
+    struct _tree_summary *r = (struct _tree_summary *) right;
+    struct _tree_data *d = (struct _tree_data *) data;
+
+    s->sum = d->value;
+    s->max = d->value;
+    s->count = 1;
+    if (l != NULL) {
+        s->sum += l->sum;
+        s->max = l->max > s->max ? l->max : s->max;
+        s->count += l->count;
+    }
+    if (r != NULL) {
+        s->sum += r->sum;
+        s->max = r->max > s->max ? r->max : s->max;
+        s->count += r->count;
+    }
+}
+
+static void tag_apply(void *data, void *summary, void *tag)
+{
+    struct _tree_data *d = (struct _tree_data *) data;
+    struct _tree_summary *s = (struct _tree_summary *) summary;
+    struct _tree_tag *g = (struct _tree_tag *) tag;
+
+    if (g->set) {
+        d->value = g->set_value;
+        if (s != NULL) {
+            s->sum = s->count * g->set_value;
+            s->max = g->set_value;
+        }
+    }
+    d->value += g->add;
+    if (s != NULL) {
+        s->sum += s->count * g->add;
+        s->max += g->add;
+    }
+}
+
+static void tag_compose(void *tag, void *newer)
+{
+    struct _tree_tag *g = (struct _tree_tag *) tag;
+    struct _tree_tag *n = (struct _tree_tag *) newer;
+
+    if (n->set)
+        *g = *n;
+    else
+        g->add += n->add;
+}
+
+#define MAX_ELEMENT 2000
+#define MAX_KEY     5000
+
+static int present[MAX_KEY];
+static long values[MAX_KEY];
+
+char *lazy_update_tests()
+{
+    tree *first = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data node_min;
+    struct _tree_data node_max;
+    struct _tree_summary result;
+    struct _tree_tag tag;
+    long sum;
+    long max;
+    int count;
+    int found;
+    int i = 0;
+    int j = 0;
+    int lo;
+    int hi;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    memset(present, 0, sizeof(present));
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+    if (   !set_lazy_update(first, sizeof(struct _tree_tag), tag_apply, tag_compose)
+        || !set_augmentation(first, sizeof(struct _tree_summary), summary_combine)) {
+        ELOG("Lazy update not set");
+        return "Lazy update not set";
+    }
+
+    // update on an empty tree
+    memset(&tag, 0, sizeof(tag));
+    tag.add = 1;
+    update_range(first, NULL, NULL, &tag);
+
+    for (i = 0; i < MAX_ELEMENT * 5; i++) {
+        int op = rand() % 5;
+
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand() % 100;
+        if (op == 0) {
+            insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+            if (!present[tmp_elmnt.key]) {
+                present[tmp_elmnt.key] = 1;
+                values[tmp_elmnt.key] = tmp_elmnt.value;
+            }
+        } else if (op == 1) {
+            delete_node(first, &tmp_elmnt);
+            present[tmp_elmnt.key] = 0;
+        } else {
+            lo = rand() % MAX_KEY;
+            hi = lo + rand() % (MAX_KEY / 3);
+            node_min.key = lo;
+            node_max.key = hi;
+            memset(&tag, 0, sizeof(tag));
+            tag.set = (op == 2);
+            tag.set_value = rand() % 100;
+            tag.add = rand() % 21 - 10;
+            update_range(first, &node_min, &node_max, &tag);
+            for (j = lo; j <= hi && j < MAX_KEY; j++) {
+                if (tag.set)
+                    values[j] = tag.set_value;
+                values[j] += tag.add;
+            }
+        }
+
+        // Check a random range.
+        lo = rand() % MAX_KEY;
+        hi = lo + rand() % (MAX_KEY / 3);
+        node_min.key = lo;
+        node_max.key = hi;
+        sum = 0;
+        max = 0;
+        count = 0;
+        for (j = lo; j <= hi && j < MAX_KEY; j++) {
+            if (present[j]) {
+                if (count == 0 || values[j] > max)
+                    max = values[j];
+                sum += values[j];
+                count++;
+            }
+        }
+        found = aggregate_range(first, &node_min, &node_max, &result);
+        if (found != (count != 0)
+            || (found && (result.sum != sum || result.max != max
+                          || result.count != count))) {
+            ELOG("Wrong aggregated summary after update");
+            return "Wrong aggregated summary after update";
+        }
+    }
+    verif_tree(first);
+
+    // Check all data
+    for (j = 0; j < MAX_KEY; j++) {
+        tmp_elmnt.key = j;
+        found = get_data(first, &tmp_elmnt, sizeof(struct _tree_data));
+        if (found != present[j]) {
+            ELOG("Wrong data found");
+            return "Wrong data found";
+        }
+        if (found && tmp_elmnt.value != values[j]) {
+            ELOG("Wrong data value after update");
+            return "Wrong data value after update";
+        }
+    }
+
+    // Try to delete it
+    delete_tree(first);
+
+    return NULL;
+}
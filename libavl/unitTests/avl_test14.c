@@ -0,0 +1,181 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+static int data_cmp(void *a, void *b)
+{
+    int aa = *((int *) a);
+    int bb = *((int *) b);
+
+    return aa - bb;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d", d, *((int *) d));
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    *((int *) dst) = *((int *) src);
+}
+
+// Generate odd numbers on the fly
+static void *next_odd(void *param)
+{
+    int *current = (int *) param;
+
+    *current += 2;
+
+    return current;
+}
+
+#define MAX_ELEMENT 10000
+
+static int count_calls = 0;
+
+static void count_treat(void *n, void *param)
+{
+    int *previous = (int *) param;
+
+    if (count_calls > 0 && *((int *) n) <= *previous)
+        count_calls = -MAX_ELEMENT;
+    *previous = *((int *) n);
+    count_calls++;
+}
+
+char *build_tests()
+{
+    tree *first = NULL;
+    int data[MAX_ELEMENT];
+    int current;
+    int previous;
+    unsigned int result;
+    unsigned int height;
+    int i = 0;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    // build sorted array
+    data[0] = rand() % 100;
+    for (i = 1; i < MAX_ELEMENT; i++)
+        data[i] = data[i - 1] + 1 + rand() % 100;
+
+    // build on a NULL tree
+    if (build_from_sorted(first, data, MAX_ELEMENT, sizeof(int)) != 0) {
+        ELOG("Wrong result on NULL tree");
+        return "Wrong result on NULL tree";
+    }
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+
+    result = build_from_sorted(first, data, MAX_ELEMENT, sizeof(int));
+    if (result != MAX_ELEMENT || first->count != MAX_ELEMENT) {
+        ELOG("Wrong number of element in built tree");
+        return "Wrong number of element in built tree";
+    }
+    verif_tree(first);
+
+    // Tree is perfectly balanced
+    height = 0;
+    while ((1u << height) <= MAX_ELEMENT)
+        height++;
+    if (first->root->height != height) {
+        ELOG("Wrong height of built tree");
+        return "Wrong height of built tree";
+    }
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        if (!is_present(first, &(data[i]))) {
+            ELOG("Data not found in built tree");
+            return "Data not found in built tree";
+        }
+    }
+
+    // Build can only be done on empty tree
+    result = build_from_sorted(first, data, MAX_ELEMENT / 2, sizeof(int));
+    if (result != MAX_ELEMENT) {
+        ELOG("Wrong build on non empty tree");
+        return "Wrong build on non empty tree";
+    }
+
+    // Built tree is a real tree
+    for (i = 0; i < MAX_ELEMENT; i += 2) {
+        delete_node(first, &(data[i]));
+        verif_tree(first);
+    }
+    current = data[MAX_ELEMENT - 1] + 1;
+    insert_elmt(first, &current, sizeof(int));
+    verif_tree(first);
+    if (first->count != MAX_ELEMENT / 2 + 1) {
+        ELOG("Wrong number of element after update");
+        return "Wrong number of element after update";
+    }
+
+    delete_tree(first);
+
+    // Build from an iterator
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    current = -1;
+    result = build_from_iterator(first, next_odd, &current, MAX_ELEMENT - 1,
+                                 sizeof(int));
+    if (result != MAX_ELEMENT - 1 || current != 2 * (MAX_ELEMENT - 1) - 1) {
+        ELOG("Wrong number of element read from iterator");
+        return "Wrong number of element read from iterator";
+    }
+    verif_tree(first);
+    count_calls = 0;
+    explore_tree(first, count_treat, &previous);
+    if (count_calls != MAX_ELEMENT - 1) {
+        ELOG("Wrong order of built tree");
+        return "Wrong order of built tree";
+    }
+
+    // Empty build
+    delete_tree(first);
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (build_from_sorted(first, data, 0, sizeof(int)) != 0 || first->root != NULL) {
+        ELOG("Wrong empty build");
+        return "Wrong empty build";
+    }
+
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,203 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+static int data_cmp(void *a, void *b)
+{
+    int aa = *((int *) a);
+    int bb = *((int *) b);
+
+    return aa - bb;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d", d, *((int *) d));
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    *((int *) dst) = *((int *) src);
+}
+
+#define MAX_ELEMENT 5000
+#define MAX_KEY     20000
+
+static int in_first[MAX_KEY];
+static int in_second[MAX_KEY];
+
+static tree *fill_tree(int *present, int size)
+{
+    tree *t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    int i;
+    int key;
+
+    memset(present, 0, MAX_KEY * sizeof(int));
+    for (i = 0; i < size; i++) {
+        key = rand() % MAX_KEY;
+        present[key] = 1;
+        insert_elmt(t, &key, sizeof(int));
+    }
+
+    return t;
+}
+
+static char *check_tree(tree *t, int *expected)
+{
+    unsigned int count = 0;
+    int key;
+
+    verif_tree(t);
+    for (key = 0; key < MAX_KEY; key++) {
+        if (is_present(t, &key) != expected[key]) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        count += (unsigned) expected[key];
+    }
+    if (count != t->count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+
+    return NULL;
+}
+
+char *set_operation_tests()
+{
+    tree *first = NULL;
+    tree *second = NULL;
+    char *message;
+    void *found = NULL;
+    int key;
+    int i;
+    int j;
+    int sizes[3] = { MAX_ELEMENT, MAX_ELEMENT / 50, 0 };
+    int s;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (s = 0; s < 3; s++) {
+        // Union
+        first = fill_tree(in_first, MAX_ELEMENT);
+        second = fill_tree(in_second, sizes[s]);
+        union_tree(first, second);
+        for (i = 0; i < MAX_KEY; i++)
+            in_first[i] |= in_second[i];
+        memset(in_second, 0, sizeof(in_second));
+        if ((message = check_tree(first, in_first)) != NULL)
+            return message;
+        if ((message = check_tree(second, in_second)) != NULL)
+            return message;
+        delete_tree(first);
+        delete_tree(second);
+
+        // Intersection, with the smallest tree first
+        first = fill_tree(in_first, sizes[s]);
+        second = fill_tree(in_second, MAX_ELEMENT);
+        intersection_tree(first, second);
+        for (i = 0; i < MAX_KEY; i++)
+            in_first[i] &= in_second[i];
+        memset(in_second, 0, sizeof(in_second));
+        if ((message = check_tree(first, in_first)) != NULL)
+            return message;
+        if ((message = check_tree(second, in_second)) != NULL)
+            return message;
+        delete_tree(first);
+        delete_tree(second);
+
+        // Difference
+        first = fill_tree(in_first, MAX_ELEMENT);
+        second = fill_tree(in_second, sizes[s]);
+        difference_tree(first, second);
+        for (i = 0; i < MAX_KEY; i++)
+            in_first[i] &= !in_second[i];
+        memset(in_second, 0, sizeof(in_second));
+        if ((message = check_tree(first, in_first)) != NULL)
+            return message;
+        if ((message = check_tree(second, in_second)) != NULL)
+            return message;
+        delete_tree(first);
+        delete_tree(second);
+    }
+
+    // Split and join
+    first = fill_tree(in_first, MAX_ELEMENT);
+    second = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    for (i = 0; i < 20; i++) {
+        key = rand() % MAX_KEY;
+        if (split_tree(first, &key, second, &found) != in_first[key]) {
+            ELOG("Wrong split result");
+            return "Wrong split result";
+        }
+        if (in_first[key]) {
+            if (*((int *) found) != key) {
+                ELOG("Wrong found element");
+                return "Wrong found element";
+            }
+            data_delete(found);
+        }
+        memcpy(in_second, in_first, sizeof(in_first));
+        memset(in_first + key, 0, (MAX_KEY - (unsigned) key) * sizeof(int));
+        memset(in_second, 0, ((unsigned) key + 1) * sizeof(int));
+        if ((message = check_tree(first, in_first)) != NULL)
+            return message;
+        if ((message = check_tree(second, in_second)) != NULL)
+            return message;
+
+        // join both parts again, around key
+        join_tree(first, &key, sizeof(int), second);
+        for (j = 0; j < MAX_KEY; j++)
+            in_first[j] |= in_second[j];
+        in_first[key] = 1;
+        memset(in_second, 0, sizeof(in_second));
+        if ((message = check_tree(first, in_first)) != NULL)
+            return message;
+        if ((message = check_tree(second, in_second)) != NULL)
+            return message;
+    }
+
+    // Split at the end and join without middle element
+    key = MAX_KEY / 3;
+    split_tree(first, &key, second, NULL);
+    in_first[key] = 0;
+    join_tree(first, NULL, 0, second);
+    if ((message = check_tree(first, in_first)) != NULL)
+        return message;
+
+    delete_tree(first);
+    delete_tree(second);
+
+    return NULL;
+}
@@ -0,0 +1,155 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 20000
+#define MAX_KEY     50000
+
+static int values[MAX_KEY];
+static struct _tree_data batch[MAX_ELEMENT];
+static int inserted[MAX_ELEMENT];
+
+static char *insert_and_check(tree *t, unsigned int size)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int expected_count = t->count;
+    unsigned int i;
+    int key;
+
+    for (i = 0; i < size; i++) {
+        batch[i].key = rand() % MAX_KEY;
+        batch[i].value = rand();
+    }
+
+    insert_batch(t, batch, size, sizeof(struct _tree_data), inserted);
+    verif_tree(t);
+
+    // First occurence of a new key is inserted, others are rejected.
+    for (i = 0; i < size; i++) {
+        key = batch[i].key;
+        if (inserted[i] != (values[key] == -1)) {
+            ELOG("Wrong insert result");
+            return "Wrong insert result";
+        }
+        if (inserted[i]) {
+            values[key] = batch[i].value;
+            expected_count++;
+        }
+    }
+    if (t->count != expected_count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp_elmnt.key = key;
+        if (get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (values[key] != -1)) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        if (values[key] != -1 && tmp_elmnt.value != values[key]) {
+            ELOG("Wrong value in tree");
+            return "Wrong value in tree";
+        }
+    }
+
+    return NULL;
+}
+
+char *insert_batch_tests()
+{
+    tree *first = NULL;
+    char *message;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+
+    // Empty batch
+    if (insert_batch(first, batch, 0, sizeof(struct _tree_data), NULL) != 0) {
+        ELOG("Wrong result of empty batch");
+        return "Wrong result of empty batch";
+    }
+
+    // Batch in an empty tree, then big batches merged with tree
+    for (i = 0; i < 3; i++)
+        if ((message = insert_and_check(first, MAX_ELEMENT / 2)) != NULL)
+            return message;
+
+    // Small batches inserted along tree
+    for (i = 0; i < 10; i++)
+        if ((message = insert_and_check(first, 1 + (unsigned) rand() % 500)) != NULL)
+            return message;
+
+    // Single insert is still allowed
+    if ((message = insert_and_check(first, 1)) != NULL)
+        return message;
+
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,190 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+static void tag_apply(void *data, void *summary, void *tag)
+{
+    (void) summary;
+    ((struct _tree_data *) data)->value += *((int *) tag);
+}
+
+static void tag_compose(void *tag, void *newer)
+{
+    *((int *) tag) += *((int *) newer);
+}
+
+#define MAX_ELEMENT 10000
+#define MAX_KEY     30000
+#define MAX_LOOKUP  1003
+
+static int values[MAX_KEY];
+static struct _tree_data keys[MAX_LOOKUP];
+static void *found[MAX_LOOKUP];
+
+static char *lookup_and_check(tree *t, unsigned int size)
+{
+    unsigned int expected = 0;
+    unsigned int i;
+    int key;
+
+    for (i = 0; i < size; i++) {
+        keys[i].key = rand() % MAX_KEY;
+        keys[i].value = -1;
+        found[i] = &keys[i];
+    }
+
+    if (lookup_batch(t, keys, size, sizeof(struct _tree_data), found) != 0)
+        for (i = 0; i < size; i++)
+            expected += values[keys[i].key] != -1;
+    else
+        for (i = 0; i < size; i++)
+            if (values[keys[i].key] != -1) {
+                ELOG("Element not found");
+                return "Element not found";
+            }
+
+    for (i = 0; i < size; i++) {
+        key = keys[i].key;
+        if ((found[i] != NULL) != (values[key] != -1)) {
+            ELOG("Wrong lookup result");
+            return "Wrong lookup result";
+        }
+        if (found[i] == NULL)
+            continue;
+        expected--;
+        if (   ((struct _tree_data *) found[i])->key != key
+            || ((struct _tree_data *) found[i])->value != values[key]) {
+            ELOG("Wrong element found");
+            return "Wrong element found";
+        }
+    }
+    if (expected != 0) {
+        ELOG("Wrong number of element found");
+        return "Wrong number of element found";
+    }
+
+    return NULL;
+}
+
+char *lookup_batch_tests()
+{
+    tree *first = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data min, max;
+    char *message;
+    int add;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+    if (!set_lazy_update(first, sizeof(int), tag_apply, tag_compose)) {
+        ELOG("Can't set lazy update");
+        return "Can't set lazy update";
+    }
+
+    // Nothing is found in empty tree
+    if ((message = lookup_and_check(first, 17)) != NULL)
+        return message;
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand() % 1000;
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+    verif_tree(first);
+
+    // Groups of all sizes, including partial last group
+    if ((message = lookup_and_check(first, 0)) != NULL)
+        return message;
+    for (i = 1; i < 20; i++)
+        if ((message = lookup_and_check(first, (unsigned) i)) != NULL)
+            return message;
+    if ((message = lookup_and_check(first, MAX_LOOKUP)) != NULL)
+        return message;
+
+    // Pending updates are applied on found elements
+    for (i = 0; i < 20; i++) {
+        min.key = rand() % MAX_KEY;
+        max.key = min.key + rand() % (MAX_KEY / 4);
+        add = rand() % 100;
+        update_range(first, &min, &max, &add);
+        for (tmp_elmnt.key = min.key; tmp_elmnt.key <= max.key && tmp_elmnt.key < MAX_KEY; tmp_elmnt.key++)
+            if (values[tmp_elmnt.key] != -1)
+                values[tmp_elmnt.key] += add;
+
+        if ((message = lookup_and_check(first, MAX_LOOKUP)) != NULL)
+            return message;
+    }
+    verif_tree(first);
+
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,178 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static unsigned long comparisons = 0;
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    comparisons++;
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 10000
+#define MAX_KEY     30000
+
+static int values[MAX_KEY];
+static struct _tree_data keys[MAX_KEY];
+static void *found[MAX_KEY];
+
+static char *lookup_and_check(tree *t, unsigned int size, unsigned int step)
+{
+    unsigned int expected = 0;
+    unsigned int result;
+    unsigned int i;
+    int key = rand() % (int) step;
+
+    // sorted probes, some of them repeated
+    for (i = 0; i < size; i++) {
+        keys[i].key = key < MAX_KEY ? key : MAX_KEY - 1;
+        if (rand() % 4 != 0)
+            key += 1 + rand() % (int) step;
+        found[i] = &keys[i];
+    }
+
+    result = lookup_sorted_batch(t, keys, size, sizeof(struct _tree_data),
+                                 found);
+    for (i = 0; i < size; i++)
+        expected += values[keys[i].key] != -1;
+    if (result != expected) {
+        ELOG("Wrong number of element returned");
+        return "Wrong number of element returned";
+    }
+
+    for (i = 0; i < size; i++) {
+        key = keys[i].key;
+        if ((found[i] != NULL) != (values[key] != -1)) {
+            ELOG("Wrong lookup result");
+            return "Wrong lookup result";
+        }
+        if (found[i] == NULL)
+            continue;
+        expected--;
+        if (   ((struct _tree_data *) found[i])->key != key
+            || ((struct _tree_data *) found[i])->value != values[key]) {
+            ELOG("Wrong element found");
+            return "Wrong element found";
+        }
+    }
+    if (expected != 0) {
+        ELOG("Wrong number of element found");
+        return "Wrong number of element found";
+    }
+
+    return NULL;
+}
+
+char *lookup_sorted_batch_tests()
+{
+    tree *first = NULL;
+    struct _tree_data tmp_elmnt;
+    char *message;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+
+    // Nothing is found in empty tree
+    if ((message = lookup_and_check(first, 17, 100)) != NULL)
+        return message;
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand();
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+    verif_tree(first);
+
+    // Sparse and dense probes
+    if ((message = lookup_and_check(first, 1, 1)) != NULL)
+        return message;
+    for (i = 0; i < 10; i++)
+        if ((message = lookup_and_check(first, 1 + (unsigned) rand() % 100, 1000)) != NULL)
+            return message;
+    for (i = 0; i < 10; i++)
+        if ((message = lookup_and_check(first, 1 + (unsigned) rand() % 5000, 5)) != NULL)
+            return message;
+
+    // Probing every key costs a constant number of comparisons per key
+    for (i = 0; i < MAX_KEY; i++) {
+        keys[i].key = i;
+        found[i] = NULL;
+    }
+    comparisons = 0;
+    if (lookup_sorted_batch(first, keys, MAX_KEY, sizeof(struct _tree_data), found) != first->count) {
+        ELOG("Wrong number of element found");
+        return "Wrong number of element found";
+    }
+    if (comparisons > 4 * MAX_KEY) {
+        ELOG("Too many comparisons: %lu", comparisons);
+        return "Too many comparisons";
+    }
+
+    delete_tree(first);
+
+    return NULL;
+}
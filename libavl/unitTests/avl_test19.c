@@ -0,0 +1,213 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 10000
+#define MAX_KEY     30000
+
+static int values[MAX_KEY];
+
+struct _removed {
+    int last;
+    int sorted;
+    unsigned int count;
+};
+
+static void removed_data(void *d, void *param)
+{
+    struct _removed *r = (struct _removed *) param;
+    int key = ((struct _tree_data *) d)->key;
+
+    if (key <= r->last || values[key] != ((struct _tree_data *) d)->value)
+        r->sorted = 0;
+    r->last = key;
+    r->count++;
+    values[key] = -1;
+    free(d);
+}
+
+static char *delete_and_check(tree *t, int *min, int *max, int callback)
+{
+    struct _tree_data data_min, data_max, tmp_elmnt;
+    struct _removed r = { -1, 1, 0 };
+    unsigned int expected = 0;
+    unsigned int count = t->count;
+    unsigned int result;
+    int key;
+
+    data_min.key = min != NULL ? *min : 0;
+    data_max.key = max != NULL ? *max : MAX_KEY - 1;
+    for (key = data_min.key; key <= data_max.key; key++)
+        if (values[key] != -1)
+            expected++;
+
+    result = delete_range(t, min != NULL ? &data_min : NULL,
+                          max != NULL ? &data_max : NULL,
+                          callback ? removed_data : NULL, &r);
+    verif_tree(t);
+
+    if (result != expected || t->count != count - expected) {
+        ELOG("Wrong number of deleted element");
+        return "Wrong number of deleted element";
+    }
+    if (callback && (!r.sorted || r.count != expected)) {
+        ELOG("Wrong deleted element");
+        return "Wrong deleted element";
+    }
+    if (!callback)
+        for (key = data_min.key; key <= data_max.key; key++)
+            values[key] = -1;
+
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp_elmnt.key = key;
+        if (get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (values[key] != -1)) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        if (values[key] != -1 && tmp_elmnt.value != values[key]) {
+            ELOG("Wrong value in tree");
+            return "Wrong value in tree";
+        }
+    }
+
+    return NULL;
+}
+
+static void fill_tree(tree *t)
+{
+    struct _tree_data tmp_elmnt;
+    int i;
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand();
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+}
+
+char *delete_range_tests()
+{
+    tree *first = NULL;
+    char *message;
+    int min, max;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+
+    // Nothing to delete in empty tree
+    min = 10; max = 100;
+    if ((message = delete_and_check(first, &min, &max, 0)) != NULL)
+        return message;
+
+    fill_tree(first);
+
+    // Reversed bounds delete nothing, even if bounds are in tree
+    for (min = 0; values[min] == -1; min++)
+        ;
+    max = min - 1;
+    if ((message = delete_and_check(first, &min, &max, 0)) != NULL)
+        return message;
+
+    // Single element range
+    max = min;
+    if ((message = delete_and_check(first, &min, &max, 1)) != NULL)
+        return message;
+
+    // Random ranges, with or without callback
+    for (i = 0; i < 20; i++) {
+        min = rand() % MAX_KEY;
+        max = min + rand() % (MAX_KEY / 20);
+        if (max >= MAX_KEY)
+            max = MAX_KEY - 1;
+        if ((message = delete_and_check(first, &min, &max, i % 2)) != NULL)
+            return message;
+        if (i % 5 == 0)
+            fill_tree(first);
+    }
+
+    // Unbounded ranges
+    min = MAX_KEY - MAX_KEY / 10;
+    if ((message = delete_and_check(first, &min, NULL, 1)) != NULL)
+        return message;
+    max = MAX_KEY / 10;
+    if ((message = delete_and_check(first, NULL, &max, 0)) != NULL)
+        return message;
+    if ((message = delete_and_check(first, NULL, NULL, 1)) != NULL)
+        return message;
+    if (first->root != NULL) {
+        ELOG("Tree should be empty");
+        return "Tree should be empty";
+    }
+
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,219 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+static void tag_apply(void *data, void *summary, void *tag)
+{
+    (void) summary;
+    ((struct _tree_data *) data)->value += *((int *) tag);
+}
+
+static void tag_compose(void *tag, void *newer)
+{
+    *((int *) tag) += *((int *) newer);
+}
+
+#define MAX_ELEMENT 5000
+#define MAX_KEY     20000
+
+static int values[MAX_KEY];
+
+static int min_key(void)
+{
+    int key;
+
+    for (key = 0; key < MAX_KEY && values[key] == -1; key++)
+        ;
+    return key;
+}
+
+static int max_key(void)
+{
+    int key;
+
+    for (key = MAX_KEY - 1; key >= 0 && values[key] == -1; key--)
+        ;
+    return key;
+}
+
+static char *check_extremes(tree *t)
+{
+    struct _tree_data *min = peek_min(t);
+    struct _tree_data *max = peek_max(t);
+
+    verif_tree(t);
+    if (t->count == 0) {
+        if (min != NULL || max != NULL) {
+            ELOG("Extremes of empty tree");
+            return "Extremes of empty tree";
+        }
+        return NULL;
+    }
+    if (   min == NULL || min->key != min_key() || min->value != values[min->key]
+        || max == NULL || max->key != max_key() || max->value != values[max->key]) {
+        ELOG("Wrong extremes");
+        return "Wrong extremes";
+    }
+
+    return NULL;
+}
+
+char *priority_queue_tests()
+{
+    tree *first = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data *data;
+    char *message;
+    int add;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+    if (!set_lazy_update(first, sizeof(int), tag_apply, tag_compose)) {
+        ELOG("Can't set lazy update");
+        return "Can't set lazy update";
+    }
+
+    // Empty tree
+    if ((message = check_extremes(first)) != NULL)
+        return message;
+    if (pop_min(first) != NULL || pop_max(first) != NULL) {
+        ELOG("Pop in empty tree");
+        return "Pop in empty tree";
+    }
+
+    // Random insertions
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand() % 1000;
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+        if (i % 100 == 0 && (message = check_extremes(first)) != NULL)
+            return message;
+    }
+    if ((message = check_extremes(first)) != NULL)
+        return message;
+
+    // Pending updates reach extremes
+    add = 7;
+    update_range(first, NULL, NULL, &add);
+    for (i = 0; i < MAX_KEY; i++)
+        if (values[i] != -1)
+            values[i] += add;
+    if ((message = check_extremes(first)) != NULL)
+        return message;
+
+    // Pop and delete from both ends, interleaved with insertions
+    for (i = 0; first->count > 0; i++) {
+        if (i % 3 == 0) {
+            tmp_elmnt.key = rand() % MAX_KEY;
+            tmp_elmnt.value = rand() % 1000;
+            if (values[tmp_elmnt.key] == -1) {
+                insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+                values[tmp_elmnt.key] = tmp_elmnt.value;
+            }
+        }
+        switch (rand() % 4) {
+        case 0:
+            data = pop_min(first);
+            if (data == NULL || data->key != min_key()) {
+                ELOG("Wrong minimum popped");
+                return "Wrong minimum popped";
+            }
+            values[data->key] = -1;
+            free(data);
+            break;
+        case 1:
+            data = pop_max(first);
+            if (data == NULL || data->key != max_key()) {
+                ELOG("Wrong maximum popped");
+                return "Wrong maximum popped";
+            }
+            values[data->key] = -1;
+            free(data);
+            break;
+        case 2:
+            values[min_key()] = -1;
+            delete_node_min(first);
+            break;
+        default:
+            values[max_key()] = -1;
+            delete_node_max(first);
+            break;
+        }
+        if (i % 50 == 0 && (message = check_extremes(first)) != NULL)
+            return message;
+    }
+    if ((message = check_extremes(first)) != NULL)
+        return message;
+
+    delete_tree(first);
+
+    return NULL;
+}
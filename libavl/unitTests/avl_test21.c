@@ -0,0 +1,265 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+struct _tree_summary {
+    long sum;
+    unsigned int count;
+};
+
+static unsigned long comparisons = 0;
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    comparisons++;
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+static void summary_combine(void *summary, void *left, void *data, void *right)
+{
+    struct _tree_summary *s = (struct _tree_summary *) summary;
+    struct _tree_summary *l = (struct _tree_summary *) left;
+    struct _tree_summary *r = (struct _tree_summary *) right;
+
+    s->sum = ((struct _tree_data *) data)->value;
+    s->count = 1;
+    if (l != NULL) {
+        s->sum += l->sum;
+        s->count += l->count;
+    }
+    if (r != NULL) {
+        s->sum += r->sum;
+        s->count += r->count;
+    }
+}
+
+#define MAX_ELEMENT 20000
+#define MAX_KEY     100000
+#define WINDOW      1000
+
+static int values[MAX_KEY];
+
+static char *check_tree(tree *t)
+{
+    struct _tree_data tmp_elmnt;
+    struct _tree_summary summary;
+    unsigned int count = 0;
+    long sum = 0;
+    int key;
+
+    verif_tree(t);
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp_elmnt.key = key;
+        if (get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (values[key] != -1)) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        if (values[key] == -1)
+            continue;
+        if (tmp_elmnt.value != values[key]) {
+            ELOG("Wrong value in tree");
+            return "Wrong value in tree";
+        }
+        count++;
+        sum += values[key];
+    }
+    if (t->count != count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+    if (   count > 0 && t->summary_size > 0
+        && (   !aggregate_range(t, NULL, NULL, &summary)
+            || summary.count != count || summary.sum != sum)) {
+        ELOG("Wrong summary of tree");
+        return "Wrong summary of tree";
+    }
+
+    return NULL;
+}
+
+static void clear_tree(tree *t)
+{
+    int key;
+
+    delete_range(t, NULL, NULL, NULL, NULL);
+    for (key = 0; key < MAX_KEY; key++)
+        values[key] = -1;
+}
+
+static void add(tree *t, int key, int hint)
+{
+    struct _tree_data tmp_elmnt;
+
+    tmp_elmnt.key = key;
+    tmp_elmnt.value = rand() % 1000;
+    if (hint)
+        insert_elmt_hint(t, &tmp_elmnt, sizeof(struct _tree_data));
+    else
+        insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+    if (values[key] == -1)
+        values[key] = tmp_elmnt.value;
+}
+
+static char *hint_and_check(tree *first)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int lost = 0;
+    char *message;
+    int key;
+    int i;
+
+    clear_tree(first);
+
+    // Increasing keys are appended with a single comparison
+    comparisons = 0;
+    for (i = 0; i < MAX_ELEMENT; i++)
+        add(first, i * 2, 0);
+    if (comparisons > MAX_ELEMENT) {
+        ELOG("Too many comparisons to append: %lu", comparisons);
+        return "Too many comparisons to append";
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Sliding window
+    clear_tree(first);
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        add(first, i, 0);
+        if (first->count > WINDOW) {
+            delete_node_min(first);
+            values[i - WINDOW] = -1;
+            lost += first->finger_depth == 0;
+        }
+        if (i % 500 == 0)
+            verif_tree(first);
+    }
+    // appends go on from finger, unless a summary must reach root
+    if (first->summary_size == 0 && lost > MAX_ELEMENT / 10) {
+        ELOG("Finger lost by %u deletions of minimum", lost);
+        return "Finger lost by deletions of minimum";
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Nearly sorted keys with hint, some of them already in tree
+    clear_tree(first);
+    comparisons = 0;
+    for (i = 0, key = 0; i < MAX_ELEMENT; i++) {
+        add(first, key + rand() % 20, 1);
+        key += 4;
+    }
+    if (comparisons > 8 * MAX_ELEMENT) {
+        ELOG("Too many comparisons with hint: %lu", comparisons);
+        return "Too many comparisons with hint";
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Random keys with hint, mixed with other modifications
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        key = rand() % MAX_KEY;
+        switch (rand() % 8) {
+        case 0:
+            tmp_elmnt.key = key;
+            delete_node(first, &tmp_elmnt);
+            values[key] = -1;
+            break;
+        case 1:
+            add(first, key, 0);
+            break;
+        case 2:
+            add(first, MAX_KEY - 1 - rand() % 10, 0);
+            break;
+        default:
+            add(first, key, 1);
+            break;
+        }
+        if (i % 2000 == 0 && (message = check_tree(first)) != NULL)
+            return message;
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    return NULL;
+}
+
+char *insert_hint_tests()
+{
+    tree *first = NULL;
+    char *message;
+    int augmented;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    // Rebalancing stops early only without summary
+    for (augmented = 0; augmented < 2; augmented++) {
+        // Try to allocate a new tree.
+        first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+        if (first == NULL) {
+            ELOG("Init dictionnary error");
+            return "Init dictionnary error";
+        }
+        if (   augmented
+            && !set_augmentation(first, sizeof(struct _tree_summary), summary_combine)) {
+            ELOG("Augmentation not set");
+            return "Augmentation not set";
+        }
+
+        if ((message = hint_and_check(first)) != NULL)
+            return message;
+
+        delete_tree(first);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,234 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 5000
+#define MAX_KEY     20000
+
+static int values[MAX_KEY];
+
+struct _page {
+    int keys[MAX_KEY];
+    unsigned int size;
+    unsigned int stop;
+    int wrong;
+};
+
+static int scan_data(void *d, void *param)
+{
+    struct _page *p = (struct _page *) param;
+    struct _tree_data *data = (struct _tree_data *) d;
+
+    if (values[data->key] != data->value)
+        p->wrong = 1;
+    p->keys[p->size++] = data->key;
+
+    return p->stop > 0 && p->size == p->stop;
+}
+
+static struct _page page;
+static int expected[MAX_KEY];
+
+static char *scan_and_check(tree *t, int *min, int *max, unsigned int flags,
+        unsigned int limit, unsigned int stop)
+{
+    struct _tree_data data_min, data_max;
+    struct _tree_data *next;
+    unsigned int size = 0;
+    unsigned int wanted;
+    unsigned int result;
+    unsigned int i;
+    int low = min != NULL ? *min + ((flags & SCAN_EXCLUDE_MIN) != 0) : 0;
+    int high = max != NULL ? *max - ((flags & SCAN_EXCLUDE_MAX) != 0) : MAX_KEY - 1;
+    int key;
+
+    // expected elements in scan order
+    for (key = low; key <= high; key++)
+        if (values[key] != -1)
+            expected[size++] = key;
+    if (flags & SCAN_REVERSE)
+        for (i = 0; i < size / 2; i++) {
+            key = expected[i];
+            expected[i] = expected[size - 1 - i];
+            expected[size - 1 - i] = key;
+        }
+
+    wanted = size;
+    if (limit > 0 && limit < wanted)
+        wanted = limit;
+    if (stop > 0 && stop < wanted)
+        wanted = stop;
+
+    data_min.key = min != NULL ? *min : 0;
+    data_max.key = max != NULL ? *max : 0;
+    page.size = 0;
+    page.stop = stop;
+    page.wrong = 0;
+    result = scan_range(t, min != NULL ? &data_min : NULL,
+                        max != NULL ? &data_max : NULL, flags, limit,
+                        scan_data, &page, (void **) &next);
+
+    if (result != wanted || page.size != wanted || page.wrong) {
+        ELOG("Wrong number of scanned element");
+        return "Wrong number of scanned element";
+    }
+    for (i = 0; i < wanted; i++)
+        if (page.keys[i] != expected[i]) {
+            ELOG("Wrong scanned element");
+            return "Wrong scanned element";
+        }
+    if (wanted < size ? next == NULL || next->key != expected[wanted] : next != NULL) {
+        ELOG("Wrong next element");
+        return "Wrong next element";
+    }
+
+    return NULL;
+}
+
+static int random_bound(int *bound)
+{
+    *bound = rand() % MAX_KEY;
+    if (rand() % 3 == 0)
+        // bound in tree
+        while (*bound < MAX_KEY - 1 && values[*bound] == -1)
+            (*bound)++;
+    return rand() % 8 != 0;
+}
+
+char *scan_range_tests()
+{
+    tree *first = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data data_next;
+    struct _tree_data *next;
+    char *message;
+    unsigned int total;
+    int min, max;
+    int has_min, has_max;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+
+    // Empty tree
+    min = 0; max = MAX_KEY - 1;
+    if ((message = scan_and_check(first, &min, &max, 0, 0, 0)) != NULL)
+        return message;
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand();
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+    verif_tree(first);
+
+    // Random ranges with all options
+    for (i = 0; i < 2000; i++) {
+        has_min = random_bound(&min);
+        has_max = random_bound(&max);
+        if (has_min && has_max && min > max && rand() % 4 != 0) {
+            int swap = min;
+            min = max;
+            max = swap;
+        }
+        if ((message = scan_and_check(first,
+                                      has_min ? &min : NULL,
+                                      has_max ? &max : NULL,
+                                      (unsigned) rand() % 8,
+                                      rand() % 2 ? (unsigned) rand() % 50 : 0,
+                                      rand() % 4 ? 0 : (unsigned) rand() % 50)) != NULL)
+            return message;
+    }
+
+    // Whole tree in pages, in decreasing order
+    total = 0;
+    next = NULL;
+    do {
+        page.size = 0;
+        page.stop = 0;
+        if (next != NULL)
+            data_next = *next;
+        total += scan_range(first, NULL, next != NULL ? &data_next : NULL,
+                            SCAN_REVERSE, 100, scan_data, &page,
+                            (void **) &next);
+        if (page.size > 100) {
+            ELOG("Page too big");
+            return "Page too big";
+        }
+    } while (next != NULL);
+    if (total != first->count) {
+        ELOG("Wrong number of element in pages");
+        return "Wrong number of element in pages";
+    }
+
+    delete_tree(first);
+
+    return NULL;
+}
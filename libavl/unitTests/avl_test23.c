@@ -0,0 +1,167 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static unsigned long comparisons = 0;
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    comparisons++;
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 20000
+#define MAX_KEY     50000
+#define MAX_COMPARE 100
+
+static int values[MAX_KEY];
+static int last_key;
+
+static int check_data(void *d, void *param)
+{
+    struct _tree_data *data = (struct _tree_data *) d;
+    int *wrong = (int *) param;
+
+    if (data->key <= last_key || values[data->key] != data->value)
+        *wrong = 1;
+    last_key = data->key;
+
+    return 1;
+}
+
+char *range_compare_tests()
+{
+    tree *first = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data data_min, data_max;
+    int expected;
+    int result;
+    int wrong;
+    int key;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand();
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+    verif_tree(first);
+
+    // Wide ranges only compare nodes of boundary paths
+    for (i = 0; i < 100; i++) {
+        struct _tree_data *min = i % 5 == 0 ? NULL : &data_min;
+        struct _tree_data *max = i % 7 == 0 ? NULL : &data_max;
+
+        data_min.key = rand() % (MAX_KEY / 2);
+        data_max.key = data_min.key + rand() % (MAX_KEY / 2);
+        expected = 0;
+        for (key = min != NULL ? min->key : 0;
+             key <= (max != NULL ? max->key : MAX_KEY - 1);
+             key++)
+            expected += values[key] != -1;
+
+        wrong = 0;
+        last_key = -1;
+        comparisons = 0;
+        result = explore_restrain_tree(first, check_data, &wrong, min, max);
+        if (result != expected || wrong) {
+            ELOG("Wrong elements in range");
+            return "Wrong elements in range";
+        }
+        if (comparisons > MAX_COMPARE) {
+            ELOG("Too many comparisons in explore_restrain_tree: %lu", comparisons);
+            return "Too many comparisons in explore_restrain_tree";
+        }
+
+        comparisons = 0;
+        result = (int) scan_range(first, min, max, 0, 0,
+                                  NULL, NULL, NULL);
+        if (result != expected) {
+            ELOG("Wrong number of elements in scan");
+            return "Wrong number of elements in scan";
+        }
+        if (comparisons > MAX_COMPARE) {
+            ELOG("Too many comparisons in scan_range: %lu", comparisons);
+            return "Too many comparisons in scan_range";
+        }
+    }
+
+    // Unbounded range is the whole tree, without comparison
+    wrong = 0;
+    last_key = -1;
+    comparisons = 0;
+    result = explore_restrain_tree(first, check_data, &wrong, NULL, NULL);
+    if ((unsigned) result != first->count || wrong || comparisons != 0) {
+        ELOG("Wrong exploration of unbounded range");
+        return "Wrong exploration of unbounded range";
+    }
+
+    delete_tree(first);
+
+    return NULL;
+}
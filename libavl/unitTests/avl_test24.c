@@ -0,0 +1,177 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 10000
+#define MAX_KEY     30000
+#define MAX_CHUNK   100
+
+static int values[MAX_KEY];
+static void *out[MAX_CHUNK];
+
+static char *collect_and_check(tree *t, int *min, int *max, unsigned int cap,
+        int abort)
+{
+    struct _tree_data data_min, data_max;
+    range_cursor cursor;
+    unsigned int chunks = 0;
+    unsigned int count;
+    unsigned int i;
+    int key = min != NULL ? *min : 0;
+    int high = max != NULL ? *max : MAX_KEY - 1;
+
+    data_min.key = key;
+    data_max.key = high;
+    count = collect_range(t, min != NULL ? &data_min : NULL,
+                          max != NULL ? &data_max : NULL, out, cap, &cursor);
+    while (count > 0) {
+        if (count > cap) {
+            ELOG("Chunk too big");
+            return "Chunk too big";
+        }
+        for (i = 0; i < count; i++) {
+            struct _tree_data *d = (struct _tree_data *) out[i];
+
+            // next expected key
+            while (key <= high && values[key] == -1)
+                key++;
+            if (key > high || d->key != key || d->value != values[key]) {
+                ELOG("Wrong collected element");
+                return "Wrong collected element";
+            }
+            key++;
+        }
+        if (abort && ++chunks == 2) {
+            release_cursor(&cursor);
+            return NULL;
+        }
+        count = collect_next(t, out, cap, &cursor);
+    }
+
+    // whole range was collected
+    while (key <= high && values[key] == -1)
+        key++;
+    if (key <= high) {
+        ELOG("Missing element in range");
+        return "Missing element in range";
+    }
+
+    return NULL;
+}
+
+char *collect_range_tests()
+{
+    tree *first = NULL;
+    struct _tree_data tmp_elmnt;
+    char *message;
+    int min, max;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Try to allocate a new tree.
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (first == NULL) {
+        ELOG("Init dictionnary error");
+        return "Init dictionnary error";
+    }
+
+    // Empty tree
+    if ((message = collect_and_check(first, NULL, NULL, 10, 0)) != NULL)
+        return message;
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand();
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+    verif_tree(first);
+
+    // Whole tree, then random ranges by chunks of random size
+    if ((message = collect_and_check(first, NULL, NULL, MAX_CHUNK, 0)) != NULL)
+        return message;
+    for (i = 0; i < 500; i++) {
+        min = rand() % MAX_KEY;
+        max = min + rand() % (MAX_KEY / 10) - MAX_KEY / 100;
+        if (max >= MAX_KEY)
+            max = MAX_KEY - 1;
+        if ((message = collect_and_check(first,
+                                         i % 10 == 1 ? NULL : &min,
+                                         i % 10 == 2 ? NULL : &max,
+                                         1 + (unsigned) rand() % MAX_CHUNK,
+                                         i % 10 == 3)) != NULL)
+            return message;
+    }
+
+    // Single chunk without cursor
+    if (   collect_range(first, NULL, NULL, out, 1, NULL) != 1
+        || out[0] != peek_min(first)) {
+        ELOG("Wrong chunk without cursor");
+        return "Wrong chunk without cursor";
+    }
+
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,295 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+static void summary_combine(void *summary, void *left, void *data, void *right)
+{
+    (void) left;
+    (void) data;
+    (void) right;
+    *((int *) summary) = 0;
+}
+
+#define MAX_ELEMENT 5000
+#define MAX_KEY     10000
+
+static int values[MAX_KEY];
+static void *found[MAX_KEY];
+static struct _tree_data keys[MAX_KEY];
+
+static int count_data(void *d, void *param)
+{
+    struct _tree_data *data = (struct _tree_data *) d;
+    int *wrong = (int *) param;
+
+    if (values[data->key] != data->value)
+        *wrong = 1;
+
+    return 1;
+}
+
+static char *check_tree(tree *t)
+{
+    struct _tree_data tmp_elmnt;
+    struct _tree_data *data;
+    unsigned int count = 0;
+    int wrong = 0;
+    int key;
+
+    verif_tree(t);
+    for (key = 0; key < MAX_KEY; key++) {
+        keys[key].key = key;
+        tmp_elmnt.key = key;
+        if (   is_present(t, &tmp_elmnt) != (values[key] != -1)
+            || get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (values[key] != -1)) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        if (values[key] != -1) {
+            if (tmp_elmnt.value != values[key]) {
+                ELOG("Wrong value in tree");
+                return "Wrong value in tree";
+            }
+            count++;
+        }
+    }
+    if (t->count != count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+
+    // Lookups and scans skip deleted elements
+    if (   lookup_batch(t, keys, MAX_KEY, sizeof(struct _tree_data), found) != count
+        || lookup_sorted_batch(t, keys, MAX_KEY, sizeof(struct _tree_data), found) != count
+        || scan_range(t, NULL, NULL, 0, 0, NULL, NULL, NULL) != count
+        || collect_range(t, NULL, NULL, found, MAX_KEY, NULL) != count
+        || (unsigned) explore_restrain_tree(t, count_data, &wrong, NULL, NULL) != count
+        || wrong) {
+        ELOG("Deleted element found");
+        return "Deleted element found";
+    }
+
+    // Extremes are not deleted
+    for (key = 0; key < MAX_KEY && values[key] == -1; key++)
+        ;
+    data = peek_min(t);
+    if (key < MAX_KEY ? data == NULL || data->key != key : data != NULL) {
+        ELOG("Wrong minimum");
+        return "Wrong minimum";
+    }
+    for (key = MAX_KEY - 1; key >= 0 && values[key] == -1; key--)
+        ;
+    data = peek_max(t);
+    if (key >= 0 ? data == NULL || data->key != key : data != NULL) {
+        ELOG("Wrong maximum");
+        return "Wrong maximum";
+    }
+
+    return NULL;
+}
+
+static void insert_random(tree *t, unsigned int count)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand() % 1000;
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        if (i % 2)
+            insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        else
+            insert_elmt_hint(t, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+}
+
+static void delete_random(tree *t, unsigned int count)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(t, &tmp_elmnt);
+        values[tmp_elmnt.key] = -1;
+    }
+}
+
+char *tombstone_tests()
+{
+    tree *first = NULL;
+    struct _tree_data *data;
+    char *message;
+    node root;
+    unsigned int dead;
+    int key;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Tombstones and summaries are exclusive
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (   !set_augmentation(first, sizeof(int), summary_combine)
+        || set_tombstones(first, 0)) {
+        ELOG("Tombstones set on augmented tree");
+        return "Tombstones set on augmented tree";
+    }
+    delete_tree(first);
+
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (   !set_tombstones(first, 0)
+        || set_augmentation(first, sizeof(int), summary_combine)) {
+        ELOG("Wrong tombstones setting");
+        return "Wrong tombstones setting";
+    }
+
+    // Deletion only marks nodes
+    insert_random(first, MAX_ELEMENT);
+    root = first->root;
+    delete_random(first, MAX_ELEMENT / 2);
+    if (first->root != root || first->dead == 0) {
+        ELOG("Tree changed by deletion");
+        return "Tree changed by deletion";
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Deleted elements are inserted again in their node
+    dead = first->dead;
+    insert_random(first, MAX_ELEMENT / 2);
+    if (first->dead >= dead) {
+        ELOG("Deleted node not used again");
+        return "Deleted node not used again";
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Pop skips deleted extremes
+    delete_random(first, MAX_ELEMENT / 2);
+    for (i = 0; i < 100; i++) {
+        data = i % 2 ? pop_max(first) : pop_min(first);
+        for (key = 0; key < MAX_KEY && values[key] == -1; key++)
+            ;
+        if (i % 2)
+            for (key = MAX_KEY - 1; key >= 0 && values[key] == -1; key--)
+                ;
+        if (data == NULL || data->key != key) {
+            ELOG("Wrong popped element");
+            return "Wrong popped element";
+        }
+        values[key] = -1;
+        free(data);
+        if (i % 10 == 0) {
+            for (key = 0; key < MAX_KEY && values[key] == -1; key++)
+                ;
+            values[key] = -1;
+            delete_node_min(first);
+        }
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Explicit compaction
+    dead = first->dead;
+    if (compact(first) != dead || first->dead != 0) {
+        ELOG("Wrong compaction");
+        return "Wrong compaction";
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    delete_tree(first);
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Compaction triggered by ratio
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (!set_tombstones(first, 25)) {
+        ELOG("Can't set tombstones");
+        return "Can't set tombstones";
+    }
+    for (i = 0; i < 20; i++) {
+        insert_random(first, MAX_ELEMENT / 4);
+        delete_random(first, MAX_ELEMENT / 4);
+        if (first->dead * 4 > first->count + first->dead) {
+            ELOG("Too many deleted nodes");
+            return "Too many deleted nodes";
+        }
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Deleted elements are dropped by range deletion
+    delete_range(first, NULL, NULL, NULL, NULL);
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+    if (first->root != NULL || first->count != 0 || first->dead != 0) {
+        ELOG("Tree not empty");
+        return "Tree not empty";
+    }
+
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,351 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 2000
+#define MAX_KEY     200
+#define MAX_EQUAL   64
+
+// Values of each key, in insertion order. Values are all distinct.
+static int values[MAX_KEY][MAX_EQUAL];
+static unsigned int counts[MAX_KEY];
+static int serial = 0;
+
+struct _check {
+    int key;
+    unsigned int rank;
+    int wrong;
+};
+
+static int check_equal(void *d, void *param)
+{
+    struct _tree_data *data = (struct _tree_data *) d;
+    struct _check *check = (struct _check *) param;
+
+    if (   data->key != check->key
+        || check->rank >= counts[check->key]
+        || data->value != values[check->key][check->rank])
+        check->wrong = 1;
+    check->rank++;
+
+    return 0;
+}
+
+static char *check_tree(tree *t)
+{
+    struct _tree_data tmp_elmnt;
+    struct _check check;
+    unsigned int count = 0;
+    int key;
+
+    verif_tree(t);
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp_elmnt.key = key;
+        check.key = key;
+        check.rank = 0;
+        check.wrong = 0;
+        if (   count_equal(t, &tmp_elmnt) != counts[key]
+            || equal_range(t, &tmp_elmnt, check_equal, &check) != counts[key]
+            || check.wrong) {
+            ELOG("Wrong equal elements in tree");
+            return "Wrong equal elements in tree";
+        }
+        if (   is_present(t, &tmp_elmnt) != (counts[key] != 0)
+            || get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (counts[key] != 0)
+            || (counts[key] != 0 && tmp_elmnt.value != values[key][0])) {
+            ELOG("Wrong first equal element");
+            return "Wrong first equal element";
+        }
+        count += counts[key];
+    }
+    if (t->count != count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+
+    return NULL;
+}
+
+static void model_insert(struct _tree_data *data)
+{
+    data->value = serial++;
+    values[data->key][counts[data->key]++] = data->value;
+}
+
+static void model_remove(int key, int value)
+{
+    unsigned int i;
+
+    for (i = 0; i < counts[key] && values[key][i] != value; i++)
+        ;
+    if (i == counts[key])
+        return;
+    memmove(&values[key][i], &values[key][i + 1],
+            (counts[key] - i - 1) * sizeof(int));
+    counts[key]--;
+}
+
+static int model_delete(void *d, void *param)
+{
+    struct _tree_data *data = (struct _tree_data *) d;
+
+    (void) param;
+    model_remove(data->key, data->value);
+
+    return 0;
+}
+
+static int remaining[MAX_EQUAL];
+
+static int collect_value(void *d, void *param)
+{
+    struct _tree_data *data = (struct _tree_data *) d;
+    struct _check *check = (struct _check *) param;
+    unsigned int i;
+
+    // Remaining values must keep their order, with one value missing.
+    for (i = check->rank; i < counts[check->key]; i++)
+        if (values[check->key][i] == data->value)
+            break;
+    if (i > check->rank + 1 || i == counts[check->key])
+        check->wrong = 1;
+    else
+        remaining[check->rank] = data->value;
+    check->rank++;
+
+    return 0;
+}
+
+static void removed_data(void *d, void *param)
+{
+    model_delete(d, param);
+    free(d);
+}
+
+static void insert_random(tree *t, unsigned int count)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        if (counts[tmp_elmnt.key] == MAX_EQUAL)
+            continue;
+        model_insert(&tmp_elmnt);
+        if (i % 2)
+            insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        else
+            insert_elmt_hint(t, &tmp_elmnt, sizeof(struct _tree_data));
+    }
+}
+
+static void insert_random_batch(tree *t, unsigned int count)
+{
+    struct _tree_data batch[MAX_ELEMENT];
+    int inserted[MAX_ELEMENT];
+    unsigned int size = 0;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        batch[size].key = rand() % MAX_KEY;
+        if (counts[batch[size].key] == MAX_EQUAL)
+            continue;
+        model_insert(&batch[size++]);
+    }
+    insert_batch(t, batch, size, sizeof(struct _tree_data), inserted);
+    for (i = 0; i < size; i++) {
+        if (!inserted[i]) {
+            // Make check fail on next call.
+            counts[batch[i].key]++;
+            return;
+        }
+    }
+}
+
+char *multimap_tests()
+{
+    tree *first = NULL;
+    tree *second = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data min;
+    struct _tree_data max;
+    struct _check check;
+    char *message;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    // Multimap and tombstones are exclusive
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (!set_tombstones(first, 0) || set_multimap(first)) {
+        ELOG("Multimap set with tombstones");
+        return "Multimap set with tombstones";
+    }
+    delete_tree(first);
+
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (!set_multimap(first) || set_tombstones(first, 0)) {
+        ELOG("Wrong multimap setting");
+        return "Wrong multimap setting";
+    }
+
+    // Equal elements are kept in insertion order
+    insert_random(first, MAX_ELEMENT);
+    if ((message = check_tree(first)) != NULL)
+        return message;
+    insert_random_batch(first, MAX_ELEMENT / 10);
+    if ((message = check_tree(first)) != NULL)
+        return message;
+    insert_random_batch(first, MAX_ELEMENT);
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Deletion removes one equal element, others stay in order
+    for (i = 0; i < MAX_ELEMENT / 2; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        if (counts[tmp_elmnt.key] == 0)
+            continue;
+        delete_node(first, &tmp_elmnt);
+        check.key = tmp_elmnt.key;
+        check.rank = 0;
+        check.wrong = 0;
+        equal_range(first, &tmp_elmnt, collect_value, &check);
+        if (check.wrong || check.rank + 1 != counts[tmp_elmnt.key]) {
+            ELOG("Wrong deletion");
+            return "Wrong deletion";
+        }
+        memcpy(values[tmp_elmnt.key], remaining, check.rank * sizeof(int));
+        counts[tmp_elmnt.key] = check.rank;
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Range deletion removes all equal elements of bounds
+    min.key = rand() % (MAX_KEY / 2);
+    max.key = min.key + rand() % (MAX_KEY / 2);
+    delete_range(first, &min, &max, removed_data, NULL);
+    for (i = min.key; i <= max.key; i++) {
+        if (counts[i] != 0) {
+            ELOG("Element left in deleted range");
+            return "Element left in deleted range";
+        }
+    }
+    if ((message = check_tree(first)) != NULL)
+        return message;
+    insert_random(first, MAX_ELEMENT);
+    if ((message = check_tree(first)) != NULL)
+        return message;
+
+    // Split moves equal elements in greater tree
+    do
+        tmp_elmnt.key = rand() % MAX_KEY;
+    while (counts[tmp_elmnt.key] == MAX_EQUAL);
+    second = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_multimap(second);
+    if (split_tree(first, &tmp_elmnt, second, NULL)) {
+        ELOG("Element found by split");
+        return "Element found by split";
+    }
+    verif_tree(first);
+    verif_tree(second);
+    if (   scan_range(first, NULL, &tmp_elmnt, SCAN_EXCLUDE_MAX, 0,
+                      NULL, NULL, NULL) != first->count
+        || scan_range(second, &tmp_elmnt, NULL, 0, 0, NULL, NULL, NULL) != second->count
+        || count_equal(second, &tmp_elmnt) != counts[tmp_elmnt.key]) {
+        ELOG("Wrong split");
+        return "Wrong split";
+    }
+
+    // Join puts element between both trees
+    model_insert(&tmp_elmnt);
+    if (counts[tmp_elmnt.key] > 1) {
+        memmove(&values[tmp_elmnt.key][1], &values[tmp_elmnt.key][0],
+                (counts[tmp_elmnt.key] - 1) * sizeof(int));
+        values[tmp_elmnt.key][0] = tmp_elmnt.value;
+    }
+    join_tree(first, &tmp_elmnt, sizeof(struct _tree_data), second);
+    if ((message = check_tree(first)) != NULL)
+        return message;
+    delete_tree(second);
+
+    // Set operations are not available
+    second = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_multimap(second);
+    tmp_elmnt.key = 0;
+    insert_elmt(second, &tmp_elmnt, sizeof(struct _tree_data));
+    if (   union_tree(first, second) != first->count
+        || intersection_tree(first, second) != first->count
+        || difference_tree(first, second) != first->count
+        || second->count != 1) {
+        ELOG("Set operation on multimap");
+        return "Set operation on multimap";
+    }
+    delete_tree(second);
+
+    // Whole tree is scanned in order
+    scan_range(first, NULL, NULL, 0, 0, model_delete, NULL, NULL);
+    for (i = 0; i < MAX_KEY; i++) {
+        if (counts[i] != 0) {
+            ELOG("Element not scanned");
+            return "Element not scanned";
+        }
+    }
+
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,328 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+static void tag_apply(void *data, void *summary, void *tag)
+{
+    (void) data;
+    (void) summary;
+    (void) tag;
+}
+
+static void tag_compose(void *tag, void *newer)
+{
+    (void) tag;
+    (void) newer;
+}
+
+#define MAX_ELEMENT 2000
+#define MAX_KEY     5000
+
+static int values[MAX_KEY];
+static int frozen[MAX_KEY];
+static int oldest[MAX_KEY];
+static node nodes[MAX_KEY];
+
+static char *check_tree(tree *t, int *model)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int count = 0;
+    int key;
+
+    verif_tree(t);
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp_elmnt.key = key;
+        if (get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (model[key] != -1)) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        if (model[key] != -1) {
+            if (tmp_elmnt.value != model[key]) {
+                ELOG("Wrong value in tree");
+                return "Wrong value in tree";
+            }
+            count++;
+        }
+    }
+    if (   t->count != count
+        || scan_range(t, NULL, NULL, 0, 0, NULL, NULL, NULL) != count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+
+    return NULL;
+}
+
+static void list_nodes(node n, unsigned int *count)
+{
+    if (n == NULL)
+        return;
+    list_nodes(n->left, count);
+    nodes[(*count)++] = n;
+    list_nodes(n->right, count);
+}
+
+static int node_cmp(const void *a, const void *b)
+{
+    node na = *((const node *) a);
+    node nb = *((const node *) b);
+
+    return (na > nb) - (na < nb);
+}
+
+static unsigned int count_copies_recur(node n, unsigned int size)
+{
+    if (n == NULL)
+        return 0;
+
+    return (bsearch(&n, nodes, size, sizeof(node), node_cmp) == NULL)
+         + count_copies_recur(n->left, size)
+         + count_copies_recur(n->right, size);
+}
+
+// Count nodes of t which are not shared with s.
+static unsigned int count_copies(tree *t, tree *s)
+{
+    unsigned int size = 0;
+
+    list_nodes(s->root, &size);
+    qsort(nodes, size, sizeof(node), node_cmp);
+
+    return count_copies_recur(t->root, size);
+}
+
+static void insert_random(tree *t, unsigned int count)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand() % 1000;
+        if (values[tmp_elmnt.key] != -1)
+            continue;
+        if (i % 2)
+            insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        else
+            insert_elmt_hint(t, &tmp_elmnt, sizeof(struct _tree_data));
+        values[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+}
+
+static void delete_random(tree *t, unsigned int count)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(t, &tmp_elmnt);
+        values[tmp_elmnt.key] = -1;
+    }
+}
+
+static void removed_data(void *d, void *param)
+{
+    (void) param;
+    values[((struct _tree_data *) d)->key] = -1;
+    free(d);
+}
+
+char *persistent_tests()
+{
+    tree *first = NULL;
+    tree *second = NULL;
+    tree *frozen_tree = NULL;
+    tree *other = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data min;
+    struct _tree_data max;
+    struct _tree_data *data;
+    char *message;
+    unsigned int height;
+    int key;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        values[i] = -1;
+
+    // Persistence is exclusive with tombstones and lazy update
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (   snapshot(first) != NULL
+        || !set_tombstones(first, 0)
+        || set_persistent(first, sizeof(struct _tree_data))) {
+        ELOG("Persistence set with tombstones");
+        return "Persistence set with tombstones";
+    }
+    delete_tree(first);
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (   !set_persistent(first, sizeof(struct _tree_data))
+        || set_lazy_update(first, sizeof(int), tag_apply, tag_compose)
+        || set_tombstones(first, 0)) {
+        ELOG("Wrong persistence setting");
+        return "Wrong persistence setting";
+    }
+
+    // Snapshot is not changed by insertions and deletions
+    insert_random(first, MAX_ELEMENT);
+    frozen_tree = snapshot(first);
+    memcpy(oldest, values, sizeof(values));
+    insert_random(first, MAX_ELEMENT);
+    delete_random(first, MAX_ELEMENT);
+    if ((message = check_tree(first, values)) != NULL)
+        return message;
+    if ((message = check_tree(frozen_tree, oldest)) != NULL)
+        return message;
+
+    // Only path of modification is copied
+    second = snapshot(first);
+    do
+        tmp_elmnt.key = rand() % MAX_KEY;
+    while (values[tmp_elmnt.key] != -1);
+    tmp_elmnt.value = 0;
+    height = first->root->height;
+    insert_elmt(first, &tmp_elmnt, sizeof(struct _tree_data));
+    values[tmp_elmnt.key] = 0;
+    if (count_copies(first, second) > height + 2) {
+        ELOG("Too many nodes copied by insertion");
+        return "Too many nodes copied by insertion";
+    }
+    delete_tree(second);
+    second = snapshot(first);
+    height = first->root->height;
+    delete_node(first, &tmp_elmnt);
+    values[tmp_elmnt.key] = -1;
+    if (count_copies(first, second) > 2 * height) {
+        ELOG("Too many nodes copied by deletion");
+        return "Too many nodes copied by deletion";
+    }
+    delete_tree(second);
+
+    // Data given back is a copy while it is shared
+    second = snapshot(first);
+    memcpy(frozen, values, sizeof(values));
+    for (i = 0; i < 10; i++) {
+        data = i % 2 ? pop_max(first) : pop_min(first);
+        if (data == NULL || values[data->key] != data->value) {
+            ELOG("Wrong popped element");
+            return "Wrong popped element";
+        }
+        values[data->key] = -1;
+        free(data);
+    }
+    delete_node_min(first);
+    delete_node_max(first);
+    for (key = 0; values[key] == -1; key++)
+        ;
+    values[key] = -1;
+    for (key = MAX_KEY - 1; values[key] == -1; key--)
+        ;
+    values[key] = -1;
+    if ((message = check_tree(first, values)) != NULL)
+        return message;
+    if ((message = check_tree(second, frozen)) != NULL)
+        return message;
+
+    // Other modifications copy shared nodes first
+    min.key = rand() % (MAX_KEY / 2);
+    max.key = min.key + rand() % (MAX_KEY / 2);
+    delete_range(first, &min, &max, removed_data, NULL);
+    if ((message = check_tree(first, values)) != NULL)
+        return message;
+    if ((message = check_tree(second, frozen)) != NULL)
+        return message;
+    delete_tree(second);
+
+    second = snapshot(first);
+    memcpy(frozen, values, sizeof(values));
+    other = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_persistent(other, sizeof(struct _tree_data));
+    tmp_elmnt.key = rand() % MAX_KEY;
+    split_tree(first, &tmp_elmnt, other, (void **) &data);
+    if (values[tmp_elmnt.key] != -1) {
+        if (data->value != values[tmp_elmnt.key]) {
+            ELOG("Wrong element found by split");
+            return "Wrong element found by split";
+        }
+        free(data);
+        values[tmp_elmnt.key] = -1;
+    }
+    join_tree(first, NULL, 0, other);
+    delete_tree(other);
+    insert_random(first, MAX_ELEMENT);
+    if ((message = check_tree(first, values)) != NULL)
+        return message;
+    if ((message = check_tree(second, frozen)) != NULL)
+        return message;
+
+    // Snapshots are released in any order
+    other = snapshot(second);
+    delete_tree(second);
+    if ((message = check_tree(other, frozen)) != NULL)
+        return message;
+    delete_tree(first);
+    if ((message = check_tree(other, frozen)) != NULL)
+        return message;
+    delete_tree(other);
+    if ((message = check_tree(frozen_tree, oldest)) != NULL)
+        return message;
+    delete_tree(frozen_tree);
+
+    return NULL;
+}
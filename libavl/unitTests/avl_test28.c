@@ -0,0 +1,324 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 4000
+#define MAX_KEY     10000
+#define MAX_CHANGES 20
+
+// Expected elements of each tree, -1 when key is not in tree.
+static int first_model[MAX_KEY];
+static int second_model[MAX_KEY];
+static int third_model[MAX_KEY];
+static node nodes[MAX_KEY];
+
+static char *check_tree(tree *t, int *model)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int count = 0;
+    int key;
+
+    verif_tree(t);
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp_elmnt.key = key;
+        if (get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (model[key] != -1)) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        if (model[key] != -1) {
+            if (tmp_elmnt.value != model[key]) {
+                ELOG("Wrong value in tree");
+                return "Wrong value in tree";
+            }
+            count++;
+        }
+    }
+    if (   t->count != count
+        || scan_range(t, NULL, NULL, 0, 0, NULL, NULL, NULL) != count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+
+    return NULL;
+}
+
+static void list_nodes(node n, unsigned int *count)
+{
+    if (n == NULL)
+        return;
+    list_nodes(n->left, count);
+    nodes[(*count)++] = n;
+    list_nodes(n->right, count);
+}
+
+static int node_cmp(const void *a, const void *b)
+{
+    node na = *((const node *) a);
+    node nb = *((const node *) b);
+
+    return (na > nb) - (na < nb);
+}
+
+static unsigned int count_copies_recur(node n, unsigned int size)
+{
+    if (n == NULL)
+        return 0;
+
+    return (bsearch(&n, nodes, size, sizeof(node), node_cmp) == NULL)
+         + count_copies_recur(n->left, size)
+         + count_copies_recur(n->right, size);
+}
+
+// Count nodes of t which are not shared with s.
+static unsigned int count_copies(tree *t, tree *s)
+{
+    unsigned int size = 0;
+
+    list_nodes(s->root, &size);
+    qsort(nodes, size, sizeof(node), node_cmp);
+
+    return count_copies_recur(t->root, size);
+}
+
+static void insert_random(tree *t, int *model, unsigned int count)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = rand() % 1000;
+        if (model[tmp_elmnt.key] != -1)
+            continue;
+        insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        model[tmp_elmnt.key] = tmp_elmnt.value;
+    }
+}
+
+static void delete_random(tree *t, int *model, unsigned int count)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(t, &tmp_elmnt);
+        model[tmp_elmnt.key] = -1;
+    }
+}
+
+static void insert_random_batch(tree *t, int *model, unsigned int count)
+{
+    static struct _tree_data batch[MAX_ELEMENT];
+    unsigned int size = 0;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        batch[size].key = rand() % MAX_KEY;
+        batch[size].value = rand() % 1000;
+        if (model[batch[size].key] != -1)
+            continue;
+        model[batch[size].key] = batch[size].value;
+        size++;
+    }
+    insert_batch(t, batch, size, sizeof(struct _tree_data), NULL);
+}
+
+static void removed_data(void *d, void *param)
+{
+    int *model = (int *) param;
+
+    model[((struct _tree_data *) d)->key] = -1;
+    free(d);
+}
+
+char *clone_tests()
+{
+    tree *first = NULL;
+    tree *second = NULL;
+    tree *third = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data min;
+    struct _tree_data max;
+    char *message;
+    unsigned int height;
+    unsigned int copies;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        first_model[i] = -1;
+
+    // Only persistent trees can be cloned
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (clone_tree(first) != NULL) {
+        ELOG("Tree cloned");
+        return "Tree cloned";
+    }
+    delete_tree(first);
+
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_persistent(first, sizeof(struct _tree_data));
+    insert_random(first, first_model, MAX_ELEMENT);
+
+    // Clone only copies nodes it changes
+    second = clone_tree(first);
+    memcpy(second_model, first_model, sizeof(first_model));
+    if (second == NULL || count_copies(second, first) != 0) {
+        ELOG("Wrong clone");
+        return "Wrong clone";
+    }
+    height = first->root->height;
+    insert_random(second, second_model, MAX_CHANGES);
+    delete_random(second, second_model, MAX_CHANGES);
+    if (count_copies(second, first) > 4 * MAX_CHANGES * (height + 1)) {
+        ELOG("Too many nodes copied");
+        return "Too many nodes copied";
+    }
+    if ((message = check_tree(second, second_model)) != NULL)
+        return message;
+    if ((message = check_tree(first, first_model)) != NULL)
+        return message;
+
+    // Range deletion only copies borders of range
+    copies = count_copies(second, first);
+    min.key = rand() % (MAX_KEY / 2);
+    max.key = min.key + rand() % (MAX_KEY / 2);
+    delete_range(second, &min, &max, removed_data, second_model);
+    if (count_copies(second, first) > copies + 8 * (height + 1)) {
+        ELOG("Too many nodes copied by range deletion");
+        return "Too many nodes copied by range deletion";
+    }
+    if ((message = check_tree(second, second_model)) != NULL)
+        return message;
+    if ((message = check_tree(first, first_model)) != NULL)
+        return message;
+
+    // Original is modified independently
+    insert_random(first, first_model, MAX_CHANGES);
+    delete_random(first, first_model, MAX_CHANGES);
+    delete_range(first, &min, &max, NULL, NULL);
+    for (i = min.key; i <= max.key; i++)
+        first_model[i] = -1;
+    if ((message = check_tree(second, second_model)) != NULL)
+        return message;
+    if ((message = check_tree(first, first_model)) != NULL)
+        return message;
+    delete_tree(first);
+
+    // Batches, splits and joins on clones
+    third = clone_tree(second);
+    memcpy(third_model, second_model, sizeof(second_model));
+    insert_random_batch(third, third_model, MAX_CHANGES);
+    insert_random_batch(third, third_model, MAX_ELEMENT);
+    first = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_persistent(first, sizeof(struct _tree_data));
+    tmp_elmnt.key = rand() % MAX_KEY;
+    tmp_elmnt.value = 0;
+    split_tree(third, &tmp_elmnt, first, NULL);
+    join_tree(third, &tmp_elmnt, sizeof(struct _tree_data), first);
+    third_model[tmp_elmnt.key] = 0;
+    if ((message = check_tree(third, third_model)) != NULL)
+        return message;
+    if ((message = check_tree(second, second_model)) != NULL)
+        return message;
+    delete_tree(first);
+
+    // Set operations on trees sharing nodes
+    first = clone_tree(second);
+    memcpy(first_model, second_model, sizeof(second_model));
+    delete_random(first, first_model, MAX_ELEMENT / 4);
+    intersection_tree(third, first);
+    for (i = 0; i < MAX_KEY; i++)
+        if (first_model[i] == -1)
+            third_model[i] = -1;
+    if (   (message = check_tree(third, third_model)) != NULL
+        || (message = check_tree(second, second_model)) != NULL)
+        return message;
+    delete_tree(first);
+
+    first = clone_tree(second);
+    memcpy(first_model, second_model, sizeof(second_model));
+    insert_random(first, first_model, MAX_CHANGES);
+    delete_random(third, third_model, MAX_CHANGES);
+    union_tree(third, first);
+    for (i = 0; i < MAX_KEY; i++)
+        if (third_model[i] == -1)
+            third_model[i] = first_model[i];
+    if (   (message = check_tree(third, third_model)) != NULL
+        || (message = check_tree(second, second_model)) != NULL)
+        return message;
+    delete_tree(first);
+
+    first = clone_tree(third);
+    memcpy(first_model, third_model, sizeof(third_model));
+    delete_random(third, third_model, MAX_ELEMENT / 4);
+    difference_tree(first, third);
+    for (i = 0; i < MAX_KEY; i++)
+        if (third_model[i] != -1)
+            first_model[i] = -1;
+    if (   (message = check_tree(first, first_model)) != NULL
+        || (message = check_tree(second, second_model)) != NULL)
+        return message;
+
+    delete_tree(third);
+    delete_tree(second);
+    delete_tree(first);
+
+    return NULL;
+}
@@ -0,0 +1,260 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 10000
+#define MAX_KEY     30000
+
+// Expected elements of tree, -1 when key is not in tree.
+static int model[MAX_KEY];
+
+static char *check_tree(tree *t, int *m)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int count = 0;
+    int key;
+
+    verif_tree(t);
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp_elmnt.key = key;
+        if (get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (m[key] != -1)) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        if (m[key] != -1)
+            count++;
+    }
+    if (   t->count != count
+        || scan_range(t, NULL, NULL, 0, 0, NULL, NULL, NULL) != count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+
+    return NULL;
+}
+
+static int same_shape(node a, node b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+
+    return    a->height == b->height
+           && data_cmp(a->data, b->data) == 0
+           && same_shape(a->left, b->left)
+           && same_shape(a->right, b->right);
+}
+
+static void removed_data(void *d, void *param)
+{
+    int *m = (int *) param;
+
+    m[((struct _tree_data *) d)->key] = -1;
+    free(d);
+}
+
+char *wavl_tests()
+{
+    tree *avl = NULL;
+    tree *wavl = NULL;
+    tree *other = NULL;
+    tree *clone = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data min;
+    struct _tree_data max;
+    struct _tree_data *data;
+    char *message;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        model[i] = -1;
+
+    avl = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    wavl = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (!set_wavl(wavl)) {
+        ELOG("Rank balance not set");
+        return "Rank balance not set";
+    }
+
+    // Insertions give the same tree
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = i;
+        insert_elmt(avl, &tmp_elmnt, sizeof(struct _tree_data));
+        insert_elmt(wavl, &tmp_elmnt, sizeof(struct _tree_data));
+        model[tmp_elmnt.key] = i;
+    }
+    if (!same_shape(avl->root, wavl->root) || avl->rotations != wavl->rotations) {
+        ELOG("Insertions do not give an AVL tree");
+        return "Insertions do not give an AVL tree";
+    }
+    if (set_wavl(wavl)) {
+        ELOG("Rank balance set on a filled tree");
+        return "Rank balance set on a filled tree";
+    }
+    if ((message = check_tree(wavl, model)) != NULL)
+        return message;
+
+    // Deletions need fewer rotations
+    avl->rotations = 0;
+    wavl->rotations = 0;
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(avl, &tmp_elmnt);
+        delete_node(wavl, &tmp_elmnt);
+        model[tmp_elmnt.key] = -1;
+        if (i % 1000 == 0)
+            verif_tree(wavl);
+    }
+    if (wavl->rotations > avl->rotations) {
+        ELOG("Too many rotations: %lu > %lu", wavl->rotations, avl->rotations);
+        return "Too many rotations";
+    }
+    if ((message = check_tree(wavl, model)) != NULL)
+        return message;
+    delete_tree(avl);
+
+    // Mixed operations keep ranks
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = i;
+        switch (rand() % 4) {
+        case 0:
+        case 1:
+            insert_elmt(wavl, &tmp_elmnt, sizeof(struct _tree_data));
+            model[tmp_elmnt.key] = i;
+            break;
+        case 2:
+            delete_node(wavl, &tmp_elmnt);
+            model[tmp_elmnt.key] = -1;
+            break;
+        default:
+            data = (rand() % 2) ? pop_min(wavl) : pop_max(wavl);
+            if (data != NULL) {
+                model[data->key] = -1;
+                free(data);
+            }
+            break;
+        }
+    }
+    if ((message = check_tree(wavl, model)) != NULL)
+        return message;
+
+    min.key = rand() % (MAX_KEY / 2);
+    max.key = min.key + rand() % (MAX_KEY / 4);
+    delete_range(wavl, &min, &max, removed_data, model);
+    if ((message = check_tree(wavl, model)) != NULL)
+        return message;
+
+    // Joins keep rank of nodes whose sons are both lower by 2, which are
+    // left by deletions
+    for (i = 0; i < 5 * MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(wavl, &tmp_elmnt);
+        model[tmp_elmnt.key] = -1;
+    }
+    other = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_wavl(other);
+    for (i = 0; i < 1000; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = 0;
+        split_tree(wavl, &tmp_elmnt, other, NULL);
+        verif_tree(wavl);
+        verif_tree(other);
+        join_tree(wavl, &tmp_elmnt, sizeof(struct _tree_data), other);
+        verif_tree(wavl);
+        model[tmp_elmnt.key] = 0;
+    }
+    if ((message = check_tree(wavl, model)) != NULL)
+        return message;
+    delete_tree(other);
+
+    for (i = 0; i < MAX_ELEMENT / 2; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(wavl, &tmp_elmnt);
+        model[tmp_elmnt.key] = -1;
+    }
+    if ((message = check_tree(wavl, model)) != NULL)
+        return message;
+    delete_tree(wavl);
+
+    // Rank balance of a persistent tree
+    for (i = 0; i < MAX_KEY; i++)
+        model[i] = -1;
+    wavl = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_wavl(wavl);
+    set_persistent(wavl, sizeof(struct _tree_data));
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = i;
+        insert_elmt(wavl, &tmp_elmnt, sizeof(struct _tree_data));
+        model[tmp_elmnt.key] = i;
+    }
+    clone = clone_tree(wavl);
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(clone, &tmp_elmnt);
+    }
+    if ((message = check_tree(wavl, model)) != NULL)
+        return message;
+    verif_tree(clone);
+    delete_tree(clone);
+    delete_tree(wavl);
+
+    return NULL;
+}
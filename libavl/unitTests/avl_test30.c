@@ -0,0 +1,252 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static int data_cmp(void *a, void *b)
+{
+    struct _tree_data aa = *((struct _tree_data *) a);
+    struct _tree_data bb = *((struct _tree_data *) b);
+
+    return aa.key - bb.key;
+}
+
+static void data_print(void *d)
+{
+    printf("%p|%d-%d", d,
+            ((struct _tree_data *) d)->key, ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 10000
+#define MAX_KEY     30000
+#define BUDGET      50
+
+// Expected elements of tree, -1 when key is not in tree.
+static int model[MAX_KEY];
+
+// Check elements of tree, which may not be balanced.
+static char *check_elements(tree *t)
+{
+    struct _tree_data tmp_elmnt;
+    unsigned int count = 0;
+    int key;
+
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp_elmnt.key = key;
+        if (get_data(t, &tmp_elmnt, sizeof(struct _tree_data)) != (model[key] != -1)) {
+            ELOG("Wrong element in tree");
+            return "Wrong element in tree";
+        }
+        if (model[key] != -1)
+            count++;
+    }
+    if (   t->count != count
+        || scan_range(t, NULL, NULL, 0, 0, NULL, NULL, NULL) != count) {
+        ELOG("Wrong number of element in tree");
+        return "Wrong number of element in tree";
+    }
+
+    return NULL;
+}
+
+// Balance tree by small steps, then check it.
+static char *rebalance(tree *t)
+{
+    while (rebalance_step(t, BUDGET) == BUDGET)
+        ;
+    verif_tree(t);
+    if (rebalance_step(t, 0) != 0) {
+        ELOG("Balanced tree has marked nodes");
+        return "Balanced tree has marked nodes";
+    }
+
+    return check_elements(t);
+}
+
+static void removed_data(void *d, void *param)
+{
+    int *m = (int *) param;
+
+    m[((struct _tree_data *) d)->key] = -1;
+    free(d);
+}
+
+char *relaxed_tests()
+{
+    tree *t = NULL;
+    tree *other = NULL;
+    struct _tree_data tmp_elmnt;
+    struct _tree_data min;
+    struct _tree_data max;
+    struct _tree_data *data;
+    char *message;
+    int split;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_KEY; i++)
+        model[i] = -1;
+
+    t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_wavl(t);
+    if (set_relaxed(t)) {
+        ELOG("Relaxed balance set on a rank balanced tree");
+        return "Relaxed balance set on a rank balanced tree";
+    }
+    delete_tree(t);
+
+    t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (!set_relaxed(t)) {
+        ELOG("Relaxed balance not set");
+        return "Relaxed balance not set";
+    }
+
+    // Sorted insertions build a list, without rotation
+    for (i = 0; i < MAX_ELEMENT / 10; i++) {
+        tmp_elmnt.key = i;
+        tmp_elmnt.value = i;
+        insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        model[i] = i;
+    }
+    if (t->rotations != 0 || t->root->height != MAX_ELEMENT / 10) {
+        ELOG("Relaxed tree is balanced");
+        return "Relaxed tree is balanced";
+    }
+    if (set_relaxed(t)) {
+        ELOG("Relaxed balance set on a filled tree");
+        return "Relaxed balance set on a filled tree";
+    }
+    if ((message = check_elements(t)) != NULL)
+        return message;
+    if (rebalance_step(t, BUDGET) != BUDGET) {
+        ELOG("Too few marked nodes");
+        return "Too few marked nodes";
+    }
+    if ((message = rebalance(t)) != NULL)
+        return message;
+
+    // Random insertions and deletions
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        tmp_elmnt.value = i;
+        insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        model[tmp_elmnt.key] = i;
+    }
+    for (i = 0; i < MAX_ELEMENT / 2; i++) {
+        tmp_elmnt.key = rand() % MAX_KEY;
+        delete_node(t, &tmp_elmnt);
+        model[tmp_elmnt.key] = -1;
+    }
+    for (i = 0; i < 10; i++) {
+        data = (i % 2) ? pop_min(t) : pop_max(t);
+        model[data->key] = -1;
+        free(data);
+    }
+    if ((message = check_elements(t)) != NULL)
+        return message;
+    if ((message = rebalance(t)) != NULL)
+        return message;
+
+    // Other operations on a tree which is not balanced
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = (i * 7) % MAX_KEY;
+        tmp_elmnt.value = i;
+        insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        model[tmp_elmnt.key] = i;
+    }
+    min.key = rand() % (MAX_KEY / 2);
+    max.key = min.key + rand() % (MAX_KEY / 4);
+    delete_range(t, &min, &max, removed_data, model);
+    other = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_relaxed(other);
+    tmp_elmnt.key = rand() % MAX_KEY;
+    tmp_elmnt.value = 0;
+    if (split_tree(t, &tmp_elmnt, other, (void **) &data)) {
+        model[data->key] = -1;
+        free(data);
+    }
+    split = tmp_elmnt.key;
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp_elmnt.key = (MAX_KEY - 1) - (i * 3) % MAX_KEY;
+        delete_node(other, &tmp_elmnt);
+        if (tmp_elmnt.key > split)
+            model[tmp_elmnt.key] = -1;
+    }
+    tmp_elmnt.key = split;
+    tmp_elmnt.value = 0;
+    join_tree(t, &tmp_elmnt, sizeof(struct _tree_data), other);
+    model[split] = 0;
+    delete_tree(other);
+    if ((message = check_elements(t)) != NULL)
+        return message;
+    if ((message = rebalance(t)) != NULL)
+        return message;
+
+    // Hinted insertions and appends mark nodes along the finger
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        if (i % 100 == 0)
+            split = rand() % (MAX_KEY / 2);
+        tmp_elmnt.key = split++;
+        tmp_elmnt.value = i;
+        insert_elmt_hint(t, &tmp_elmnt, sizeof(struct _tree_data));
+        model[tmp_elmnt.key] = i;
+    }
+    for (i = MAX_KEY / 2; i < MAX_KEY; i++) {
+        tmp_elmnt.key = i;
+        tmp_elmnt.value = i;
+        insert_elmt(t, &tmp_elmnt, sizeof(struct _tree_data));
+        model[i] = i;
+    }
+    rebalance_step(t, 0);
+    verif_tree(t);
+    if (rebalance_step(t, 0) != 0) {
+        ELOG("Balanced tree has marked nodes");
+        return "Balanced tree has marked nodes";
+    }
+    if ((message = check_elements(t)) != NULL)
+        return message;
+
+    delete_tree(t);
+
+    return NULL;
+}
@@ -0,0 +1,237 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+// Keys are not aligned in data.
+struct _tree_data {
+    char pad;
+    char i32[4];
+    char i64[8];
+    char u32[4];
+    char u64[8];
+    char dbl[8];
+    char bytes[6];
+    char str[8];
+};
+
+static void data_print(void *d)
+{
+    printf("%p", d);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 2000
+
+static struct _tree_data items[MAX_ELEMENT];
+static struct _tree_data *sorted[MAX_ELEMENT];
+static const key_desc keys[] = {
+    { KEY_INT32, offsetof(struct _tree_data, i32), 0, 0 },
+    { KEY_INT64, offsetof(struct _tree_data, i64), 0, 0 },
+    { KEY_UINT32, offsetof(struct _tree_data, u32), 0, 0 },
+    { KEY_UINT64, offsetof(struct _tree_data, u64), 0, 0 },
+    { KEY_DOUBLE, offsetof(struct _tree_data, dbl), 0, 0 },
+    { KEY_BYTES, offsetof(struct _tree_data, bytes), 6, 0 },
+    { KEY_STRING, offsetof(struct _tree_data, str), 8, 0 },
+};
+static unsigned int current;
+
+// Reference comparison of current key, on aligned values.
+static int reference_cmp(const void *a, const void *b)
+{
+    const struct _tree_data *aa = *((struct _tree_data * const *) a);
+    const struct _tree_data *bb = *((struct _tree_data * const *) b);
+    int32_t i32a, i32b;
+    int64_t i64a, i64b;
+    uint32_t u32a, u32b;
+    uint64_t u64a, u64b;
+    double da, db;
+
+    switch (keys[current].type) {
+    case KEY_INT32:
+        memcpy(&i32a, aa->i32, 4);
+        memcpy(&i32b, bb->i32, 4);
+        return (i32a > i32b) - (i32a < i32b);
+    case KEY_INT64:
+        memcpy(&i64a, aa->i64, 8);
+        memcpy(&i64b, bb->i64, 8);
+        return (i64a > i64b) - (i64a < i64b);
+    case KEY_UINT32:
+        memcpy(&u32a, aa->u32, 4);
+        memcpy(&u32b, bb->u32, 4);
+        return (u32a > u32b) - (u32a < u32b);
+    case KEY_UINT64:
+        memcpy(&u64a, aa->u64, 8);
+        memcpy(&u64b, bb->u64, 8);
+        return (u64a > u64b) - (u64a < u64b);
+    case KEY_DOUBLE:
+        memcpy(&da, aa->dbl, 8);
+        memcpy(&db, bb->dbl, 8);
+        return (da > db) - (da < db);
+    case KEY_BYTES:
+        return memcmp(aa->bytes, bb->bytes, 6);
+    default:
+        return strncmp(aa->str, bb->str, 8);
+    }
+}
+
+static void random_item(struct _tree_data *d)
+{
+    static const double specials[] = { 0.0, 1e300, -1e300, 1e-300, -1e-300 };
+    int32_t i32 = (int32_t) ((unsigned int) rand() << 16 ^ (unsigned int) rand());
+    int64_t i64 = (int64_t) i32 * rand() * (rand() % 2 ? 1 : -1);
+    uint32_t u32 = (uint32_t) i32;
+    uint64_t u64 = (uint64_t) i64;
+    double dbl;
+    int i;
+
+    if (rand() % 10 == 0)
+        dbl = specials[rand() % 5];
+    else
+        dbl = (double) i32 / ((double) (rand() % 1000) + 1.0);
+
+    memset(d, 0, sizeof(*d));
+    memcpy(d->i32, &i32, 4);
+    memcpy(d->i64, &i64, 8);
+    memcpy(d->u32, &u32, 4);
+    memcpy(d->u64, &u64, 8);
+    memcpy(d->dbl, &dbl, 8);
+    // small alphabet with high bytes, so many keys share prefixes.
+    for (i = 0; i < 6; i++)
+        d->bytes[i] = (char) (0x7e + rand() % 4);
+    for (i = 0; i < rand() % 9; i++)
+        d->str[i] = (char) ('a' + rand() % 3);
+}
+
+static int unique_items(void)
+{
+    unsigned int i;
+    int count = 0;
+
+    for (i = 0; i < MAX_ELEMENT; i++)
+        sorted[i] = &items[i];
+    qsort(sorted, MAX_ELEMENT, sizeof(sorted[0]), reference_cmp);
+    for (i = 0; i < MAX_ELEMENT; i++)
+        if (i == 0 || reference_cmp(&sorted[i - 1], &sorted[i]) != 0)
+            sorted[count++] = sorted[i];
+
+    return count;
+}
+
+char *key_tests()
+{
+    tree *t = NULL;
+    key_desc bad = { KEY_STRING, 0, 0, 0 };
+    void *out[MAX_ELEMENT];
+    struct _tree_data tmp_elmnt;
+    unsigned int count;
+    int unique;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    if (init_key_dictionnary(&bad, data_print, data_delete, data_copy) != NULL) {
+        ELOG("Tree initialized with an empty string key");
+        return "Tree initialized with an empty string key";
+    }
+
+    for (i = 0; i < MAX_ELEMENT; i++)
+        random_item(&items[i]);
+
+    for (current = 0; current < sizeof(keys) / sizeof(keys[0]); current++) {
+        t = init_key_dictionnary(&keys[current], data_print, data_delete,
+                                 data_copy);
+        if (t == NULL || t->data_cmp != NULL) {
+            ELOG("Wrong tree with key %u", keys[current].type);
+            return "Wrong tree with key";
+        }
+        for (i = 0; i < MAX_ELEMENT; i++)
+            insert_elmt(t, &items[i], sizeof(struct _tree_data));
+        verif_tree(t);
+
+        // Elements are in order of keys
+        unique = unique_items();
+        count = collect_range(t, NULL, NULL, out, MAX_ELEMENT, NULL);
+        if (count != (unsigned int) unique || t->count != count) {
+            ELOG("Wrong number of keys %u: %u, %d", keys[current].type,
+                 count, unique);
+            return "Wrong number of keys";
+        }
+        for (i = 0; i < unique; i++) {
+            if (reference_cmp(&out[i], &sorted[i]) != 0) {
+                ELOG("Wrong order of keys %u", keys[current].type);
+                return "Wrong order of keys";
+            }
+        }
+
+        // Each key is found, and deleted
+        for (i = 0; i < unique; i += 2) {
+            memcpy(&tmp_elmnt, sorted[i], sizeof(tmp_elmnt));
+            if (!is_present(t, &tmp_elmnt)) {
+                ELOG("Key not found %u", keys[current].type);
+                return "Key not found";
+            }
+            delete_node(t, &tmp_elmnt);
+            if (is_present(t, &tmp_elmnt)) {
+                ELOG("Key not deleted %u", keys[current].type);
+                return "Key not deleted";
+            }
+        }
+        for (i = 1; i < unique; i += 2) {
+            struct _tree_data *found = &tmp_elmnt;
+
+            // field out of key is filled by get_data.
+            memcpy(&tmp_elmnt, sorted[i], sizeof(tmp_elmnt));
+            tmp_elmnt.pad = 1;
+            if (   !get_data(t, &tmp_elmnt, sizeof(struct _tree_data))
+                || tmp_elmnt.pad != 0
+                || reference_cmp(&found, &sorted[i]) != 0) {
+                ELOG("Data not found %u", keys[current].type);
+                return "Data not found";
+            }
+        }
+        verif_tree(t);
+        if (t->count != (unsigned int) (unique / 2)) {
+            ELOG("Wrong number of keys after deletion");
+            return "Wrong number of keys after deletion";
+        }
+        delete_tree(t);
+    }
+
+    return NULL;
+}
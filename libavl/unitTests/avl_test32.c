@@ -0,0 +1,232 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    uint32_t tenant;
+    int64_t time;
+    char name[4];
+};
+
+static void data_print(void *d)
+{
+    printf("%u-%ld-%.4s", ((struct _tree_data *) d)->tenant,
+           (long) ((struct _tree_data *) d)->time,
+           ((struct _tree_data *) d)->name);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 3000
+#define MAX_TENANT  20
+
+static const key_desc fields[] = {
+    { KEY_UINT32, offsetof(struct _tree_data, tenant), 0, 0 },
+    { KEY_INT64, offsetof(struct _tree_data, time), 0, 1 },
+    { KEY_STRING, offsetof(struct _tree_data, name), 4, 0 },
+};
+
+static struct _tree_data items[MAX_ELEMENT];
+
+// Reference order: tenant, then newest time first, then name.
+static int reference_cmp(const void *a, const void *b)
+{
+    const struct _tree_data *aa = (const struct _tree_data *) a;
+    const struct _tree_data *bb = (const struct _tree_data *) b;
+
+    if (aa->tenant != bb->tenant)
+        return aa->tenant < bb->tenant ? -1 : 1;
+    if (aa->time != bb->time)
+        return aa->time > bb->time ? -1 : 1;
+
+    return strncmp(aa->name, bb->name, 4);
+}
+
+struct _check {
+    struct _tree_data *previous;
+    struct _tree_data *prefix;
+    unsigned int count;
+    unsigned int fields;
+    int error;
+};
+
+static int check_data(void *d, void *param)
+{
+    struct _check *c = (struct _check *) param;
+    struct _tree_data *data = (struct _tree_data *) d;
+
+    if (c->previous != NULL && reference_cmp(c->previous, data) >= 0)
+        c->error = 1;
+    if (data->tenant != c->prefix->tenant)
+        c->error = 1;
+    if (c->fields > 1 && data->time != c->prefix->time)
+        c->error = 1;
+    c->previous = data;
+    c->count++;
+
+    return 0;
+}
+
+static unsigned int count_prefix(struct _tree_data *prefix, int unique,
+                                 unsigned int depth)
+{
+    unsigned int count = 0;
+    int i;
+
+    for (i = 0; i < unique; i++)
+        if (   items[i].tenant == prefix->tenant
+            && (depth < 2 || items[i].time == prefix->time))
+            count++;
+
+    return count;
+}
+
+char *composite_tests()
+{
+    tree *t = NULL;
+    tree *other = NULL;
+    tree *clone = NULL;
+    key_desc bad[] = {
+        { KEY_UINT32, 0, 0, 0 },
+        { KEY_COMPOSITE, 0, 0, 0 },
+    };
+    struct _tree_data tmp_elmnt;
+    struct _check c;
+    int unique;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    if (init_composite_dictionnary(bad, 2, data_print, data_delete,
+                                   data_copy) != NULL) {
+        ELOG("Tree initialized with a wrong field");
+        return "Tree initialized with a wrong field";
+    }
+
+    t = init_composite_dictionnary(fields, 3, data_print, data_delete,
+                                   data_copy);
+    set_persistent(t, sizeof(struct _tree_data));
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        memset(&items[i], 0, sizeof(items[i]));
+        items[i].tenant = (uint32_t) (rand() % MAX_TENANT);
+        items[i].time = (int64_t) (rand() % 50) - 25;
+        items[i].name[0] = (char) ('a' + rand() % 3);
+        items[i].name[1] = (char) ('a' + rand() % 3);
+        insert_elmt(t, &items[i], sizeof(struct _tree_data));
+    }
+    verif_tree(t);
+
+    // Tree order is the order of fields
+    qsort(items, MAX_ELEMENT, sizeof(items[0]), reference_cmp);
+    for (unique = 0, i = 0; i < MAX_ELEMENT; i++)
+        if (i == 0 || reference_cmp(&items[unique - 1], &items[i]) != 0)
+            items[unique++] = items[i];
+    if (t->count != (unsigned int) unique) {
+        ELOG("Wrong number of elements: %u, %d", t->count, unique);
+        return "Wrong number of elements";
+    }
+    memset(&c, 0, sizeof(c));
+    c.prefix = &tmp_elmnt;
+    for (i = 0; i < MAX_TENANT; i++) {
+        tmp_elmnt.tenant = (uint32_t) i;
+        c.previous = NULL;
+        if (   scan_fields(t, &tmp_elmnt, 1, check_data, &c)
+               != count_prefix(&tmp_elmnt, unique, 1)
+            || c.error) {
+            ELOG("Wrong scan of tenant %d", i);
+            return "Wrong scan of tenant";
+        }
+    }
+    if (c.count != (unsigned int) unique) {
+        ELOG("Wrong number of scanned elements");
+        return "Wrong number of scanned elements";
+    }
+
+    // Scan of two fields
+    c.fields = 2;
+    for (i = 0; i < 100; i++) {
+        tmp_elmnt = items[rand() % unique];
+        if (rand() % 4 == 0)
+            tmp_elmnt.time = 1000;
+        c.previous = NULL;
+        if (   scan_fields(t, &tmp_elmnt, 2, check_data, &c)
+               != count_prefix(&tmp_elmnt, unique, 2)
+            || c.error) {
+            ELOG("Wrong scan of tenant and time");
+            return "Wrong scan of tenant and time";
+        }
+    }
+    if (   scan_fields(t, &tmp_elmnt, 4, NULL, NULL) != 0
+        || scan_fields(t, &tmp_elmnt, 0, NULL, NULL) != 0) {
+        ELOG("Scan with a wrong number of fields");
+        return "Scan with a wrong number of fields";
+    }
+
+    // Clones and other trees with the same fields
+    clone = clone_tree(t);
+    other = init_composite_dictionnary(fields, 3, data_print, data_delete,
+                                       data_copy);
+    set_persistent(other, sizeof(struct _tree_data));
+    tmp_elmnt.tenant = MAX_TENANT;
+    tmp_elmnt.time = 0;
+    strncpy(tmp_elmnt.name, "zz", 4);
+    insert_elmt(other, &tmp_elmnt, sizeof(struct _tree_data));
+    if (union_tree(clone, other) != (unsigned int) unique + 1) {
+        ELOG("Wrong union of composite trees");
+        return "Wrong union of composite trees";
+    }
+    delete_tree(other);
+    other = init_key_dictionnary(&fields[0], data_print, data_delete,
+                                 data_copy);
+    set_persistent(other, sizeof(struct _tree_data));
+    if (union_tree(clone, other) != (unsigned int) unique + 1) {
+        ELOG("Union of trees with different keys");
+        return "Union of trees with different keys";
+    }
+    verif_tree(clone);
+    if (scan_fields(clone, &tmp_elmnt, 1, NULL, NULL) != 1) {
+        ELOG("Wrong scan of clone");
+        return "Wrong scan of clone";
+    }
+
+    delete_tree(other);
+    delete_tree(t);
+    delete_tree(clone);
+
+    return NULL;
+}
@@ -0,0 +1,220 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl_generate.h"
+
+struct item {
+    int key;
+    int value;
+    AVL_ENTRY(item) link;
+};
+
+static unsigned long comparisons = 0;
+
+static int item_cmp(struct item *a, struct item *b)
+{
+    comparisons++;
+    return (a->key > b->key) - (a->key < b->key);
+}
+
+AVL_HEAD(item_tree, item);
+AVL_GENERATE(item_tree, item, link, item_cmp)
+
+#define MAX_ELEMENT 5000
+#define MAX_KEY     10000
+
+static struct item items[MAX_KEY];
+// 1 when item of key is in tree.
+static int model[MAX_KEY];
+
+// Check order and balance, give height of subtree, or -1 on error.
+static int check_subtree(struct item *n, int min, int max)
+{
+    int hl;
+    int hr;
+
+    if (n == NULL)
+        return 0;
+    if (n->key < min || n->key > max || !model[n->key])
+        return -1;
+    hl = check_subtree(AVL_LEFT(n, link), min, n->key - 1);
+    hr = check_subtree(AVL_RIGHT(n, link), n->key + 1, max);
+    if (hl < 0 || hr < 0 || hl > hr + 1 || hr > hl + 1)
+        return -1;
+    if (AVL_HEIGHT(n, link) != (unsigned int) (hl > hr ? hl : hr) + 1)
+        return -1;
+
+    return (hl > hr ? hl : hr) + 1;
+}
+
+static char *check_tree(struct item_tree *head)
+{
+    AVL_ITER(item_tree) it;
+    struct item *elm;
+    struct item *other;
+    unsigned int count = 0;
+    int previous = -1;
+    int key;
+
+    if (check_subtree(AVL_ROOT(head), 0, MAX_KEY) < 0) {
+        ELOG("Wrong generated tree");
+        return "Wrong generated tree";
+    }
+    for (key = 0; key < MAX_KEY; key++)
+        count += (unsigned int) model[key];
+    if (AVL_COUNT(head) != count) {
+        ELOG("Wrong number of elements");
+        return "Wrong number of elements";
+    }
+    count = 0;
+    comparisons = 0;
+    AVL_FOREACH(elm, item_tree, head) {
+        if (elm->key <= previous) {
+            ELOG("Wrong order of elements");
+            return "Wrong order of elements";
+        }
+        previous = elm->key;
+        count++;
+    }
+    AVL_FOREACH_REVERSE(elm, item_tree, head) {
+        if (elm->key > previous) {
+            ELOG("Wrong reverse order of elements");
+            return "Wrong reverse order of elements";
+        }
+        previous = elm->key;
+        count--;
+    }
+    if (count != 0) {
+        ELOG("Wrong number of elements in loops");
+        return "Wrong number of elements in loops";
+    }
+    if (comparisons != 0) {
+        ELOG("Loops compared %lu elements", comparisons);
+        return "Loops compared elements";
+    }
+
+    // Iterator goes both ways, as elements compared from root do
+    elm = AVL_ITER_FIRST(item_tree, &it, head);
+    while (elm != NULL) {
+        other = AVL_NEXT(item_tree, head, elm);
+        if (AVL_ITER_NEXT(item_tree, &it) != other) {
+            ELOG("Wrong next element");
+            return "Wrong next element";
+        }
+        if (other == NULL)
+            break;
+        if (   AVL_ITER_PREV(item_tree, &it) != elm
+            || AVL_PREV(item_tree, head, other) != elm
+            || AVL_ITER_NEXT(item_tree, &it) != other) {
+            ELOG("Wrong previous element");
+            return "Wrong previous element";
+        }
+        elm = other;
+    }
+    if (   AVL_ITER_LAST(item_tree, &it, head) != AVL_MAX(item_tree, head)
+        || (elm != NULL && AVL_ITER_NEXT(item_tree, &it) != NULL)) {
+        ELOG("Wrong last element");
+        return "Wrong last element";
+    }
+
+    return NULL;
+}
+
+char *generated_tests()
+{
+    struct item_tree head = AVL_INITIALIZER;
+    struct item tmp;
+    struct item *elm;
+    char *message;
+    int key;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (key = 0; key < MAX_KEY; key++) {
+        items[key].key = key;
+        items[key].value = rand();
+        model[key] = 0;
+    }
+
+    if (   !AVL_EMPTY(&head) || AVL_MIN(item_tree, &head) != NULL
+        || AVL_MAX(item_tree, &head) != NULL) {
+        ELOG("Wrong empty tree");
+        return "Wrong empty tree";
+    }
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        key = rand() % MAX_KEY;
+        elm = AVL_INSERT(item_tree, &head, &items[key]);
+        if (elm != (model[key] ? &items[key] : NULL)) {
+            ELOG("Wrong insertion");
+            return "Wrong insertion";
+        }
+        model[key] = 1;
+    }
+    if ((message = check_tree(&head)) != NULL)
+        return message;
+
+    // Lookups
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp.key = key;
+        if (AVL_FIND(item_tree, &head, &tmp) != (model[key] ? &items[key] : NULL)) {
+            ELOG("Wrong lookup");
+            return "Wrong lookup";
+        }
+        for (i = key; i < MAX_KEY && !model[i]; i++)
+            ;
+        if (AVL_NFIND(item_tree, &head, &tmp) != (i < MAX_KEY ? &items[i] : NULL)) {
+            ELOG("Wrong lookup of next element");
+            return "Wrong lookup of next element";
+        }
+    }
+
+    // Removals, also of missing elements
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp.key = rand() % MAX_KEY;
+        elm = AVL_REMOVE(item_tree, &head, &tmp);
+        if (elm != (model[tmp.key] ? &items[tmp.key] : NULL)) {
+            ELOG("Wrong removal");
+            return "Wrong removal";
+        }
+        model[tmp.key] = 0;
+    }
+    if ((message = check_tree(&head)) != NULL)
+        return message;
+
+    while ((elm = AVL_MIN(item_tree, &head)) != NULL) {
+        AVL_REMOVE(item_tree, &head, elm);
+        model[elm->key] = 0;
+    }
+    if (!AVL_EMPTY(&head) || (message = check_tree(&head)) != NULL) {
+        ELOG("Tree not emptied");
+        return message != NULL ? message : "Tree not emptied";
+    }
+
+    return NULL;
+}
@@ -0,0 +1,263 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "../syslog.h"
+#include "../avl.hpp"
+
+#define MAX_ELEMENT 5000
+#define MAX_KEY     10000
+
+// Allocator counting nodes still allocated.
+static long live_nodes = 0;
+
+template <class T>
+struct counting_allocator {
+    typedef T value_type;
+
+    counting_allocator() {}
+    template <class U>
+    counting_allocator(const counting_allocator<U> &) {}
+
+    T *allocate(std::size_t n)
+    {
+        live_nodes += (long) n;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n)
+    {
+        live_nodes -= (long) n;
+        std::allocator<T>().deallocate(p, n);
+    }
+};
+
+template <class T, class U>
+static bool operator==(const counting_allocator<T> &,
+                       const counting_allocator<U> &)
+{
+    return true;
+}
+
+template <class T, class U>
+static bool operator!=(const counting_allocator<T> &,
+                       const counting_allocator<U> &)
+{
+    return false;
+}
+
+typedef avl::map<int, int, std::less<int>,
+                 counting_allocator<std::pair<const int, int> > > int_map;
+
+static bool balanced(unsigned height, std::size_t size)
+{
+    return height <= 1.4405 * std::log2((double) size + 2.0) - 0.3277;
+}
+
+static const char *check_map(const int_map &m, const std::map<int, int> &model)
+{
+    if (m.size() != model.size() || !balanced(m.height(), m.size())) {
+        ELOG("Wrong map");
+        return "Wrong map";
+    }
+    std::map<int, int>::const_iterator expected = model.begin();
+    for (int_map::const_iterator it = m.begin(); it != m.end(); ++it) {
+        if (it->first != expected->first || it->second != expected->second) {
+            ELOG("Wrong order of elements");
+            return "Wrong order of elements";
+        }
+        ++expected;
+    }
+    std::map<int, int>::const_reverse_iterator rexpected = model.rbegin();
+    for (int_map::const_reverse_iterator it = m.rbegin(); it != m.rend(); ++it) {
+        if (it->first != rexpected->first) {
+            ELOG("Wrong reverse order of elements");
+            return "Wrong reverse order of elements";
+        }
+        ++rexpected;
+    }
+
+    return NULL;
+}
+
+static const char *int_tests()
+{
+    std::map<int, int> model;
+    const char *message;
+    int key;
+    int i;
+
+    {
+        int_map m;
+
+        for (i = 0; i < MAX_ELEMENT; i++) {
+            key = rand() % MAX_KEY;
+            bool inserted = m.emplace(key, i).second;
+            if (inserted != model.emplace(key, i).second) {
+                ELOG("Wrong insertion");
+                return "Wrong insertion";
+            }
+        }
+        if ((message = check_map(m, model)) != NULL)
+            return message;
+        if (live_nodes != (long) m.size()) {
+            ELOG("Wrong number of allocated nodes");
+            return "Wrong number of allocated nodes";
+        }
+
+        for (key = 0; key < MAX_KEY; key++) {
+            if (m.count(key) != model.count(key)) {
+                ELOG("Wrong lookup");
+                return "Wrong lookup";
+            }
+            int_map::iterator lb = m.lower_bound(key);
+            std::map<int, int>::iterator mlb = model.lower_bound(key);
+            if ((lb == m.end()) != (mlb == model.end())
+                || (lb != m.end() && lb->first != mlb->first)) {
+                ELOG("Wrong lower bound");
+                return "Wrong lower bound";
+            }
+            int_map::iterator ub = m.upper_bound(key);
+            std::map<int, int>::iterator mub = model.upper_bound(key);
+            if ((ub == m.end()) != (mub == model.end())
+                || (ub != m.end() && ub->first != mub->first)) {
+                ELOG("Wrong upper bound");
+                return "Wrong upper bound";
+            }
+        }
+
+        int_map copy(m);
+        for (i = 0; i < MAX_ELEMENT; i++) {
+            key = rand() % MAX_KEY;
+            if (m.erase(key) != model.erase(key)) {
+                ELOG("Wrong removal");
+                return "Wrong removal";
+            }
+        }
+        if ((message = check_map(m, model)) != NULL)
+            return message;
+
+        // Removal through iterators, of one element out of two
+        int_map::iterator it = m.begin();
+        while (it != m.end()) {
+            model.erase(it->first);
+            it = m.erase(it);
+            if (it != m.end())
+                ++it;
+        }
+        if ((message = check_map(m, model)) != NULL)
+            return message;
+
+        int_map moved(std::move(copy));
+        if (!copy.empty() || moved.size() == 0) {
+            ELOG("Wrong move");
+            return "Wrong move";
+        }
+        m = std::move(moved);
+        if (live_nodes != (long) m.size()) {
+            ELOG("Wrong number of allocated nodes after move");
+            return "Wrong number of allocated nodes after move";
+        }
+        m[-1] = 3;
+        if (m.at(-1) != 3 || m.begin()->first != -1
+            || (--m.end())->first != (--m.end())->first) {
+            ELOG("Wrong access operator");
+            return "Wrong access operator";
+        }
+    }
+    if (live_nodes != 0) {
+        ELOG("Nodes not freed");
+        return "Nodes not freed";
+    }
+
+    return NULL;
+}
+
+static const char *move_only_tests()
+{
+    avl::map<std::string, std::unique_ptr<int>, std::less<> > m;
+
+    for (int i = 0; i < 100; i++)
+        m.emplace(std::to_string(i), std::unique_ptr<int>(new int(i)));
+    if (m.size() != 100) {
+        ELOG("Wrong insertion of move-only values");
+        return "Wrong insertion of move-only values";
+    }
+
+    // Value is not built when key is present.
+    std::unique_ptr<int> value(new int(-1));
+    if (m.try_emplace("42", std::move(value)).second || value == nullptr) {
+        ELOG("Value moved on existing key");
+        return "Value moved on existing key";
+    }
+
+    // Heterogeneous lookup, without building a std::string.
+    avl::map<std::string, std::unique_ptr<int>, std::less<> >::iterator it
+        = m.find("42");
+    if (it == m.end() || *it->second != 42 || !m.contains("7")
+        || m.contains("100") || m.lower_bound("5")->first != "5") {
+        ELOG("Wrong heterogeneous lookup");
+        return "Wrong heterogeneous lookup";
+    }
+
+    avl::map<std::string, std::unique_ptr<int>, std::less<> > other;
+    other = std::move(m);
+    if (other.size() != 100 || !m.empty() || *other.at("99") != 99) {
+        ELOG("Wrong move of move-only values");
+        return "Wrong move of move-only values";
+    }
+
+    // Move-only keys are never copied by move assignment.
+    avl::map<std::unique_ptr<int>, int> keys;
+    avl::map<std::unique_ptr<int>, int> moved;
+    for (int i = 0; i < 100; i++)
+        keys.emplace(std::unique_ptr<int>(new int(i)), i);
+    moved.emplace(std::unique_ptr<int>(new int(-1)), -1);
+    moved = std::move(keys);
+    if (moved.size() != 100 || !keys.empty()
+        || *moved.begin()->first != moved.begin()->second) {
+        ELOG("Wrong move of move-only keys");
+        return "Wrong move of move-only keys";
+    }
+
+    return NULL;
+}
+
+extern "C" char *map_tests()
+{
+    const char *message;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand((unsigned int) rand_seed);
+
+    if ((message = int_tests()) != NULL)
+        return (char *) message;
+    if ((message = move_only_tests()) != NULL)
+        return (char *) message;
+
+    return NULL;
+}
@@ -0,0 +1,339 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    const char *path;
+    int value;
+};
+
+static void data_print(void *d)
+{
+    printf("%s => %d", ((struct _tree_data *) d)->path,
+           ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    // path is kept in arena of tree.
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_PATH    2000
+#define MAX_ELEMENT 3000
+
+static const char *dirs[] = {
+    "/usr/share/doc/", "/usr/share/man/", "/usr/lib/", "/var/log/", "/",
+};
+
+static char paths[MAX_PATH][64];
+// 1 when path is in tree.
+static int model[MAX_PATH];
+
+struct _check {
+    const char *previous;
+    const char *prefix;
+    int reverse;
+    int wrong;
+};
+
+static int check_prefix(void *data, void *param)
+{
+    struct _check *check = (struct _check *) param;
+    const char *path = ((struct _tree_data *) data)->path;
+
+    if (strncmp(path, check->prefix, strlen(check->prefix)) != 0)
+        check->wrong = 1;
+    if (check->previous != NULL) {
+        int cmp = strcmp(check->previous, path);
+
+        if (check->reverse ? cmp <= 0 : cmp >= 0)
+            check->wrong = 1;
+    }
+    check->previous = path;
+
+    return 0;
+}
+
+static char *check_tree(tree *t, int reverse)
+{
+    struct _tree_data tmp;
+    struct _check check;
+    unsigned int expected;
+    unsigned int i;
+    unsigned int j;
+
+    verif_tree(t);
+    for (i = 0; i < MAX_PATH; i++) {
+        // looked up path is not the stored one.
+        char copy[64];
+
+        strcpy(copy, paths[i]);
+        tmp.path = copy;
+        tmp.value = -1;
+        if (is_present(t, &tmp) != model[i]) {
+            ELOG("Wrong lookup of %s", paths[i]);
+            return "Wrong lookup of string key";
+        }
+        if (get_data(t, &tmp, sizeof(tmp)) != model[i]) {
+            ELOG("Wrong data of %s", paths[i]);
+            return "Wrong data of string key";
+        }
+        if (model[i] && (tmp.path == copy || strcmp(tmp.path, paths[i]) != 0
+                         || tmp.value != (int) i)) {
+            ELOG("Wrong stored key %s", paths[i]);
+            return "Wrong stored key";
+        }
+    }
+
+    // Prefixes of all sizes of some paths, and of no path.
+    for (i = 0; i < MAX_PATH; i += 97) {
+        for (j = 0; j <= strlen(paths[i]) + 1; j += 3) {
+            char prefix[64];
+            unsigned int k;
+
+            strcpy(prefix, paths[i]);
+            if (j < strlen(paths[i]))
+                prefix[j] = '\0';
+            else
+                strcat(prefix, "#");
+            expected = 0;
+            for (k = 0; k < MAX_PATH; k++)
+                if (model[k] && strncmp(paths[k], prefix, strlen(prefix)) == 0)
+                    expected++;
+
+            check.previous = NULL;
+            check.prefix = prefix;
+            check.reverse = reverse;
+            check.wrong = 0;
+            if (   scan_prefix(t, prefix, check_prefix, &check) != expected
+                || check.wrong) {
+                ELOG("Wrong scan of prefix %s", prefix);
+                return "Wrong scan of prefix";
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static unsigned int count_model(void)
+{
+    unsigned int count = 0;
+    unsigned int i;
+
+    for (i = 0; i < MAX_PATH; i++)
+        count += (unsigned int) model[i];
+
+    return count;
+}
+
+static char *fill(tree *t)
+{
+    struct _tree_data tmp;
+    char buffer[64];
+    unsigned int i;
+    int index;
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        index = rand() % MAX_PATH;
+        // tree copies path, so buffer can be reused.
+        strcpy(buffer, paths[index]);
+        tmp.path = buffer;
+        tmp.value = index;
+        insert_elmt(t, &tmp, sizeof(tmp));
+        model[index] = 1;
+        memset(buffer, 0, sizeof(buffer));
+    }
+    if (t->count != count_model()) {
+        ELOG("Wrong number of elements");
+        return "Wrong number of elements";
+    }
+
+    return NULL;
+}
+
+static int compare_pointer(const void *a, const void *b)
+{
+    size_t pa = (size_t) *(const char * const *) a;
+    size_t pb = (size_t) *(const char * const *) b;
+
+    return pa < pb ? -1 : pa > pb;
+}
+
+static char *reuse_tests(key_desc *key)
+{
+    static const char *stored[MAX_PATH];
+    struct _tree_data tmp;
+    struct _tree_data *popped;
+    char buffer[64];
+    const char *path;
+    tree *t;
+    unsigned int round;
+    unsigned int i;
+
+    t = init_key_dictionnary(key, data_print, data_delete, data_copy);
+    for (round = 0; round < 20; round++) {
+        // duplicates are rejected, and their copy released.
+        for (i = 0; i < 2 * MAX_PATH; i++) {
+            tmp.path = paths[(i * 7) % MAX_PATH];
+            tmp.value = (int) ((i * 7) % MAX_PATH);
+            insert_elmt(t, &tmp, sizeof(tmp));
+        }
+        if (t->count != MAX_PATH) {
+            ELOG("Wrong number of elements in round %u", round);
+            return "Wrong number of elements";
+        }
+
+        // all strings are those of first round.
+        for (i = 0; i < MAX_PATH; i++) {
+            tmp.path = paths[i];
+            get_data(t, &tmp, sizeof(tmp));
+            if (round == 0) {
+                stored[i] = tmp.path;
+            } else if (bsearch(&(tmp.path), stored, MAX_PATH, sizeof(char *),
+                               compare_pointer) == NULL) {
+                ELOG("String of %s not reused in round %u", paths[i], round);
+                return "String of deleted key not reused";
+            }
+        }
+        if (round == 0)
+            qsort(stored, MAX_PATH, sizeof(char *), compare_pointer);
+
+        for (i = 0; i < MAX_PATH; i++) {
+            tmp.path = paths[i];
+            if (i % 2)
+                delete_node(t, &tmp);
+        }
+        while (t->count > 0)
+            delete_node_min(t);
+    }
+
+    // keys of data given back are not reused by later insertions.
+    for (i = 0; i < MAX_PATH; i++) {
+        tmp.path = paths[i];
+        tmp.value = (int) i;
+        insert_elmt(t, &tmp, sizeof(tmp));
+    }
+    for (i = 0; i < MAX_PATH / 2; i++) {
+        popped = pop_min(t);
+        path = paths[popped->value];
+        // same length, so same size class.
+        strcpy(buffer, path);
+        buffer[0] = '~';
+        tmp.path = buffer;
+        tmp.value = -1;
+        insert_elmt(t, &tmp, sizeof(tmp));
+        if (strcmp(popped->path, path) != 0) {
+            ELOG("Popped key %s changed", path);
+            return "Popped key changed";
+        }
+        free(popped);
+    }
+    delete_tree(t);
+
+    return NULL;
+}
+
+char *cstring_tests()
+{
+    key_desc by_path = { KEY_CSTRING, offsetof(struct _tree_data, path), 0, 0 };
+    key_desc bounded = { KEY_CSTRING, offsetof(struct _tree_data, path), 8, 0 };
+    struct _tree_data tmp;
+    tree *t;
+    tree *greater;
+    char *message;
+    unsigned int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (i = 0; i < MAX_PATH; i++) {
+        sprintf(paths[i], "%s%s%u/%u", dirs[rand() % 5],
+                rand() % 2 ? "pkg" : "lib", i % 37, i);
+        model[i] = 0;
+    }
+
+    if (   init_key_dictionnary(&bounded, NULL, NULL, NULL) != NULL
+        || init_composite_dictionnary(&by_path, 1, NULL, NULL, NULL) != NULL) {
+        ELOG("Wrong string key accepted");
+        return "Wrong string key accepted";
+    }
+
+    t = init_key_dictionnary(&by_path, data_print, data_delete, data_copy);
+    if ((message = fill(t)) != NULL || (message = check_tree(t, 0)) != NULL)
+        return message;
+
+    // Removals
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        int index = rand() % MAX_PATH;
+
+        tmp.path = paths[index];
+        delete_node(t, &tmp);
+        model[index] = 0;
+    }
+    if ((message = check_tree(t, 0)) != NULL)
+        return message;
+
+    // Strings of elements which leave tree are reused.
+    if ((message = reuse_tests(&by_path)) != NULL)
+        return message;
+
+    // Nodes moved to another tree keep their strings when first tree is
+    // deleted.
+    greater = init_key_dictionnary(&by_path, data_print, data_delete,
+                                   data_copy);
+    tmp.path = "/usr/";
+    split_tree(t, &tmp, greater, NULL);
+    for (i = 0; i < MAX_PATH; i++)
+        if (strncmp(paths[i], "/usr/", 5) < 0)
+            model[i] = 0;
+    delete_tree(t);
+    if ((message = check_tree(greater, 0)) != NULL)
+        return message;
+    if ((message = fill(greater)) != NULL
+        || (message = check_tree(greater, 0)) != NULL)
+        return message;
+    delete_tree(greater);
+
+    // Decreasing order
+    for (i = 0; i < MAX_PATH; i++)
+        model[i] = 0;
+    by_path.descending = 1;
+    t = init_key_dictionnary(&by_path, data_print, data_delete, data_copy);
+    if ((message = fill(t)) != NULL || (message = check_tree(t, 1)) != NULL)
+        return message;
+    delete_tree(t);
+
+    return NULL;
+}
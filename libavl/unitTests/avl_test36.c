@@ -0,0 +1,250 @@
+/*
+ *   Libavl is a library to manage AVL structure to store and organize
+ *   everykind of data. You just need to implement function to compare,
+ *   to desallocate and to print your structure.
+ *
+ *       DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *                   Version 2, December 2004 
+ *
+ *   Copyright (C) 2013 Adrien Oliva <adrien.oliva@yapbreak.fr>
+ *
+ *   Everyone is permitted to copy and distribute verbatim or modified 
+ *   copies of this license document, and changing it is allowed as long 
+ *   as the name is changed. 
+ *
+ *           DO WHAT THE FUCK YOU WANT TO PUBLIC LICENSE 
+ *   TERMS AND CONDITIONS FOR COPYING, DISTRIBUTION AND MODIFICATION 
+ *
+ *   0. You just DO WHAT THE FUCK YOU WANT TO.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "../syslog.h"
+#include "../avl.h"
+
+struct _tree_data {
+    int key;
+    int value;
+};
+
+static unsigned long calls = 0;
+
+static int data_less(void *a, void *b)
+{
+    calls++;
+    return ((struct _tree_data *) a)->key < ((struct _tree_data *) b)->key;
+}
+
+static int data_cmp(void *a, void *b)
+{
+    int aa = ((struct _tree_data *) a)->key;
+    int bb = ((struct _tree_data *) b)->key;
+
+    return (aa > bb) - (aa < bb);
+}
+
+static void data_print(void *d)
+{
+    printf("%d => %d", ((struct _tree_data *) d)->key,
+           ((struct _tree_data *) d)->value);
+}
+
+static void data_delete(void *d)
+{
+    free(d);
+}
+
+static void data_copy(void *src, void *dst)
+{
+    memcpy(dst, src, sizeof(struct _tree_data));
+}
+
+#define MAX_ELEMENT 5000
+#define MAX_KEY     10000
+
+// value of key in tree, -1 if key is not in tree.
+static int model[MAX_KEY];
+
+static char *check_tree(tree *t)
+{
+    struct _tree_data tmp;
+    unsigned int count = 0;
+    int key;
+
+    verif_tree(t);
+    for (key = 0; key < MAX_KEY; key++) {
+        tmp.key = key;
+        tmp.value = -1;
+        calls = 0;
+        if (is_present(t, &tmp) != (model[key] >= 0)) {
+            ELOG("Wrong lookup of %d", key);
+            return "Wrong lookup with predicate";
+        }
+        // one call per level, and a last one.
+        if (calls > t->root->height + 1) {
+            ELOG("%lu calls to look for %d", calls, key);
+            return "Too many calls to predicate";
+        }
+        if (   get_data(t, &tmp, sizeof(tmp)) != (model[key] >= 0)
+            || tmp.value != model[key]) {
+            ELOG("Wrong data of %d", key);
+            return "Wrong data with predicate";
+        }
+        count += model[key] >= 0;
+    }
+    if (t->count != count) {
+        ELOG("Wrong number of elements");
+        return "Wrong number of elements with predicate";
+    }
+
+    return NULL;
+}
+
+static char *fill(tree *t)
+{
+    struct _tree_data tmp;
+    unsigned int height;
+    int i;
+
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp.key = rand() % MAX_KEY;
+        tmp.value = i;
+        height = t->root != NULL ? t->root->height : 0;
+        calls = 0;
+        insert_elmt(t, &tmp, sizeof(tmp));
+        // maximum, path and equality.
+        if (calls > height + 2) {
+            ELOG("%lu calls to insert %d", calls, tmp.key);
+            return "Too many calls to insert";
+        }
+        if (model[tmp.key] < 0)
+            model[tmp.key] = i;
+    }
+
+    return NULL;
+}
+
+char *less_tests()
+{
+    struct _tree_data tmp;
+    char *message;
+    unsigned int height;
+    unsigned int count;
+    tree *frozen;
+    tree *t;
+    int key;
+    int i;
+
+    unsigned long rand_seed = (unsigned long) time(NULL);
+    ILOG("Random seed: %lu", rand_seed);
+    srand(rand_seed);
+
+    for (key = 0; key < MAX_KEY; key++)
+        model[key] = -1;
+
+    t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    if (!set_less_than(t, data_less)) {
+        ELOG("Predicate refused");
+        return "Predicate refused";
+    }
+    if ((message = fill(t)) != NULL || (message = check_tree(t)) != NULL)
+        return message;
+    if (set_less_than(t, data_less)) {
+        ELOG("Predicate set on a filled tree");
+        return "Predicate set on a filled tree";
+    }
+
+    // Removals
+    for (i = 0; i < MAX_ELEMENT && t->root != NULL; i++) {
+        tmp.key = rand() % MAX_KEY;
+        height = t->root->height;
+        calls = 0;
+        delete_node(t, &tmp);
+        // one call per level, and a last one.
+        if (calls > height + 1) {
+            ELOG("%lu calls to delete %d", calls, tmp.key);
+            return "Too many calls to delete";
+        }
+        model[tmp.key] = -1;
+    }
+    if ((message = check_tree(t)) != NULL)
+        return message;
+    delete_tree(t);
+
+    // Insertions into a persistent tree compare path once too, and tree
+    // needs no data_cmp.
+    for (key = 0; key < MAX_KEY; key++)
+        model[key] = -1;
+    t = init_dictionnary(NULL, data_print, data_delete, data_copy);
+    set_less_than(t, data_less);
+    set_persistent(t, sizeof(struct _tree_data));
+    if ((message = fill(t)) != NULL)
+        return message;
+    frozen = snapshot(t);
+    count = frozen->count;
+    if ((message = fill(t)) != NULL || (message = check_tree(t)) != NULL)
+        return message;
+    verif_tree(frozen);
+    if (frozen->count != count) {
+        ELOG("Snapshot changed by insertions");
+        return "Snapshot changed by insertions with predicate";
+    }
+    delete_tree(frozen);
+    delete_tree(t);
+
+    // Marked elements are found and revived with predicate.
+    for (key = 0; key < MAX_KEY; key++)
+        model[key] = -1;
+    t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_less_than(t, data_less);
+    set_tombstones(t, 0);
+    if ((message = fill(t)) != NULL)
+        return message;
+    for (key = 0; key < MAX_KEY; key += 2) {
+        tmp.key = key;
+        delete_node(t, &tmp);
+        model[key] = -1;
+    }
+    if ((message = fill(t)) != NULL)
+        return message;
+    compact(t);
+    if ((message = check_tree(t)) != NULL)
+        return message;
+    delete_tree(t);
+
+    // Equal elements are all kept.
+    t = init_dictionnary(data_cmp, data_print, data_delete, data_copy);
+    set_less_than(t, data_less);
+    set_multimap(t);
+    for (i = 0; i < MAX_ELEMENT; i++) {
+        tmp.key = i % 10;
+        tmp.value = i;
+        insert_elmt(t, &tmp, sizeof(tmp));
+    }
+    verif_tree(t);
+    for (key = 0; key < 10; key++) {
+        tmp.key = key;
+        if (count_equal(t, &tmp) != MAX_ELEMENT / 10) {
+            ELOG("Wrong number of %d", key);
+            return "Wrong number of equal elements with predicate";
+        }
+    }
+    for (i = 0; i < MAX_ELEMENT / 2; i++) {
+        tmp.key = i % 10;
+        delete_node(t, &tmp);
+    }
+    verif_tree(t);
+    for (key = 0; key < 10; key++) {
+        tmp.key = key;
+        if (count_equal(t, &tmp) != MAX_ELEMENT / 20) {
+            ELOG("Wrong number of %d after deletions", key);
+            return "Wrong number of equal elements deleted with predicate";
+        }
+    }
+    delete_tree(t);
+
+    return NULL;
+}
@@ -38,6 +38,31 @@ extern char *print_tests();
 extern char *explore_tests();
 extern char *explore_restrain_tests();
 extern char *same_element_values_tests();
+extern char *aggregate_tests();
+extern char *lazy_update_tests();
+extern char *build_tests();
+extern char *set_operation_tests();
+extern char *insert_batch_tests();
+extern char *lookup_batch_tests();
+extern char *lookup_sorted_batch_tests();
+extern char *delete_range_tests();
+extern char *priority_queue_tests();
+extern char *insert_hint_tests();
+extern char *scan_range_tests();
+extern char *range_compare_tests();
+extern char *collect_range_tests();
+extern char *tombstone_tests();
+extern char *multimap_tests();
+extern char *persistent_tests();
+extern char *clone_tests();
+extern char *wavl_tests();
+extern char *relaxed_tests();
+extern char *key_tests();
+extern char *composite_tests();
+extern char *generated_tests();
+extern char *map_tests();
+extern char *cstring_tests();
+extern char *less_tests();
 
 static char *all_tests() {
     mu_run_test(alloc_tests);
@@ -51,6 +76,31 @@ static char *all_tests() {
     mu_run_test(explore_tests);
     mu_run_test(explore_restrain_tests);
     mu_run_test(same_element_values_tests);
+    mu_run_test(aggregate_tests);
+    mu_run_test(lazy_update_tests);
+    mu_run_test(build_tests);
+    mu_run_test(set_operation_tests);
+    mu_run_test(insert_batch_tests);
+    mu_run_test(lookup_batch_tests);
+    mu_run_test(lookup_sorted_batch_tests);
+    mu_run_test(delete_range_tests);
+    mu_run_test(priority_queue_tests);
+    mu_run_test(insert_hint_tests);
+    mu_run_test(scan_range_tests);
+    mu_run_test(range_compare_tests);
+    mu_run_test(collect_range_tests);
+    mu_run_test(tombstone_tests);
+    mu_run_test(multimap_tests);
+    mu_run_test(persistent_tests);
+    mu_run_test(clone_tests);
+    mu_run_test(wavl_tests);
+    mu_run_test(relaxed_tests);
+    mu_run_test(key_tests);
+    mu_run_test(composite_tests);
+    mu_run_test(generated_tests);
+    mu_run_test(map_tests);
+    mu_run_test(cstring_tests);
+    mu_run_test(less_tests);
 
     return NULL;
 }